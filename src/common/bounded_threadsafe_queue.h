@@ -0,0 +1,210 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace Common {
+
+/// Bounded single reader, single writer queue of pre-allocated slots.
+/// Each side caches the index of the other one, so it's only reloaded once per batch of pushes or
+/// pops. Batches of elements are published with a single store of the index.
+/// The reader spins for a while when the queue is empty, then parks until the next push. The spin
+/// grows when elements arrive while spinning and shrinks when the reader ends up parking anyway.
+/// @tparam T         Element type, it must be default constructible and move assignable
+/// @tparam capacity  Number of slots in the queue
+template <typename T, std::size_t capacity = 0x400>
+class BoundedSPSCQueue {
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::atomic_size_t::is_always_lock_free);
+
+public:
+    /// Pushes an element, waits for the reader when the queue is full
+    template <typename Arg>
+    void Push(Arg&& t) {
+        const std::size_t write = write_index.load(std::memory_order_relaxed);
+        WaitForFreeSlot(write);
+        slots[write % capacity] = std::forward<Arg>(t);
+        write_index.store(write + 1, std::memory_order_release);
+        NotifyReader();
+    }
+
+    /// Moves a range of elements into the queue, publishing as many as fit at once
+    template <typename It>
+    void PushBatch(It first, It last) {
+        std::size_t write = write_index.load(std::memory_order_relaxed);
+        while (first != last) {
+            WaitForFreeSlot(write);
+            const std::size_t end = cached_read_index + capacity;
+            for (; write != end && first != last; ++write, ++first) {
+                slots[write % capacity] = std::move(*first);
+            }
+            write_index.store(write, std::memory_order_release);
+            NotifyReader();
+        }
+    }
+
+    /// Pops an element, returns false when the queue is empty
+    bool TryPop(T& t) {
+        const std::size_t read = read_index.load(std::memory_order_relaxed);
+        if (read == cached_write_index) {
+            cached_write_index = write_index.load(std::memory_order_acquire);
+            if (read == cached_write_index) {
+                return false;
+            }
+        }
+        t = std::move(slots[read % capacity]);
+        read_index.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Pops up to max_count elements into out, returns the number of popped elements
+    template <typename OutputIt>
+    std::size_t TryPopBatch(OutputIt out, std::size_t max_count) {
+        const std::size_t read = read_index.load(std::memory_order_relaxed);
+        if (cached_write_index - read < max_count) {
+            cached_write_index = write_index.load(std::memory_order_acquire);
+        }
+        const std::size_t count = std::min(cached_write_index - read, max_count);
+        for (std::size_t i = 0; i < count; ++i) {
+            *out++ = std::move(slots[(read + i) % capacity]);
+        }
+        if (count != 0) {
+            read_index.store(read + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /// Pops an element, waits for the writer when the queue is empty
+    T PopWait() {
+        T t;
+        for (std::size_t spin = 0; spin < spin_count; ++spin) {
+            if (TryPop(t)) {
+                if (spin != 0) {
+                    // The writer is active, it's worth spinning for longer
+                    spin_count = std::min(spin_count * 2, MAX_SPIN_COUNT);
+                }
+                return t;
+            }
+            std::this_thread::yield();
+        }
+        // Spinning didn't pay off this time, spin for less before parking the next time
+        spin_count = std::max(spin_count / 2, MIN_SPIN_COUNT);
+        while (!TryPop(t)) {
+            std::unique_lock lock{park_mutex};
+            is_reader_parked.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            park_cv.wait(lock, [this] { return !Empty(); });
+            is_reader_parked.store(false, std::memory_order_relaxed);
+        }
+        return t;
+    }
+
+    /// Returns true when there are no elements to pop
+    [[nodiscard]] bool Empty() const {
+        return read_index.load(std::memory_order_acquire) ==
+               write_index.load(std::memory_order_acquire);
+    }
+
+    /// Returns the number of elements in the queue
+    [[nodiscard]] std::size_t Size() const {
+        return write_index.load(std::memory_order_acquire) -
+               read_index.load(std::memory_order_acquire);
+    }
+
+private:
+    /// Bounds of the number of times the reader checks for new elements before parking
+    static constexpr std::size_t MIN_SPIN_COUNT = 0x10;
+    static constexpr std::size_t MAX_SPIN_COUNT = 0x1000;
+
+    /// Waits until the slot at the write index is free
+    void WaitForFreeSlot(std::size_t write) {
+        if (write - cached_read_index != capacity) {
+            return;
+        }
+        cached_read_index = read_index.load(std::memory_order_acquire);
+        while (write - cached_read_index == capacity) {
+            std::this_thread::yield();
+            cached_read_index = read_index.load(std::memory_order_acquire);
+        }
+    }
+
+    /// Wakes up the reader if it's parked waiting for elements
+    void NotifyReader() {
+        // Pairs with the fence in PopWait, either the reader sees the new elements or we see it
+        // parked and wake it up
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (is_reader_parked.load(std::memory_order_relaxed)) {
+            std::scoped_lock lock{park_mutex};
+            park_cv.notify_one();
+        }
+    }
+
+    // Indices are kept on separate cache lines from each other and from the data each side
+    // modifies, to avoid false sharing between the reader and the writer
+    alignas(128) std::atomic_size_t write_index{0};
+    std::size_t cached_read_index{0};
+
+    alignas(128) std::atomic_size_t read_index{0};
+    std::size_t cached_write_index{0};
+    std::size_t spin_count{0x100};
+
+    alignas(128) std::atomic_bool is_reader_parked{false};
+    std::mutex park_mutex;
+    std::condition_variable park_cv;
+
+    alignas(128) std::array<T, capacity> slots{};
+};
+
+/// Bounded single reader, multiple writer queue of pre-allocated slots.
+template <typename T, std::size_t capacity = 0x400>
+class BoundedMPSCQueue {
+public:
+    template <typename Arg>
+    void Push(Arg&& t) {
+        std::scoped_lock lock{write_mutex};
+        spsc_queue.Push(std::forward<Arg>(t));
+    }
+
+    template <typename It>
+    void PushBatch(It first, It last) {
+        std::scoped_lock lock{write_mutex};
+        spsc_queue.PushBatch(first, last);
+    }
+
+    bool TryPop(T& t) {
+        return spsc_queue.TryPop(t);
+    }
+
+    template <typename OutputIt>
+    std::size_t TryPopBatch(OutputIt out, std::size_t max_count) {
+        return spsc_queue.TryPopBatch(out, max_count);
+    }
+
+    T PopWait() {
+        return spsc_queue.PopWait();
+    }
+
+    [[nodiscard]] bool Empty() const {
+        return spsc_queue.Empty();
+    }
+
+    [[nodiscard]] std::size_t Size() const {
+        return spsc_queue.Size();
+    }
+
+private:
+    BoundedSPSCQueue<T, capacity> spsc_queue;
+    std::mutex write_mutex;
+};
+
+} // namespace Common
@@ -0,0 +1,181 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "common/assert.h"
+#include "common/host_memory.h"
+#include "common/logging/log.h"
+
+namespace Common {
+
+#ifdef __linux__
+
+class HostMemory::Impl {
+public:
+    explicit Impl(std::size_t backing_size_, std::size_t virtual_size_)
+        : backing_size{backing_size_}, virtual_size{virtual_size_} {
+        fd = memfd_create("HostMemory", 0);
+        if (fd == -1) {
+            LOG_ERROR(HW_Memory, "memfd_create failed: {}", std::strerror(errno));
+            return;
+        }
+        // Defined to extend the file with zeros
+        if (ftruncate(fd, static_cast<off_t>(backing_size)) != 0) {
+            LOG_ERROR(HW_Memory, "ftruncate failed with {}, are you out-of-memory?",
+                      std::strerror(errno));
+            Release();
+            return;
+        }
+        void* const backing =
+            mmap(nullptr, backing_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (backing == MAP_FAILED) {
+            LOG_ERROR(HW_Memory, "mmap of the backing memory failed: {}", std::strerror(errno));
+            Release();
+            return;
+        }
+        backing_base = static_cast<u8*>(backing);
+
+        // Reserve the whole guest address space, pages are only committed when mapped
+        void* const reserved = mmap(nullptr, virtual_size, PROT_NONE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (reserved == MAP_FAILED) {
+            LOG_ERROR(HW_Memory, "mmap of the virtual region failed: {}", std::strerror(errno));
+            Release();
+            return;
+        }
+        virtual_base = static_cast<u8*>(reserved);
+    }
+
+    ~Impl() {
+        Release();
+    }
+
+    void Map(std::size_t virtual_offset, std::size_t host_offset, std::size_t length) {
+        void* const ret = mmap(virtual_base + virtual_offset, length, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_FIXED, fd, static_cast<off_t>(host_offset));
+        ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", std::strerror(errno));
+    }
+
+    void Unmap(std::size_t virtual_offset, std::size_t length) {
+        // Replacing the range with a fresh reservation drops the alias and keeps the address
+        // space to ourselves, munmap would let other allocations land in the hole
+        void* const ret = mmap(virtual_base + virtual_offset, length, PROT_NONE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+        ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", std::strerror(errno));
+    }
+
+    void Protect(std::size_t virtual_offset, std::size_t length, bool read, bool write) {
+        int flags = PROT_NONE;
+        if (read) {
+            flags |= PROT_READ;
+        }
+        if (write) {
+            flags |= PROT_WRITE;
+        }
+        const int ret = mprotect(virtual_base + virtual_offset, length, flags);
+        ASSERT_MSG(ret == 0, "mprotect failed: {}", std::strerror(errno));
+    }
+
+    [[nodiscard]] bool IsValid() const noexcept {
+        return virtual_base != nullptr;
+    }
+
+    u8* backing_base{};
+    u8* virtual_base{};
+
+private:
+    void Release() {
+        if (virtual_base) {
+            munmap(virtual_base, virtual_size);
+            virtual_base = nullptr;
+        }
+        if (backing_base) {
+            munmap(backing_base, backing_size);
+            backing_base = nullptr;
+        }
+        if (fd != -1) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    std::size_t backing_size{};
+    std::size_t virtual_size{};
+    int fd{-1};
+};
+
+#else
+
+class HostMemory::Impl {
+public:
+    explicit Impl(std::size_t, std::size_t) {}
+
+    void Map(std::size_t, std::size_t, std::size_t) {}
+    void Unmap(std::size_t, std::size_t) {}
+    void Protect(std::size_t, std::size_t, bool, bool) {}
+
+    [[nodiscard]] bool IsValid() const noexcept {
+        return false;
+    }
+
+    u8* backing_base{};
+    u8* virtual_base{};
+};
+
+#endif
+
+HostMemory::HostMemory(std::size_t backing_size_, std::size_t virtual_size_)
+    : backing_size{backing_size_}, virtual_size{virtual_size_},
+      impl{std::make_unique<Impl>(backing_size, virtual_size)} {
+    if (impl->IsValid()) {
+        backing_base = impl->backing_base;
+        virtual_base = impl->virtual_base;
+        return;
+    }
+    LOG_WARNING(HW_Memory, "Host memory aliasing is not available, fastmem is disabled");
+    impl.reset();
+    fallback_buffer = std::make_unique<Common::VirtualBuffer<u8>>(backing_size);
+    backing_base = fallback_buffer->data();
+}
+
+HostMemory::~HostMemory() = default;
+
+HostMemory::HostMemory(HostMemory&&) noexcept = default;
+
+HostMemory& HostMemory::operator=(HostMemory&&) noexcept = default;
+
+void HostMemory::Map(std::size_t virtual_offset, std::size_t host_offset, std::size_t length) {
+    ASSERT(virtual_offset + length <= virtual_size);
+    ASSERT(host_offset + length <= backing_size);
+    if (length == 0 || !virtual_base) {
+        return;
+    }
+    impl->Map(virtual_offset, host_offset, length);
+}
+
+void HostMemory::Unmap(std::size_t virtual_offset, std::size_t length) {
+    ASSERT(virtual_offset + length <= virtual_size);
+    if (length == 0 || !virtual_base) {
+        return;
+    }
+    impl->Unmap(virtual_offset, length);
+}
+
+void HostMemory::Protect(std::size_t virtual_offset, std::size_t length, bool read, bool write) {
+    ASSERT(virtual_offset + length <= virtual_size);
+    if (length == 0 || !virtual_base) {
+        return;
+    }
+    impl->Protect(virtual_offset, length, read, write);
+}
+
+} // namespace Common
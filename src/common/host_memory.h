@@ -0,0 +1,71 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "common/common_types.h"
+#include "common/virtual_buffer.h"
+
+namespace Common {
+
+/**
+ * A low level linear memory buffer that can be mapped multiple times into a reserved virtual
+ * region. It's used to rebuild the guest's sparse address space, including mirrors, on top of
+ * the host MMU. Platforms without support only provide the backing buffer.
+ */
+class HostMemory {
+public:
+    explicit HostMemory(std::size_t backing_size_, std::size_t virtual_size_);
+    ~HostMemory();
+
+    HostMemory(const HostMemory&) = delete;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    HostMemory(HostMemory&& other) noexcept;
+    HostMemory& operator=(HostMemory&& other) noexcept;
+
+    /// Maps length bytes of the backing buffer at host_offset into the virtual region
+    void Map(std::size_t virtual_offset, std::size_t host_offset, std::size_t length);
+
+    /// Removes a range of the virtual region, accesses to it will fault
+    void Unmap(std::size_t virtual_offset, std::size_t length);
+
+    /// Changes the access permissions of a mapped range of the virtual region
+    void Protect(std::size_t virtual_offset, std::size_t length, bool read, bool write);
+
+    [[nodiscard]] u8* BackingBasePointer() noexcept {
+        return backing_base;
+    }
+
+    [[nodiscard]] const u8* BackingBasePointer() const noexcept {
+        return backing_base;
+    }
+
+    /// Returns the base of the virtual region, nullptr when the host can't provide one
+    [[nodiscard]] u8* VirtualBasePointer() noexcept {
+        return virtual_base;
+    }
+
+    [[nodiscard]] const u8* VirtualBasePointer() const noexcept {
+        return virtual_base;
+    }
+
+private:
+    class Impl;
+
+    std::size_t backing_size{};
+    std::size_t virtual_size{};
+
+    std::unique_ptr<Impl> impl;
+    u8* backing_base{};
+    u8* virtual_base{};
+
+    // Used when the host doesn't support aliased mappings
+    std::unique_ptr<Common::VirtualBuffer<u8>> fallback_buffer;
+};
+
+} // namespace Common
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "common/page_table.h"
 
 namespace Common {
@@ -16,4 +18,13 @@ void PageTable::Resize(size_t address_space_width_in_bits, size_t page_size_in_b
     backing_addr.resize(num_page_table_entries);
 }
 
+void PageTable::FillRange(size_t first, size_t count, u8* pointer, PageType type, u64 backing) {
+    const uintptr_t raw = PageInfo::Pack(pointer, type);
+    PageInfo* const page_info = pointers.data() + first;
+    for (size_t i = 0; i < count; ++i) {
+        page_info[i].StoreRaw(raw);
+    }
+    std::fill_n(backing_addr.data() + first, count, backing);
+}
+
 } // namespace Common
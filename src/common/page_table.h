@@ -63,7 +63,20 @@ struct PageTable {
 
         /// Write a page pointer and type pair atomically
         void Store(u8* pointer, PageType type) noexcept {
-            raw.store(reinterpret_cast<uintptr_t>(pointer) | static_cast<uintptr_t>(type));
+            StoreRaw(Pack(pointer, type));
+        }
+
+        /// Write a raw page information value atomically, see Pack
+        void StoreRaw(uintptr_t value) noexcept {
+            // Readers only need the pair to be consistent, table updates are ordered by the
+            // kernel locks of whoever changes the mapping. A release store is a plain move on
+            // x86 and keeps large table fills cheap.
+            raw.store(value, std::memory_order_release);
+        }
+
+        /// Pack a page pointer and type pair into its raw representation
+        [[nodiscard]] static uintptr_t Pack(u8* pointer, PageType type) noexcept {
+            return reinterpret_cast<uintptr_t>(pointer) | static_cast<uintptr_t>(type);
         }
 
         /// Unpack a pointer from a page info raw representation
@@ -98,6 +111,20 @@ struct PageTable {
      */
     void Resize(size_t address_space_width_in_bits, size_t page_size_in_bits);
 
+    /**
+     * Writes the same page information and backing address to a range of entries.
+     *
+     * Linear mappings store a pointer and backing address biased by the virtual address of the
+     * page, so every entry of a contiguous mapping holds the same value.
+     *
+     * @param first        Index of the first page to write.
+     * @param count        Number of pages to write.
+     * @param pointer      Biased host pointer of the pages, nullptr when they are not memory.
+     * @param type         The page type to store.
+     * @param backing      Biased backing address of the pages.
+     */
+    void FillRange(size_t first, size_t count, u8* pointer, PageType type, u64 backing);
+
     /**
      * Vector of memory pointers backing each page. An entry can only be non-null if the
      * corresponding attribute element is of type `Memory`.
@@ -105,6 +132,9 @@ struct PageTable {
     VirtualBuffer<PageInfo> pointers;
 
     VirtualBuffer<u64> backing_addr;
+
+    /// Host region mirroring the address space, nullptr when fastmem is not in use.
+    u8* fastmem_arena{};
 };
 
 } // namespace Common
@@ -47,6 +47,15 @@ public:
         return true;
     }
 
+    /// Clears the event and returns true when it's set, returns false without waiting otherwise
+    bool TryWait() {
+        if (!is_set.load()) {
+            return false;
+        }
+        std::unique_lock lk{mutex};
+        return is_set.exchange(false);
+    }
+
     void Reset() {
         std::unique_lock lk{mutex};
         // no other action required, since wait loops on the predicate and any lingering signal will
@@ -19,6 +19,7 @@
 #include "core/file_sys/card_image.h"
 #include "core/file_sys/mode.h"
 #include "core/file_sys/patch_manager.h"
+#include "core/file_sys/program_metadata.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/romfs_factory.h"
 #include "core/file_sys/savedata_factory.h"
@@ -29,6 +30,7 @@
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/k_scheduler.h"
 #include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/memory/memory_types.h"
 #include "core/hle/kernel/physical_core.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/thread.h"
@@ -277,6 +279,35 @@ struct System::Impl {
         return status;
     }
 
+    ResultStatus LoadEmptyProcess(System& system, Frontend::EmuWindow& emu_window) {
+        ResultStatus init_result{Init(system, emu_window)};
+        if (init_result != ResultStatus::Success) {
+            LOG_CRITICAL(Core, "Failed to initialize system (Error {})!",
+                         static_cast<int>(init_result));
+            Shutdown();
+            return init_result;
+        }
+
+        // The process has no code, a single page is reserved for its code region
+        auto main_process =
+            Kernel::Process::Create(system, "main", Kernel::Process::ProcessType::Userland);
+        if (main_process->LoadFromMetadata(FileSys::ProgramMetadata::GetDefault(),
+                                           Kernel::Memory::PageSize)
+                .IsError()) {
+            LOG_CRITICAL(Core, "Failed to create an empty process!");
+            Shutdown();
+            return ResultStatus::ErrorUnknown;
+        }
+        kernel.MakeCurrentProcess(main_process.get());
+        kernel.InitializeCores();
+
+        // No guest thread is scheduled to bind the page table, bind it for host accesses
+        system.Memory().SetCurrentPageTable(*main_process, 0);
+
+        status = ResultStatus::Success;
+        return status;
+    }
+
     void Shutdown() {
         // Log last frame performance stats if game was loded
         if (perf_stats) {
@@ -464,6 +495,10 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
     return impl->Load(*this, emu_window, filepath, program_index);
 }
 
+System::ResultStatus System::LoadEmptyProcess(Frontend::EmuWindow& emu_window) {
+    return impl->LoadEmptyProcess(*this, emu_window);
+}
+
 bool System::IsPoweredOn() const {
     return impl->is_powered_on;
 }
@@ -178,6 +178,15 @@ public:
     [[nodiscard]] ResultStatus Load(Frontend::EmuWindow& emu_window, const std::string& filepath,
                                     std::size_t program_index = 0);
 
+    /**
+     * Initializes the system with an empty process instead of an application. The process never
+     * runs, it only provides an address space, e.g. to replay GPU command captures.
+     * @param emu_window Reference to the host-system window used for video output and keyboard
+     *                   input.
+     * @returns ResultStatus code, indicating if the operation succeeded.
+     */
+    [[nodiscard]] ResultStatus LoadEmptyProcess(Frontend::EmuWindow& emu_window);
+
     /**
      * Indicates if the emulated system is powered on (all subsystems initialized and able to run an
      * application).
@@ -3,10 +3,22 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <bit>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
 
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#include <fmt/format.h>
+
+#include "common/assert.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "core/core_timing.h"
 #include "core/core_timing_util.h"
@@ -16,6 +28,21 @@ namespace Core::Timing {
 
 constexpr s64 MAX_SLICE_LENGTH = 4000;
 
+/// Bounds of the time the timer thread spins before an event, in nanoseconds.
+constexpr s64 MIN_SPIN_TIME = 20'000;
+constexpr s64 MAX_SPIN_TIME = 2'000'000;
+constexpr s64 INITIAL_SPIN_TIME = 200'000;
+
+/// Each tick of the timing wheel spans 2^10 nanoseconds, about a microsecond.
+constexpr u64 WHEEL_TICK_BITS = 10;
+/// Slots per level of the timing wheel, the occupied slots of a level fit in a u64.
+constexpr u64 WHEEL_SLOT_BITS = 6;
+constexpr u64 WHEEL_NUM_SLOTS = u64{1} << WHEEL_SLOT_BITS;
+constexpr u64 WHEEL_SLOT_MASK = WHEEL_NUM_SLOTS - 1;
+/// Six levels cover 2^36 ticks (about 19 hours), events further away wait in an overflow list.
+constexpr std::size_t WHEEL_NUM_LEVELS = 6;
+constexpr std::size_t WHEEL_OVERFLOW_LEVEL = WHEEL_NUM_LEVELS;
+
 std::shared_ptr<EventType> CreateEvent(std::string name, TimedCallback&& callback) {
     return std::make_shared<EventType>(std::move(callback), std::move(name));
 }
@@ -25,6 +52,22 @@ struct CoreTiming::Event {
     u64 fifo_order;
     std::uintptr_t user_data;
     std::weak_ptr<EventType> type;
+    /// Type the event was scheduled with, used to find the event when it's unscheduled
+    const EventType* type_key;
+
+    /// Links of the inbox or the wheel slot holding the event
+    Event* prev{};
+    Event* next{};
+    /// Links of the events scheduled with the same type and user data
+    Event* key_prev{};
+    Event* key_next{};
+
+    u8 level{};
+    u8 slot{};
+    /// Set when the event has been taken out of the wheel to be fired
+    bool is_due{};
+    /// Set when a due event is unscheduled before its callback runs
+    std::atomic<bool> is_cancelled{};
 
     // Sort by time, unless the times are the same, in which case sort by
     // the order added to the queue
@@ -37,8 +80,283 @@ struct CoreTiming::Event {
     }
 };
 
+/**
+ * Hierarchical timing wheel holding the pending events. Level N has 64 slots of 64^N ticks each,
+ * an event is placed in the lowest level that reaches its time and moved down a level ("cascaded")
+ * when the wheel gets to its slot. Events are also indexed by type and user data, so inserting,
+ * unscheduling and finding the due events don't depend on the number of pending events.
+ */
+class CoreTiming::EventQueue {
+public:
+    EventQueue() = default;
+
+    ~EventQueue() {
+        Clear();
+    }
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    [[nodiscard]] bool Empty() const noexcept {
+        return num_events == 0;
+    }
+
+    /// Adds an event to the wheel and the index
+    void Insert(Event* event) {
+        InsertInWheel(event);
+
+        Event*& head = index[Key{event->type_key, event->user_data}];
+        event->key_prev = nullptr;
+        event->key_next = head;
+        if (head) {
+            head->key_prev = event;
+        }
+        head = event;
+        ++num_events;
+    }
+
+    /// Removes an event from the index, and from the wheel when it isn't due yet
+    void Remove(Event* event) {
+        if (!event->is_due) {
+            RemoveFromWheel(event);
+        }
+        if (event->key_prev) {
+            event->key_prev->key_next = event->key_next;
+        } else {
+            const auto it = index.find(Key{event->type_key, event->user_data});
+            if (event->key_next) {
+                it->second = event->key_next;
+            } else {
+                index.erase(it);
+            }
+        }
+        if (event->key_next) {
+            event->key_next->key_prev = event->key_prev;
+        }
+        --num_events;
+    }
+
+    /// Returns the first event scheduled with a type and user data, nullptr when there's none
+    [[nodiscard]] Event* Find(const EventType* type, std::uintptr_t user_data) const {
+        const auto it = index.find(Key{type, user_data});
+        return it != index.end() ? it->second : nullptr;
+    }
+
+    /// Calls func for every event in the queue, func may remove the event it's given
+    template <typename Func>
+    void ForEach(Func&& func) {
+        for (auto it = index.begin(); it != index.end();) {
+            // Advance first, removing the last event of a key erases its node
+            Event* event = (it++)->second;
+            while (event) {
+                Event* const next = event->key_next;
+                func(event);
+                event = next;
+            }
+        }
+    }
+
+    /// Moves the events due at or before time out of the wheel, in no particular order
+    void CollectDue(u64 time, std::vector<Event*>& due) {
+        const u64 target_tick = time >> WHEEL_TICK_BITS;
+        while (current_tick < target_tick) {
+            // Every event in the current tick is due
+            TakeSlot(0, current_tick & WHEEL_SLOT_MASK, due);
+            current_tick = std::min(NextTick(), target_tick);
+            if ((current_tick & WHEEL_SLOT_MASK) == 0) {
+                Cascade();
+            }
+        }
+        // Events in the same tick as time might not be due yet
+        const u64 slot = current_tick & WHEEL_SLOT_MASK;
+        for (Event* event = slots[0][slot]; event;) {
+            Event* const next = event->next;
+            if (event->time <= time) {
+                RemoveFromWheel(event);
+                event->is_due = true;
+                due.push_back(event);
+            }
+            event = next;
+        }
+    }
+
+    /// Returns the time of the earliest event in the wheel
+    [[nodiscard]] std::optional<u64> NextEventTime() const {
+        std::optional<u64> result;
+        const auto visit_list = [&result](const Event* event) {
+            for (; event; event = event->next) {
+                result = std::min(result.value_or(event->time), event->time);
+            }
+        };
+        for (std::size_t level = 0; level < WHEEL_NUM_LEVELS; ++level) {
+            if (occupied[level] == 0) {
+                continue;
+            }
+            // Slots closer to the current one in a level hold earlier events. The current slot of
+            // the upper levels was already cascaded, it can only hold events of the next lap.
+            const u64 start = level == 0 ? 0 : 1;
+            const u64 index = LevelIndex(current_tick, level);
+            const u64 offset = NextOccupied(level, index, start);
+            visit_list(slots[level][(index + offset) & WHEEL_SLOT_MASK]);
+        }
+        visit_list(overflow);
+        return result;
+    }
+
+    /// Deletes every event in the queue
+    void Clear() {
+        ForEach([this](Event* event) {
+            Remove(event);
+            delete event;
+        });
+    }
+
+private:
+    struct Key {
+        const EventType* type;
+        std::uintptr_t user_data;
+
+        friend bool operator==(const Key&, const Key&) = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept {
+            return std::hash<const EventType*>{}(key.type) ^
+                   std::hash<std::uintptr_t>{}(key.user_data) * 0x9E3779B97F4A7C15ULL;
+        }
+    };
+
+    static u64 LevelIndex(u64 tick, std::size_t level) {
+        return (tick >> (WHEEL_SLOT_BITS * level)) & WHEEL_SLOT_MASK;
+    }
+
+    /// Returns the distance to the first occupied slot of a level, starting at index + start
+    u64 NextOccupied(std::size_t level, u64 index, u64 start) const {
+        const u64 rotated = std::rotr(occupied[level], static_cast<int>(index + start));
+        return start + static_cast<u64>(std::countr_zero(rotated));
+    }
+
+    /// Returns the next tick with events to fire or to cascade
+    u64 NextTick() const {
+        u64 tick = ~u64{0};
+        if (occupied[0] != 0) {
+            tick = current_tick + NextOccupied(0, current_tick & WHEEL_SLOT_MASK, 1);
+        }
+        for (std::size_t level = 1; level < WHEEL_NUM_LEVELS; ++level) {
+            if (occupied[level] == 0) {
+                continue;
+            }
+            const std::size_t shift = WHEEL_SLOT_BITS * level;
+            const u64 offset = NextOccupied(level, LevelIndex(current_tick, level), 1);
+            tick = std::min(tick, ((current_tick >> shift) + offset) << shift);
+        }
+        if (overflow) {
+            const std::size_t shift = WHEEL_SLOT_BITS * WHEEL_NUM_LEVELS;
+            tick = std::min(tick, ((current_tick >> shift) + 1) << shift);
+        }
+        return tick;
+    }
+
+    void InsertInWheel(Event* event) {
+        const u64 tick = std::max(event->time >> WHEEL_TICK_BITS, current_tick);
+        const u64 delta = tick - current_tick;
+        const std::size_t level =
+            delta == 0 ? 0 : static_cast<std::size_t>(std::bit_width(delta) - 1) / WHEEL_SLOT_BITS;
+        Event** head;
+        if (level < WHEEL_NUM_LEVELS) {
+            const u64 slot = LevelIndex(tick, level);
+            event->level = static_cast<u8>(level);
+            event->slot = static_cast<u8>(slot);
+            head = &slots[level][slot];
+            occupied[level] |= u64{1} << slot;
+        } else {
+            event->level = static_cast<u8>(WHEEL_OVERFLOW_LEVEL);
+            event->slot = 0;
+            head = &overflow;
+        }
+        event->is_due = false;
+        event->prev = nullptr;
+        event->next = *head;
+        if (*head) {
+            (*head)->prev = event;
+        }
+        *head = event;
+    }
+
+    void RemoveFromWheel(Event* event) {
+        if (event->prev) {
+            event->prev->next = event->next;
+        } else if (event->level == WHEEL_OVERFLOW_LEVEL) {
+            overflow = event->next;
+        } else {
+            slots[event->level][event->slot] = event->next;
+            if (!event->next) {
+                occupied[event->level] &= ~(u64{1} << event->slot);
+            }
+        }
+        if (event->next) {
+            event->next->prev = event->prev;
+        }
+    }
+
+    /// Empties a slot and returns its events as a list
+    Event* Detach(std::size_t level, u64 slot) {
+        Event* const list = slots[level][slot];
+        slots[level][slot] = nullptr;
+        occupied[level] &= ~(u64{1} << slot);
+        return list;
+    }
+
+    void TakeSlot(std::size_t level, u64 slot, std::vector<Event*>& due) {
+        for (Event* event = Detach(level, slot); event; event = event->next) {
+            event->is_due = true;
+            due.push_back(event);
+        }
+    }
+
+    /// Moves the events of the upper level slots the current tick has reached to lower levels
+    void Cascade() {
+        const auto reinsert = [this](Event* event) {
+            while (event) {
+                Event* const next = event->next;
+                InsertInWheel(event);
+                event = next;
+            }
+        };
+        for (std::size_t level = 1; level < WHEEL_NUM_LEVELS; ++level) {
+            const u64 slot = LevelIndex(current_tick, level);
+            reinsert(Detach(level, slot));
+            if (slot != 0) {
+                return;
+            }
+        }
+        // The top level wrapped around, events that were too far away may fit now
+        Event* const list = std::exchange(overflow, nullptr);
+        reinsert(list);
+    }
+
+    std::array<std::array<Event*, WHEEL_NUM_SLOTS>, WHEEL_NUM_LEVELS> slots{};
+    std::array<u64, WHEEL_NUM_LEVELS> occupied{};
+    Event* overflow{};
+    u64 current_tick{};
+
+    std::unordered_map<Key, Event*, KeyHash> index;
+    std::size_t num_events{};
+};
+
+namespace {
+/// Returns the inbox used by the calling thread, threads are spread over the inboxes as they
+/// schedule their first event
+std::size_t CurrentInboxIndex(std::size_t num_inboxes) {
+    static std::atomic<std::size_t> next_index{};
+    thread_local const std::size_t index = next_index++;
+    return index % num_inboxes;
+}
+} // Anonymous namespace
+
 CoreTiming::CoreTiming()
-    : clock{Common::CreateBestMatchingClock(Hardware::BASE_CLOCK_RATE, Hardware::CNTFREQ)} {}
+    : clock{Common::CreateBestMatchingClock(Hardware::BASE_CLOCK_RATE, Hardware::CNTFREQ)},
+      event_queue{std::make_unique<EventQueue>()} {}
 
 CoreTiming::~CoreTiming() = default;
 
@@ -47,6 +365,10 @@ void CoreTiming::ThreadEntry(CoreTiming& instance) {
     MicroProfileOnThreadCreate(name);
     Common::SetCurrentThreadName(name);
     Common::SetCurrentThreadPriority(Common::ThreadPriority::VeryHigh);
+#ifdef __linux__
+    // The default 50us of timer slack is added to every sleep of the thread
+    prctl(PR_SET_TIMERSLACK, 1);
+#endif
     instance.on_thread_init();
     instance.ThreadLoop();
     MicroProfileOnThreadExit();
@@ -55,6 +377,8 @@ void CoreTiming::ThreadEntry(CoreTiming& instance) {
 void CoreTiming::Initialize(std::function<void()>&& on_thread_init_) {
     on_thread_init = std::move(on_thread_init_);
     event_fifo_id = 0;
+    spin_time = INITIAL_SPIN_TIME;
+    average_oversleep = 0;
     shutting_down = false;
     ticks = 0;
     const auto empty_timed_callback = [](std::uintptr_t, std::chrono::nanoseconds) {};
@@ -75,6 +399,12 @@ void CoreTiming::Shutdown() {
     ClearPendingEvents();
     timer_thread.reset();
     has_started = false;
+
+    const auto histogram = GetWakeupLatenessHistogram();
+    if (std::ranges::any_of(histogram, [](u64 count) { return count != 0; })) {
+        LOG_INFO(Core_Timing, "Wakeup lateness histogram (log2 us buckets): {}",
+                 fmt::join(histogram, ", "));
+    }
 }
 
 void CoreTiming::Pause(bool is_paused) {
@@ -102,19 +432,27 @@ bool CoreTiming::IsRunning() const {
 }
 
 bool CoreTiming::HasPendingEvents() const {
-    return !(wait_set && event_queue.empty());
+    return !(wait_set && num_pending_events == 0);
 }
 
 void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
                                const std::shared_ptr<EventType>& event_type,
                                std::uintptr_t user_data) {
-    {
-        std::scoped_lock scope{basic_lock};
-        const u64 timeout = static_cast<u64>((GetGlobalTimeNs() + ns_into_future).count());
-
-        event_queue.emplace_back(Event{timeout, event_fifo_id++, user_data, event_type});
-
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+    const u64 timeout = static_cast<u64>((GetGlobalTimeNs() + ns_into_future).count());
+    const u64 fifo_order = event_fifo_id.fetch_add(1, std::memory_order_relaxed);
+    Event* const new_event = new Event{
+        .time = timeout,
+        .fifo_order = fifo_order,
+        .user_data = user_data,
+        .type = event_type,
+        .type_key = event_type.get(),
+    };
+    ++num_pending_events;
+
+    auto& inbox = inboxes[CurrentInboxIndex(NUM_INBOXES)];
+    new_event->next = inbox.load(std::memory_order_relaxed);
+    while (!inbox.compare_exchange_weak(new_event->next, new_event, std::memory_order_release,
+                                        std::memory_order_relaxed)) {
     }
     event.Set();
 }
@@ -122,14 +460,19 @@ void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
 void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
                                  std::uintptr_t user_data) {
     std::scoped_lock scope{basic_lock};
-    const auto itr = std::remove_if(event_queue.begin(), event_queue.end(), [&](const Event& e) {
-        return e.type.lock().get() == event_type.get() && e.user_data == user_data;
-    });
-
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+    DrainInboxes();
+
+    Event* next = event_queue->Find(event_type.get(), user_data);
+    while (next) {
+        Event* const evt = std::exchange(next, next->key_next);
+        event_queue->Remove(evt);
+        if (evt->is_due) {
+            // Advance is about to fire it, it's deleted once the callbacks have run
+            evt->is_cancelled.store(true, std::memory_order_relaxed);
+        } else {
+            delete evt;
+            --num_pending_events;
+        }
     }
 }
 
@@ -139,9 +482,14 @@ void CoreTiming::AddTicks(u64 ticks) {
 }
 
 void CoreTiming::Idle() {
-    if (!event_queue.empty()) {
-        const u64 next_event_time = event_queue.front().time;
-        const u64 next_ticks = nsToCycles(std::chrono::nanoseconds(next_event_time)) + 10U;
+    std::optional<u64> next_event_time;
+    {
+        std::scoped_lock scope{basic_lock};
+        DrainInboxes();
+        next_event_time = event_queue->NextEventTime();
+    }
+    if (next_event_time) {
+        const u64 next_ticks = nsToCycles(std::chrono::nanoseconds(*next_event_time)) + 10U;
         if (next_ticks > ticks) {
             ticks = next_ticks;
         }
@@ -168,45 +516,83 @@ u64 CoreTiming::GetClockTicks() const {
     return CpuCyclesToClockCycles(ticks);
 }
 
+void CoreTiming::DrainInboxes() {
+    for (auto& inbox : inboxes) {
+        Event* evt = inbox.exchange(nullptr, std::memory_order_acquire);
+        while (evt) {
+            Event* const next = evt->next;
+            event_queue->Insert(evt);
+            evt = next;
+        }
+    }
+}
+
 void CoreTiming::ClearPendingEvents() {
-    event_queue.clear();
+    std::scoped_lock lock{basic_lock};
+    DrainInboxes();
+    event_queue->Clear();
+    num_pending_events = 0;
 }
 
 void CoreTiming::RemoveEvent(const std::shared_ptr<EventType>& event_type) {
     std::scoped_lock lock{basic_lock};
+    DrainInboxes();
 
-    const auto itr = std::remove_if(event_queue.begin(), event_queue.end(), [&](const Event& e) {
-        return e.type.lock().get() == event_type.get();
+    event_queue->ForEach([&](Event* evt) {
+        if (evt->type_key != event_type.get()) {
+            return;
+        }
+        event_queue->Remove(evt);
+        if (evt->is_due) {
+            evt->is_cancelled.store(true, std::memory_order_relaxed);
+        } else {
+            delete evt;
+            --num_pending_events;
+        }
     });
-
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-    }
 }
 
 std::optional<s64> CoreTiming::Advance() {
     std::scoped_lock lock{advance_lock, basic_lock};
     global_timer = GetGlobalTimeNs().count();
 
-    while (!event_queue.empty() && event_queue.front().time <= global_timer) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
+    while (true) {
+        DrainInboxes();
+        event_queue->CollectDue(global_timer, due_events);
+        if (due_events.empty()) {
+            break;
+        }
+        std::ranges::sort(due_events,
+                          [](const Event* lhs, const Event* rhs) { return *lhs < *rhs; });
+
+        // Fire the whole batch without the lock, so the callbacks and other threads can schedule
+        // and unschedule events
         basic_lock.unlock();
+        for (const Event* evt : due_events) {
+            if (evt->is_cancelled.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            if (const auto event_type{evt->type.lock()}) {
+                const auto ns_late = static_cast<s64>(global_timer - evt->time);
+                event_type->callback(evt->user_data, std::chrono::nanoseconds{ns_late});
+            }
+        }
+        basic_lock.lock();
 
-        if (const auto event_type{evt.type.lock()}) {
-            event_type->callback(
-                evt.user_data, std::chrono::nanoseconds{static_cast<s64>(global_timer - evt.time)});
+        for (Event* evt : due_events) {
+            if (!evt->is_cancelled.load(std::memory_order_relaxed)) {
+                event_queue->Remove(evt);
+            }
+            delete evt;
         }
+        num_pending_events -= due_events.size();
+        due_events.clear();
 
-        basic_lock.lock();
         global_timer = GetGlobalTimeNs().count();
     }
 
-    if (!event_queue.empty()) {
-        const s64 next_time = event_queue.front().time - global_timer;
+    if (const auto next_event_time = event_queue->NextEventTime()) {
+        const s64 next_time = static_cast<s64>(*next_event_time - global_timer);
         return next_time;
     } else {
         return std::nullopt;
@@ -221,8 +607,7 @@ void CoreTiming::ThreadLoop() {
             const auto next_time = Advance();
             if (next_time) {
                 if (*next_time > 0) {
-                    std::chrono::nanoseconds next_time_ns = std::chrono::nanoseconds(*next_time);
-                    event.WaitFor(next_time_ns);
+                    PreciseWait(std::chrono::nanoseconds(*next_time));
                 }
             } else {
                 wait_set = true;
@@ -237,6 +622,43 @@ void CoreTiming::ThreadLoop() {
     }
 }
 
+void CoreTiming::PreciseWait(std::chrono::nanoseconds wait_time) {
+    const s64 start = clock->GetTimeNS().count();
+    const s64 deadline = start + wait_time.count();
+    if (wait_time.count() > spin_time) {
+        const s64 sleep_time = wait_time.count() - spin_time;
+        if (event.WaitFor(std::chrono::nanoseconds{sleep_time})) {
+            // A new event was scheduled, it may be due before the deadline
+            return;
+        }
+        // Leave room in the spin for the usual overshoot and its spikes
+        const s64 oversleep = std::max<s64>(clock->GetTimeNS().count() - (start + sleep_time), 0);
+        average_oversleep += (oversleep - average_oversleep) / 8;
+        spin_time = std::clamp(average_oversleep * 2, MIN_SPIN_TIME, MAX_SPIN_TIME);
+    }
+    s64 now = clock->GetTimeNS().count();
+    while (now < deadline) {
+        if (event.TryWait()) {
+            // Consume the signal, otherwise the next wait would return right away as well
+            return;
+        }
+        std::this_thread::yield();
+        now = clock->GetTimeNS().count();
+    }
+    const u64 late_us = static_cast<u64>(now - deadline) / 1000;
+    const std::size_t bucket =
+        std::min<std::size_t>(std::bit_width(late_us), NUM_LATENESS_BUCKETS - 1);
+    lateness_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::array<u64, CoreTiming::NUM_LATENESS_BUCKETS> CoreTiming::GetWakeupLatenessHistogram() const {
+    std::array<u64, NUM_LATENESS_BUCKETS> histogram;
+    for (std::size_t i = 0; i < NUM_LATENESS_BUCKETS; ++i) {
+        histogram[i] = lateness_histogram[i].load(std::memory_order_relaxed);
+    }
+    return histogram;
+}
+
 std::chrono::nanoseconds CoreTiming::GetGlobalTimeNs() const {
     if (is_multicore) {
         return clock->GetTimeNS();
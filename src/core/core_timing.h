@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <functional>
@@ -18,6 +19,7 @@
 #include "common/spin_lock.h"
 #include "common/thread.h"
 #include "common/wall_clock.h"
+#include "core/hardware_properties.h"
 
 namespace Core::Timing {
 
@@ -127,8 +129,24 @@ public:
     /// Checks for events manually and returns time in nanoseconds for next event, threadsafe.
     std::optional<s64> Advance();
 
+    /// Number of buckets in the wakeup lateness histogram. Bucket 0 counts the timer thread
+    /// wakeups that were less than a microsecond late, bucket N those that were at least
+    /// 2^(N-1) microseconds late. The last bucket also counts anything later than that.
+    static constexpr std::size_t NUM_LATENESS_BUCKETS = 16;
+
+    /// Returns how late the timer thread has woken up for its events.
+    std::array<u64, NUM_LATENESS_BUCKETS> GetWakeupLatenessHistogram() const;
+
 private:
     struct Event;
+    class EventQueue;
+
+    /// Number of inboxes events are scheduled into, one per emulated core plus the host threads.
+    static constexpr std::size_t NUM_INBOXES = Hardware::NUM_CPU_CORES + 1;
+
+    /// Moves the events scheduled since the last call into the event queue. basic_lock must be
+    /// held.
+    void DrainInboxes();
 
     /// Clear all pending events. This should ONLY be done on exit.
     void ClearPendingEvents();
@@ -136,16 +154,29 @@ private:
     static void ThreadEntry(CoreTiming& instance);
     void ThreadLoop();
 
+    /// Waits for wait_time or until event is set. Sleeps for most of the wait and spins on the
+    /// clock for the last stretch, sized after how much the previous sleeps overshot.
+    void PreciseWait(std::chrono::nanoseconds wait_time);
+
     std::unique_ptr<Common::WallClock> clock;
 
     u64 global_timer = 0;
 
-    // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-    // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-    // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
-    // accomodated by the standard adaptor class.
-    std::vector<Event> event_queue;
-    u64 event_fifo_id = 0;
+    // Pending events are kept in a hierarchical timing wheel, scheduling and unscheduling an
+    // event doesn't depend on the number of pending events. Threads push new events into their
+    // inbox without locking, the inboxes are drained into the wheel under basic_lock.
+    std::unique_ptr<EventQueue> event_queue;
+    std::array<std::atomic<Event*>, NUM_INBOXES> inboxes{};
+    std::atomic<u64> event_fifo_id = 0;
+    std::atomic<std::size_t> num_pending_events = 0;
+
+    /// Events being fired by Advance, kept to reuse the allocation.
+    std::vector<Event*> due_events;
+
+    /// Time spun at the end of a wait and moving average of the sleep overshoot, in nanoseconds.
+    s64 spin_time{};
+    s64 average_oversleep{};
+    std::array<std::atomic<u64>, NUM_LATENESS_BUCKETS> lateness_histogram{};
 
     std::shared_ptr<EventType> ev_lost;
     Common::Event event{};
@@ -6,7 +6,12 @@
 
 namespace Core {
 
-DeviceMemory::DeviceMemory() : buffer{DramMemoryMap::Size} {}
+namespace {
+/// Size of the largest guest address space, 39 bits for 64-bit processes
+constexpr u64 FastmemAddressSpaceSize = 1ULL << 39;
+} // Anonymous namespace
+
+DeviceMemory::DeviceMemory() : buffer{DramMemoryMap::Size, FastmemAddressSpaceSize} {}
 DeviceMemory::~DeviceMemory() = default;
 
 } // namespace Core
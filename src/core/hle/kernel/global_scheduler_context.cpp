@@ -5,11 +5,17 @@
 #include <mutex>
 
 #include "common/assert.h"
+#include "common/microprofile.h"
 #include "core/core.h"
 #include "core/hle/kernel/global_scheduler_context.h"
 #include "core/hle/kernel/k_scheduler.h"
 #include "core/hle/kernel/kernel.h"
 
+MICROPROFILE_DEFINE(Kernel_SchedulerLockWait, "Kernel", "Scheduler Lock Wait",
+                    MP_RGB(200, 70, 70));
+MICROPROFILE_DEFINE(Kernel_SchedulerLockHeld, "Kernel", "Scheduler Lock Held",
+                    MP_RGB(200, 150, 70));
+
 namespace Kernel {
 
 GlobalSchedulerContext::GlobalSchedulerContext(KernelCore& kernel)
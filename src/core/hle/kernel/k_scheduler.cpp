@@ -57,8 +57,10 @@ void KScheduler::RescheduleCores(KernelCore& kernel, u64 cores_pending_reschedul
 }
 
 u64 KScheduler::UpdateHighestPriorityThread(Thread* highest_thread) {
-    std::scoped_lock lock{guard};
-    if (Thread* prev_highest_thread = this->state.highest_priority_thread;
+    // Only the scheduler lock holder writes the highest priority thread, so the core's guard
+    // isn't needed. Taking it would stall the lock holder while the core switches contexts.
+    if (Thread* prev_highest_thread =
+            this->state.highest_priority_thread.load(std::memory_order_relaxed);
         prev_highest_thread != highest_thread) {
         if (prev_highest_thread != nullptr) {
             IncrementScheduledCount(prev_highest_thread);
@@ -75,8 +77,10 @@ u64 KScheduler::UpdateHighestPriorityThread(Thread* highest_thread) {
             }
         }
 
-        this->state.highest_priority_thread = highest_thread;
-        this->state.needs_scheduling = true;
+        // Publish the thread before flagging the core, the core clears the flag before reading
+        // the thread so it can't miss an update.
+        this->state.highest_priority_thread.store(highest_thread, std::memory_order_release);
+        this->state.needs_scheduling.store(true, std::memory_order_release);
         return (1ULL << this->core_id);
     } else {
         return 0;
@@ -454,7 +458,8 @@ void KScheduler::YieldWithCoreMigration() {
 
                 if (Thread* running_on_suggested_core =
                         (suggested_core >= 0)
-                            ? kernel.Scheduler(suggested_core).state.highest_priority_thread
+                            ? kernel.Scheduler(suggested_core)
+                                  .state.highest_priority_thread.load(std::memory_order_relaxed)
                             : nullptr;
                     running_on_suggested_core != suggested) {
                     // If the current thread's priority is higher than our suggestion's we prefer
@@ -675,9 +680,8 @@ void KScheduler::SwitchContextStep2() {
 
 void KScheduler::ScheduleImpl() {
     Thread* previous_thread = current_thread;
-    current_thread = state.highest_priority_thread;
-
-    this->state.needs_scheduling = false;
+    this->state.needs_scheduling.exchange(false, std::memory_order_acq_rel);
+    current_thread = state.highest_priority_thread.load(std::memory_order_acquire);
 
     if (current_thread == previous_thread) {
         guard.unlock();
@@ -714,12 +718,11 @@ void KScheduler::SwitchToCurrent() {
     while (true) {
         {
             std::scoped_lock lock{guard};
-            current_thread = state.highest_priority_thread;
-            this->state.needs_scheduling = false;
+            this->state.needs_scheduling.exchange(false, std::memory_order_acq_rel);
+            current_thread = state.highest_priority_thread.load(std::memory_order_acquire);
         }
         const auto is_switch_pending = [this] {
-            std::scoped_lock lock{guard};
-            return state.needs_scheduling.load(std::memory_order_relaxed);
+            return state.needs_scheduling.load(std::memory_order_acquire);
         };
         do {
             if (current_thread != nullptr && !current_thread->IsHLEThread()) {
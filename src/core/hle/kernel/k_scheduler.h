@@ -178,7 +178,9 @@ private:
         bool interrupt_task_thread_runnable{};
         bool should_count_idle{};
         u64 idle_count{};
-        Thread* highest_priority_thread{};
+        /// Thread the core should run next. It's posted by the holder of the scheduler lock
+        /// without synchronizing with the core, which picks it up at its next scheduling point.
+        std::atomic<Thread*> highest_priority_thread{};
         void* idle_thread_stack{};
     };
 
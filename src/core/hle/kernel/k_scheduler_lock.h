@@ -8,10 +8,14 @@
 #pragma once
 
 #include "common/assert.h"
+#include "common/microprofile.h"
 #include "common/spin_lock.h"
 #include "core/hardware_properties.h"
 #include "core/hle/kernel/kernel.h"
 
+MICROPROFILE_DECLARE(Kernel_SchedulerLockWait);
+MICROPROFILE_DECLARE(Kernel_SchedulerLockHeld);
+
 namespace Kernel {
 
 class KernelCore;
@@ -33,7 +37,11 @@ public:
         } else {
             // Otherwise, we want to disable scheduling and acquire the spinlock.
             SchedulerType::DisableScheduling(kernel);
-            this->spin_lock.lock();
+            {
+                MICROPROFILE_SCOPE(Kernel_SchedulerLockWait);
+                this->spin_lock.lock();
+            }
+            this->held_ticks = MicroProfileEnter(MICROPROFILE_TOKEN(Kernel_SchedulerLockHeld));
 
             // For debug, ensure that our state is valid.
             ASSERT(this->lock_count == 0);
@@ -58,6 +66,7 @@ public:
 
             // Note that we no longer hold the lock, and unlock the spinlock.
             this->owner_thread = Core::EmuThreadHandle::InvalidHandle();
+            MicroProfileLeave(MICROPROFILE_TOKEN(Kernel_SchedulerLockHeld), this->held_ticks);
             this->spin_lock.unlock();
 
             // Enable scheduling, and perform a rescheduling operation.
@@ -69,6 +78,7 @@ private:
     KernelCore& kernel;
     Common::SpinLock spin_lock{};
     s32 lock_count{};
+    u64 held_ticks{};
     Core::EmuThreadHandle owner_thread{Core::EmuThreadHandle::InvalidHandle()};
 };
 
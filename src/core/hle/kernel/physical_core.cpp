@@ -2,7 +2,6 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include "common/spin_lock.h"
 #include "core/arm/cpu_interrupt_handler.h"
 #include "core/arm/dynarmic/arm_dynarmic_32.h"
 #include "core/arm/dynarmic/arm_dynarmic_64.h"
@@ -15,8 +14,7 @@ namespace Kernel {
 
 PhysicalCore::PhysicalCore(std::size_t core_index, Core::System& system,
                            Kernel::KScheduler& scheduler, Core::CPUInterrupts& interrupts)
-    : core_index{core_index}, system{system}, scheduler{scheduler},
-      interrupts{interrupts}, guard{std::make_unique<Common::SpinLock>()} {}
+    : core_index{core_index}, system{system}, scheduler{scheduler}, interrupts{interrupts} {}
 
 PhysicalCore::~PhysicalCore() = default;
 
@@ -48,15 +46,12 @@ bool PhysicalCore::IsInterrupted() const {
 }
 
 void PhysicalCore::Interrupt() {
-    guard->lock();
+    // The interrupt state is a single atomic flag, other cores can raise it without locking
     interrupts[core_index].SetInterrupt(true);
-    guard->unlock();
 }
 
 void PhysicalCore::ClearInterrupt() {
-    guard->lock();
     interrupts[core_index].SetInterrupt(false);
-    guard->unlock();
 }
 
 } // namespace Kernel
@@ -42,12 +42,20 @@ struct Memory::Impl {
         ASSERT_MSG((size & PAGE_MASK) == 0, "non-page aligned size: {:016X}", size);
         ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: {:016X}", base);
         MapPages(page_table, base / PAGE_SIZE, size / PAGE_SIZE, target, Common::PageType::Memory);
+
+        if (page_table.fastmem_arena) {
+            system.DeviceMemory().GetHostMemory().Map(base, target - DramMemoryMap::Base, size);
+        }
     }
 
     void UnmapRegion(Common::PageTable& page_table, VAddr base, u64 size) {
         ASSERT_MSG((size & PAGE_MASK) == 0, "non-page aligned size: {:016X}", size);
         ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: {:016X}", base);
         MapPages(page_table, base / PAGE_SIZE, size / PAGE_SIZE, 0, Common::PageType::Unmapped);
+
+        if (page_table.fastmem_arena) {
+            system.DeviceMemory().GetHostMemory().Unmap(base, size);
+        }
     }
 
     bool IsValidVirtualAddress(const Kernel::Process& process, const VAddr vaddr) const {
@@ -471,10 +479,37 @@ struct Memory::Impl {
         // granularity of CPU pages, hence why we iterate on a CPU page basis (note: GPU page size
         // is different). This assumes the specified GPU address region is contiguous as well.
 
-        const u64 num_pages = ((vaddr + size - 1) >> PAGE_BITS) - (vaddr >> PAGE_BITS) + 1;
-        for (u64 i = 0; i < num_pages; ++i, vaddr += PAGE_SIZE) {
-            const Common::PageType page_type{
-                current_page_table->pointers[vaddr >> PAGE_BITS].Type()};
+        // Cached pages are made inaccessible in the fastmem arena, so the JIT faults and falls
+        // back to the page table. Contiguous runs of pages are protected with a single call.
+        const bool is_fastmem = current_page_table->fastmem_arena != nullptr;
+        VAddr protect_begin = 0;
+        u64 protect_size = 0;
+        const auto flush_protect = [&] {
+            if (protect_size != 0) {
+                system.DeviceMemory().GetHostMemory().Protect(protect_begin, protect_size, !cached,
+                                                              !cached);
+            }
+        };
+        const auto protect_page = [&](VAddr page_addr) {
+            if (!is_fastmem) {
+                return;
+            }
+            if (protect_size != 0 && protect_begin + protect_size == page_addr) {
+                protect_size += PAGE_SIZE;
+                return;
+            }
+            flush_protect();
+            protect_begin = page_addr;
+            protect_size = PAGE_SIZE;
+        };
+
+        const u64 first_page = vaddr >> PAGE_BITS;
+        const u64 last_page = (vaddr + size - 1) >> PAGE_BITS;
+        Common::PageTable::PageInfo* const pointers = current_page_table->pointers.data();
+        const u64* const backing_addr = current_page_table->backing_addr.data();
+        for (u64 page = first_page; page <= last_page; ++page) {
+            Common::PageTable::PageInfo& page_info = pointers[page];
+            const Common::PageType page_type{page_info.Type()};
             if (cached) {
                 // Switch page type to cached if now cached
                 switch (page_type) {
@@ -483,8 +518,8 @@ struct Memory::Impl {
                     // space, for example, a system module need not have a VRAM mapping.
                     break;
                 case Common::PageType::Memory:
-                    current_page_table->pointers[vaddr >> PAGE_BITS].Store(
-                        nullptr, Common::PageType::RasterizerCachedMemory);
+                    page_info.Store(nullptr, Common::PageType::RasterizerCachedMemory);
+                    protect_page(page << PAGE_BITS);
                     break;
                 case Common::PageType::RasterizerCachedMemory:
                     // There can be more than one GPU region mapped per CPU region, so it's common
@@ -505,16 +540,18 @@ struct Memory::Impl {
                     // that this area is already unmarked as cached.
                     break;
                 case Common::PageType::RasterizerCachedMemory: {
-                    u8* const pointer{GetPointerFromRasterizerCachedMemory(vaddr & ~PAGE_MASK)};
-                    if (pointer == nullptr) {
+                    const PAddr backing = backing_addr[page];
+                    if (backing == 0) {
                         // It's possible that this function has been called while updating the
                         // pagetable after unmapping a VMA. In that case the underlying VMA will no
                         // longer exist, and we should just leave the pagetable entry blank.
-                        current_page_table->pointers[vaddr >> PAGE_BITS].Store(
-                            nullptr, Common::PageType::Unmapped);
+                        page_info.Store(nullptr, Common::PageType::Unmapped);
                     } else {
-                        current_page_table->pointers[vaddr >> PAGE_BITS].Store(
-                            pointer - (vaddr & ~PAGE_MASK), Common::PageType::Memory);
+                        // The backing address is biased like the page pointer, so the restored
+                        // pointer can be derived from it directly
+                        page_info.Store(system.DeviceMemory().GetPointer(backing),
+                                        Common::PageType::Memory);
+                        protect_page(page << PAGE_BITS);
                     }
                     break;
                 }
@@ -523,6 +560,7 @@ struct Memory::Impl {
                 }
             }
         }
+        flush_protect();
     }
 
     /**
@@ -541,13 +579,24 @@ struct Memory::Impl {
 
         // During boot, current_page_table might not be set yet, in which case we need not flush
         if (system.IsPoweredOn()) {
+            // Flush contiguous runs of cached pages with a single call
             auto& gpu = system.GPU();
-            for (u64 i = 0; i < size; i++) {
-                const auto page = base + i;
+            u64 run_begin = 0;
+            u64 run_size = 0;
+            for (u64 page = base; page < base + size; ++page) {
                 if (page_table.pointers[page].Type() == Common::PageType::RasterizerCachedMemory) {
-                    gpu.FlushAndInvalidateRegion(page << PAGE_BITS, PAGE_SIZE);
+                    if (run_size == 0) {
+                        run_begin = page;
+                    }
+                    ++run_size;
+                } else if (run_size != 0) {
+                    gpu.FlushAndInvalidateRegion(run_begin << PAGE_BITS, run_size << PAGE_BITS);
+                    run_size = 0;
                 }
             }
+            if (run_size != 0) {
+                gpu.FlushAndInvalidateRegion(run_begin << PAGE_BITS, run_size << PAGE_BITS);
+            }
         }
 
         const VAddr end = base + size;
@@ -558,24 +607,14 @@ struct Memory::Impl {
             ASSERT_MSG(type != Common::PageType::Memory,
                        "Mapping memory page without a pointer @ {:016x}", base * PAGE_SIZE);
 
-            while (base != end) {
-                page_table.pointers[base].Store(nullptr, type);
-                page_table.backing_addr[base] = 0;
-
-                base += 1;
-            }
+            page_table.FillRange(base, size, nullptr, type, 0);
         } else {
-            while (base != end) {
-                page_table.pointers[base].Store(
-                    system.DeviceMemory().GetPointer(target) - (base << PAGE_BITS), type);
-                page_table.backing_addr[base] = target - (base << PAGE_BITS);
-
-                ASSERT_MSG(page_table.pointers[base].Pointer(),
-                           "memory mapping base yield a nullptr within the table");
+            // Both the pointer and the backing address are biased by the page's virtual address,
+            // so a linear mapping writes the same value to every entry
+            u8* const pointer = system.DeviceMemory().GetPointer(target) - (base << PAGE_BITS);
+            ASSERT_MSG(pointer != nullptr, "memory mapping base yield a nullptr within the table");
 
-                base += 1;
-                target += PAGE_SIZE;
-            }
+            page_table.FillRange(base, size, pointer, type, target - (base << PAGE_BITS));
         }
     }
 
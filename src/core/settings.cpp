@@ -58,6 +58,12 @@ void LogSettings() {
     log_setting("Renderer_UseFrameLimit", values.use_frame_limit.GetValue());
     log_setting("Renderer_FrameLimit", values.frame_limit.GetValue());
     log_setting("Renderer_UseDiskShaderCache", values.use_disk_shader_cache.GetValue());
+    log_setting("Renderer_UseDiskTextureCache", values.use_disk_texture_cache.GetValue());
+    log_setting("Renderer_UseTextureContentHash", values.use_texture_content_hash.GetValue());
+    log_setting("Renderer_TextureCacheBudget", values.texture_cache_budget.GetValue());
+    log_setting("Renderer_UseAsynchronousTextureDecode",
+                values.use_asynchronous_texture_decode.GetValue());
+    log_setting("Renderer_UseTexturePlaceholders", values.use_texture_placeholders.GetValue());
     log_setting("Renderer_GPUAccuracyLevel", values.gpu_accuracy.GetValue());
     log_setting("Renderer_UseAsynchronousGpuEmulation",
                 values.use_asynchronous_gpu_emulation.GetValue());
@@ -122,6 +128,11 @@ void RestoreGlobalState(bool is_powered_on) {
     values.use_frame_limit.SetGlobal(true);
     values.frame_limit.SetGlobal(true);
     values.use_disk_shader_cache.SetGlobal(true);
+    values.use_disk_texture_cache.SetGlobal(true);
+    values.use_texture_content_hash.SetGlobal(true);
+    values.texture_cache_budget.SetGlobal(true);
+    values.use_asynchronous_texture_decode.SetGlobal(true);
+    values.use_texture_placeholders.SetGlobal(true);
     values.gpu_accuracy.SetGlobal(true);
     values.use_asynchronous_gpu_emulation.SetGlobal(true);
     values.use_nvdec_emulation.SetGlobal(true);
@@ -23,6 +23,7 @@ namespace Settings {
 enum class RendererBackend {
     OpenGL = 0,
     Vulkan = 1,
+    Null = 2,
 };
 
 enum class GPUAccuracy : u32 {
@@ -144,6 +145,11 @@ struct Values {
     Setting<bool> use_frame_limit;
     Setting<u16> frame_limit;
     Setting<bool> use_disk_shader_cache;
+    Setting<bool> use_disk_texture_cache;
+    Setting<bool> use_texture_content_hash;
+    Setting<u32> texture_cache_budget; ///< In MiB, zero disables eviction
+    Setting<bool> use_asynchronous_texture_decode;
+    Setting<bool> use_texture_placeholders;
     Setting<GPUAccuracy> gpu_accuracy;
     Setting<bool> use_asynchronous_gpu_emulation;
     Setting<bool> use_nvdec_emulation;
@@ -220,6 +226,8 @@ struct Values {
     bool reporting_services;
     bool quest_flag;
     bool disable_macro_jit;
+    bool profile_macros;
+    bool record_gpu_commands;
     bool extended_logging;
 
     // Miscellaneous
@@ -0,0 +1,167 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_interpreter.h"
+#include "video_core/memory_manager.h"
+#include "video_core/renderer_vulkan/fixed_pipeline_state.h"
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/macro/macro_jit_x64.h"
+#endif
+
+namespace {
+using Tegra::Macro::ALUOperation;
+using Tegra::Macro::BranchCondition;
+using Tegra::Macro::Opcode;
+using Tegra::Macro::Operation;
+using Tegra::Macro::ResultOperation;
+
+constexpr u32 MACRO_METHOD = 0;
+
+Opcode MakeALU(ALUOperation alu_operation, u32 dst, u32 src_a, u32 src_b) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::ALU);
+    opcode.result_operation.Assign(ResultOperation::Move);
+    opcode.alu_operation.Assign(alu_operation);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.src_b.Assign(src_b);
+    return opcode;
+}
+
+Opcode MakeAddImmediate(u32 dst, u32 src_a, s32 immediate) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::AddImmediate);
+    opcode.result_operation.Assign(ResultOperation::Move);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(immediate);
+    return opcode;
+}
+
+/// Builds a macro that runs an arithmetic loop as many times as its first parameter says
+std::vector<u32> MakeLoopMacro() {
+    Opcode branch{};
+    branch.operation.Assign(Operation::Branch);
+    branch.branch_condition.Assign(BranchCondition::NotZero);
+    branch.src_a.Assign(2);
+    branch.immediate.Assign(-3);
+
+    Opcode exit = MakeAddImmediate(0, 0, 0);
+    exit.is_exit.Assign(1);
+
+    return {
+        MakeAddImmediate(2, 1, 0).raw,             // r2 = r1
+        MakeALU(ALUOperation::Add, 3, 3, 2).raw,   // loop: r3 += r2
+        MakeALU(ALUOperation::Xor, 4, 4, 3).raw,   // r4 ^= r3
+        MakeAddImmediate(2, 2, -1).raw,            // r2 -= 1
+        branch.raw,                                // if r2 != 0 goto loop
+        MakeAddImmediate(5, 5, 1).raw,             // delay slot: r5 += 1
+        exit.raw,                                  // exit
+        MakeAddImmediate(0, 0, 0).raw,             // delay slot
+    };
+}
+
+/// Consecutive register writes, like the state updates found in command lists between draws
+struct MethodRun {
+    u32 method;
+    std::vector<u32> arguments;
+};
+
+std::vector<MethodRun> MakeStateUpdateRuns() {
+    std::vector<MethodRun> runs;
+    const auto add_run = [&runs](u32 method, u32 size, u32 seed) {
+        MethodRun& run = runs.emplace_back(MethodRun{method, std::vector<u32>(size)});
+        for (u32 i = 0; i < size; ++i) {
+            run.arguments[i] = seed * 0x9E3779B9U + i;
+        }
+    };
+    for (u32 frame = 0; frame < 16; ++frame) {
+        add_run(MAXWELL3D_REG_INDEX(rt), 16, frame);
+        add_run(MAXWELL3D_REG_INDEX(viewport_transform), 8 * 16, frame);
+        add_run(MAXWELL3D_REG_INDEX(viewports), 4 * 16, frame);
+        add_run(MAXWELL3D_REG_INDEX(scissor_test), 4 * 16, frame);
+        add_run(MAXWELL3D_REG_INDEX(vertex_attrib_format), 32, frame);
+        add_run(MAXWELL3D_REG_INDEX(const_buffer.cb_size), 3, frame);
+    }
+    return runs;
+}
+void RunMacroBenchmark(Tegra::Engines::Maxwell3D& maxwell3d, Tegra::MacroEngine& engine,
+                       const char* name) {
+    for (const u32 word : MakeLoopMacro()) {
+        engine.AddCode(MACRO_METHOD, word);
+    }
+    const std::vector<u32> parameters{1024};
+
+    // Compile the macro before measuring
+    engine.Execute(maxwell3d, MACRO_METHOD, parameters);
+
+    BENCHMARK(name) {
+        engine.Execute(maxwell3d, MACRO_METHOD, parameters);
+    };
+}
+} // Anonymous namespace
+
+TEST_CASE("Macro: Arithmetic loop", "[benchmark][video_core]") {
+    Core::System& system = Core::System::GetInstance();
+    Tegra::MemoryManager memory_manager(system);
+    Tegra::Engines::Maxwell3D maxwell3d(system, memory_manager);
+
+    Tegra::MacroInterpreter interpreter(maxwell3d);
+    RunMacroBenchmark(maxwell3d, interpreter, "MacroInterpreter");
+#ifdef ARCHITECTURE_x86_64
+    Tegra::MacroJITx64 jit(maxwell3d);
+    RunMacroBenchmark(maxwell3d, jit, "MacroJITx64");
+#endif
+}
+
+TEST_CASE("Maxwell3D: Increasing method writes", "[benchmark][video_core]") {
+    Core::System& system = Core::System::GetInstance();
+    Tegra::MemoryManager memory_manager(system);
+    Tegra::Engines::Maxwell3D maxwell3d(system, memory_manager);
+    const std::vector<MethodRun> runs = MakeStateUpdateRuns();
+
+    BENCHMARK("CallMethod") {
+        for (const MethodRun& run : runs) {
+            const u32 size = static_cast<u32>(run.arguments.size());
+            for (u32 i = 0; i < size; ++i) {
+                maxwell3d.CallMethod(run.method + i, run.arguments[i], size - i <= 1);
+            }
+        }
+        return maxwell3d.regs.reg_array[0];
+    };
+    BENCHMARK("CallIncreasingMethods") {
+        for (const MethodRun& run : runs) {
+            const u32 size = static_cast<u32>(run.arguments.size());
+            maxwell3d.CallIncreasingMethods(run.method, run.arguments.data(), size, size);
+        }
+        return maxwell3d.regs.reg_array[0];
+    };
+}
+
+TEST_CASE("FixedPipelineState: Fill and hash", "[benchmark][video_core]") {
+    Core::System& system = Core::System::GetInstance();
+    Tegra::MemoryManager memory_manager(system);
+    Tegra::Engines::Maxwell3D maxwell3d(system, memory_manager);
+    Vulkan::FixedPipelineState state{};
+
+    for (const bool has_extended_dynamic_state : {false, true}) {
+        BENCHMARK(has_extended_dynamic_state ? "Fill with extended dynamic state" : "Fill") {
+            state.Fill(maxwell3d.regs, has_extended_dynamic_state);
+            return state.raw1;
+        };
+        state.Fill(maxwell3d.regs, has_extended_dynamic_state);
+        BENCHMARK(has_extended_dynamic_state ? "Hash with extended dynamic state" : "Hash") {
+            return state.Hash();
+        };
+    }
+}
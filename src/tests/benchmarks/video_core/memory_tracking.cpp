@@ -0,0 +1,88 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/buffer_cache/buffer_base.h"
+#include "video_core/memory_manager.h"
+
+namespace {
+using VideoCommon::BufferBase;
+
+constexpr u64 PAGE = 4096;
+constexpr VAddr CPU_ADDR = 0x1328914000;
+
+class RasterizerInterface {
+public:
+    void UpdatePagesCachedCount(VAddr, u64, int) {}
+};
+} // Anonymous namespace
+
+TEST_CASE("BufferBase: ForEachUploadRange", "[benchmark][video_core]") {
+    RasterizerInterface rasterizer;
+    constexpr u64 SIZE = 64 * 1024 * 1024;
+    BufferBase buffer(rasterizer, CPU_ADDR, SIZE);
+
+    BENCHMARK("Clean buffer") {
+        u64 total = 0;
+        buffer.ForEachUploadRange(CPU_ADDR, SIZE, [&](u64, u64 size) { total += size; });
+        return total;
+    };
+    for (const u64 stride : {1ULL, 2ULL, 64ULL, 1024ULL}) {
+        BENCHMARK(fmt::format("Mark and upload every {} pages", stride)) {
+            for (u64 offset = 0; offset < SIZE; offset += PAGE * stride) {
+                buffer.MarkRegionAsCpuModified(CPU_ADDR + offset, PAGE);
+            }
+            u64 total = 0;
+            buffer.ForEachUploadRange(CPU_ADDR, SIZE, [&](u64, u64 size) { total += size; });
+            return total;
+        };
+    }
+}
+
+TEST_CASE("BufferBase: Queries on a mostly clean buffer", "[benchmark][video_core]") {
+    RasterizerInterface rasterizer;
+    constexpr u64 SIZE = 512 * 1024 * 1024;
+    BufferBase buffer(rasterizer, CPU_ADDR, SIZE);
+    buffer.UnmarkRegionAsCpuModified(CPU_ADDR, SIZE);
+    buffer.MarkRegionAsCpuModified(CPU_ADDR + SIZE / 3, PAGE);
+    buffer.MarkRegionAsGpuModified(CPU_ADDR + SIZE / 2, PAGE);
+
+    BENCHMARK("IsRegionCpuModified") {
+        return buffer.IsRegionCpuModified(CPU_ADDR + SIZE / 2, SIZE / 2);
+    };
+    BENCHMARK("IsRegionGpuModified") {
+        return buffer.IsRegionGpuModified(CPU_ADDR, SIZE / 2);
+    };
+    BENCHMARK("ModifiedCpuRegion") {
+        return buffer.ModifiedCpuRegion(CPU_ADDR, SIZE);
+    };
+    BENCHMARK("Mark and upload one page") {
+        buffer.MarkRegionAsCpuModified(CPU_ADDR + SIZE / 4, PAGE);
+        u64 total = 0;
+        buffer.ForEachUploadRange(CPU_ADDR, SIZE, [&](u64, u64 size) { total += size; });
+        return total;
+    };
+}
+
+TEST_CASE("MemoryManager: Address translation", "[benchmark][video_core]") {
+    // ReadBlock requires a running process and a bound rasterizer, so measure the GPU to CPU
+    // address translation it performs for every page instead.
+    Tegra::MemoryManager memory_manager(Core::System::GetInstance());
+    constexpr u64 SIZE = 256 * 1024 * 1024;
+    const GPUVAddr gpu_addr = memory_manager.MapAllocate(CPU_ADDR, SIZE, PAGE);
+
+    for (const u64 step : {PAGE, u64{0x10000}}) {
+        BENCHMARK(fmt::format("GpuToCpuAddress step={:#x}", step)) {
+            VAddr sum = 0;
+            for (u64 offset = 0; offset < SIZE; offset += step) {
+                sum += memory_manager.GpuToCpuAddress(gpu_addr + offset).value_or(0);
+            }
+            return sum;
+        };
+    }
+}
@@ -0,0 +1,179 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "video_core/surface.h"
+#include "video_core/texture_cache/formatter.h"
+#include "video_core/texture_cache/image_info.h"
+#include "video_core/texture_cache/types.h"
+#include "video_core/texture_cache/util.h"
+#include "video_core/textures/astc.h"
+#include "video_core/textures/decoders.h"
+
+namespace {
+using VideoCommon::BufferImageCopy;
+using VideoCommon::ImageInfo;
+using VideoCommon::ImageType;
+using VideoCore::Surface::PixelFormat;
+
+constexpr u32 WIDTH = 1024;
+constexpr u32 HEIGHT = 1024;
+
+struct ASTCBlockSize {
+    u32 width;
+    u32 height;
+};
+
+constexpr std::array ASTC_BLOCK_SIZES{
+    ASTCBlockSize{4, 4},
+    ASTCBlockSize{5, 4},
+    ASTCBlockSize{5, 5},
+    ASTCBlockSize{6, 5},
+    ASTCBlockSize{6, 6},
+    ASTCBlockSize{8, 5},
+    ASTCBlockSize{8, 6},
+    ASTCBlockSize{8, 8},
+    ASTCBlockSize{10, 8},
+    ASTCBlockSize{10, 10},
+    ASTCBlockSize{12, 12},
+};
+
+std::vector<u8> RandomBytes(size_t size, u32 seed = 0) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<u32> dist(0, 0xff);
+    std::vector<u8> data(size);
+    for (u8& value : data) {
+        value = static_cast<u8>(dist(rng));
+    }
+    return data;
+}
+
+/**
+ * Builds an ASTC image out of random blocks that are valid for any 2D block size.
+ * Purely random data is mostly rejected by the decoder early, which would measure the error path
+ * instead of the actual decoding work. Blocks use a 4x4 weight grid with 2-bit weights, one or
+ * two partitions and a random LDR colour endpoint mode, the remaining bits are random.
+ */
+std::vector<u8> MakeASTCImage(size_t num_blocks) {
+    static constexpr std::array<u64, 9> LDR_ENDPOINT_MODES{0, 4, 5, 6, 8, 9, 10, 12, 13};
+    static constexpr u64 BLOCK_MODE_4X4_WEIGHTS = 0x042;
+
+    std::mt19937_64 rng(0);
+    std::vector<u8> image(num_blocks * 16);
+    for (size_t block = 0; block < num_blocks; ++block) {
+        std::array<u64, 2> words{rng(), rng()};
+        const u64 endpoint_mode = LDR_ENDPOINT_MODES[rng() % LDR_ENDPOINT_MODES.size()];
+        if (block % 2 == 0) {
+            words[0] = (words[0] & ~u64{0x1ffff}) | BLOCK_MODE_4X4_WEIGHTS | (endpoint_mode << 13);
+        } else {
+            // Two partitions with a random partition index sharing the same endpoint mode
+            words[0] = (words[0] & ~u64{0x1fffffff}) | (words[0] & (u64{0x3ff} << 13)) |
+                       BLOCK_MODE_4X4_WEIGHTS | (u64{1} << 11) | (endpoint_mode << 25);
+        }
+        std::memcpy(image.data() + block * 16, words.data(), 16);
+    }
+    return image;
+}
+
+BufferImageCopy MakeCopy(const ImageInfo& info) {
+    const u32 block_width = VideoCore::Surface::DefaultBlockWidth(info.format);
+    const u32 block_height = VideoCore::Surface::DefaultBlockHeight(info.format);
+    const u32 blocks_x = (info.size.width + block_width - 1) / block_width;
+    const u32 blocks_y = (info.size.height + block_height - 1) / block_height;
+    return BufferImageCopy{
+        .buffer_offset = 0,
+        .buffer_size = size_t{blocks_x} * blocks_y * VideoCore::Surface::BytesPerBlock(info.format),
+        .buffer_row_length = blocks_x * block_width,
+        .buffer_image_height = blocks_y * block_height,
+        .image_subresource{
+            .base_level = 0,
+            .base_layer = 0,
+            .num_layers = 1,
+        },
+        .image_offset{0, 0, 0},
+        .image_extent = info.size,
+    };
+}
+
+ImageInfo MakeImageInfo(PixelFormat format) {
+    ImageInfo info;
+    info.format = format;
+    info.type = ImageType::e2D;
+    info.size = {WIDTH, HEIGHT, 1};
+    return info;
+}
+} // Anonymous namespace
+
+TEST_CASE("Swizzle: Block linear textures", "[benchmark][video_core]") {
+    for (const u32 bytes_per_pixel : {1U, 2U, 4U, 8U, 16U}) {
+        for (u32 block_height = 0; block_height <= 5; ++block_height) {
+            const size_t swizzled_size = Tegra::Texture::CalculateSize(
+                true, bytes_per_pixel, WIDTH, HEIGHT, 1, block_height, 0);
+            std::vector<u8> swizzled = RandomBytes(swizzled_size);
+            std::vector<u8> linear(size_t{WIDTH} * HEIGHT * bytes_per_pixel);
+
+            BENCHMARK(fmt::format("Unswizzle bpp={} block_height={}", bytes_per_pixel,
+                                  1U << block_height)) {
+                Tegra::Texture::UnswizzleTexture(linear, swizzled, bytes_per_pixel, WIDTH, HEIGHT,
+                                                 1, block_height, 0);
+                return linear[0];
+            };
+            BENCHMARK(fmt::format("Swizzle bpp={} block_height={}", bytes_per_pixel,
+                                  1U << block_height)) {
+                Tegra::Texture::SwizzleTexture(swizzled, linear, bytes_per_pixel, WIDTH, HEIGHT, 1,
+                                               block_height, 0);
+                return swizzled[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("ASTC: Decompress", "[benchmark][video_core]") {
+    for (const ASTCBlockSize& block_size : ASTC_BLOCK_SIZES) {
+        const u32 blocks_x = (WIDTH + block_size.width - 1) / block_size.width;
+        const u32 blocks_y = (HEIGHT + block_size.height - 1) / block_size.height;
+        const std::vector<u8> input = MakeASTCImage(size_t{blocks_x} * blocks_y);
+        std::vector<u8> output(size_t{WIDTH} * HEIGHT * 4);
+
+        BENCHMARK(fmt::format("ASTC {}x{}", block_size.width, block_size.height)) {
+            Tegra::Texture::ASTC::Decompress(input, WIDTH, HEIGHT, 1, block_size.width,
+                                             block_size.height, output);
+            return output[0];
+        };
+    }
+}
+
+TEST_CASE("ConvertImage: Compressed formats", "[benchmark][video_core]") {
+    const ImageInfo astc_info = MakeImageInfo(PixelFormat::ASTC_2D_8X8_UNORM);
+    const BufferImageCopy astc_copy = MakeCopy(astc_info);
+    const std::vector<u8> astc_input = MakeASTCImage(astc_copy.buffer_size / 16);
+    std::vector<u8> output(size_t{WIDTH} * HEIGHT * 4);
+
+    BENCHMARK(fmt::format("ConvertImage {}", astc_info.format)) {
+        std::array copies{astc_copy};
+        VideoCommon::ConvertImage(astc_input, astc_info, output, copies);
+        return output[0];
+    };
+
+    for (const PixelFormat format : {PixelFormat::BC1_RGBA_UNORM, PixelFormat::BC3_UNORM,
+                                     PixelFormat::BC7_UNORM, PixelFormat::BC6H_UFLOAT}) {
+        const ImageInfo info = MakeImageInfo(format);
+        const BufferImageCopy copy = MakeCopy(info);
+        const std::vector<u8> input = RandomBytes(copy.buffer_size, static_cast<u32>(format));
+
+        BENCHMARK(fmt::format("ConvertImage {}", format)) {
+            std::array copies{copy};
+            VideoCommon::ConvertImage(input, info, output, copies);
+            return output[0];
+        };
+    }
+}
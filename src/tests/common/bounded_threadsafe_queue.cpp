@@ -0,0 +1,95 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/bounded_threadsafe_queue.h"
+
+namespace Common {
+
+TEST_CASE("BoundedSPSCQueue: Basic Tests", "[common]") {
+    BoundedSPSCQueue<int, 4> queue;
+    int value = 0;
+
+    // Popping from an empty queue should fail.
+    REQUIRE(queue.Empty());
+    REQUIRE(!queue.TryPop(value));
+
+    for (int i = 0; i < 4; i++) {
+        queue.Push(i);
+    }
+    REQUIRE(queue.Size() == 4U);
+
+    // Elements are popped in order.
+    for (int i = 0; i < 2; i++) {
+        REQUIRE(queue.TryPop(value));
+        REQUIRE(value == i);
+    }
+
+    // Freed slots are reused after wrapping around.
+    queue.Push(4);
+    queue.Push(5);
+    REQUIRE(queue.Size() == 4U);
+    for (int i = 2; i < 6; i++) {
+        REQUIRE(queue.PopWait() == i);
+    }
+    REQUIRE(queue.Empty());
+}
+
+TEST_CASE("BoundedSPSCQueue: Threaded Test", "[common]") {
+    // Move-only elements check that slots are moved out instead of copied
+    BoundedSPSCQueue<std::unique_ptr<std::size_t>, 8> queue;
+    const std::size_t count = 1000000;
+
+    std::thread producer{[&] {
+        for (std::size_t i = 0; i < count; i++) {
+            queue.Push(std::make_unique<std::size_t>(i));
+            if (i % 0x10000 == 0) {
+                // Give the consumer a chance to park
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }};
+
+    bool in_order = true;
+    for (std::size_t i = 0; i < count; i++) {
+        const std::unique_ptr<std::size_t> value = queue.PopWait();
+        in_order &= value && *value == i;
+    }
+    producer.join();
+
+    REQUIRE(in_order);
+    REQUIRE(queue.Empty());
+}
+
+TEST_CASE("BoundedSPSCQueue: Batch Test", "[common]") {
+    BoundedSPSCQueue<int, 8> queue;
+    std::vector<int> values(20);
+    std::iota(values.begin(), values.end(), 0);
+
+    std::thread producer{[&] { queue.PushBatch(values.begin(), values.end()); }};
+
+    // Batches larger than the queue are published as the reader frees slots
+    std::vector<int> popped;
+    while (popped.size() < values.size()) {
+        std::array<int, 3> batch{};
+        const std::size_t count = queue.TryPopBatch(batch.begin(), batch.size());
+        REQUIRE(count <= batch.size());
+        popped.insert(popped.end(), batch.begin(), batch.begin() + count);
+    }
+    producer.join();
+
+    REQUIRE(popped == values);
+    REQUIRE(queue.Empty());
+    int value = 0;
+    REQUIRE(queue.TryPopBatch(&value, 1) == 0U);
+}
+
+} // namespace Common
@@ -4,12 +4,14 @@
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <chrono>
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/file_util.h"
 #include "core/core.h"
@@ -145,3 +147,121 @@ TEST_CASE("CoreTiming[BasicOrderNoPausing]", "[core]") {
     printf("HostTimer No Pausing Timer Time: %.3f %.6f\n", timer_time / 1000.f,
            timer_time / 1000000.f);
 }
+
+TEST_CASE("CoreTiming[ManyEventsSingleCore]", "[core]") {
+    Core::Timing::CoreTiming core_timing;
+    core_timing.SetMulticore(false);
+    core_timing.Initialize([]() {});
+
+    std::vector<std::uintptr_t> fired;
+    const auto event = Core::Timing::CreateEvent(
+        "callback", [&fired](std::uintptr_t user_data, std::chrono::nanoseconds) {
+            fired.push_back(user_data);
+        });
+
+    // Spread the events from nanoseconds to seconds, so they land on every level of the queue
+    constexpr std::size_t num_events = 4096;
+    std::vector<s64> times(num_events);
+    u64 seed = 0x12345678;
+    for (std::size_t i = 0; i < num_events; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        times[i] = static_cast<s64>((seed >> 33) % (1ULL << (i % 32)));
+        core_timing.ScheduleEvent(std::chrono::nanoseconds{times[i]}, event, i);
+    }
+    // Unschedule every third event
+    for (std::size_t i = 0; i < num_events; i += 3) {
+        core_timing.UnscheduleEvent(event, i);
+    }
+
+    while (core_timing.Advance()) {
+        core_timing.Idle();
+    }
+
+    std::vector<std::uintptr_t> expected;
+    for (std::size_t i = 0; i < num_events; ++i) {
+        if (i % 3 != 0) {
+            expected.push_back(i);
+        }
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [&times](std::uintptr_t lhs, std::uintptr_t rhs) {
+                         return times[lhs] < times[rhs];
+                     });
+    REQUIRE(fired == expected);
+
+    core_timing.Shutdown();
+}
+
+TEST_CASE("CoreTiming[FarEventsSingleCore]", "[core]") {
+    Core::Timing::CoreTiming core_timing;
+    core_timing.SetMulticore(false);
+    core_timing.Initialize([]() {});
+
+    std::vector<std::uintptr_t> fired;
+    bool all_on_time = true;
+    const auto event = Core::Timing::CreateEvent(
+        "callback", [&](std::uintptr_t user_data, std::chrono::nanoseconds ns_late) {
+            fired.push_back(user_data);
+            all_on_time &= ns_late.count() >= 0 && ns_late.count() < 1000;
+        });
+
+    // Wheel ticks are 2^10 ns. Events 2^24 and 2^30 ticks away land on the two top levels, events
+    // past 2^36 ticks wait in the overflow list until the top level wraps around.
+    const std::array<s64, 12> times{
+        s64{1} << 62, s64{1} << 47,         (s64{1} << 46) + 5, (s64{1} << 46) - 5,
+        s64{1} << 41, (s64{1} << 42) + 123, s64{1} << 35,       (s64{1} << 36) + 7,
+        s64{1} << 20, 3 * (s64{1} << 46),   s64{1} << 48,       (s64{1} << 47) + 1,
+    };
+    for (std::size_t i = 0; i < times.size(); ++i) {
+        core_timing.ScheduleEvent(std::chrono::nanoseconds{times[i]}, event, i);
+    }
+    // Unscheduling from the overflow list and from the top level
+    core_timing.UnscheduleEvent(event, 0);
+    core_timing.UnscheduleEvent(event, 4);
+
+    while (core_timing.Advance()) {
+        core_timing.Idle();
+    }
+
+    const std::vector<std::uintptr_t> expected{8, 6, 7, 5, 3, 2, 1, 11, 9, 10};
+    REQUIRE(fired == expected);
+    REQUIRE(all_on_time);
+
+    core_timing.Shutdown();
+}
+
+TEST_CASE("CoreTiming[UnscheduleFromCallback]", "[core]") {
+    Core::Timing::CoreTiming core_timing;
+    core_timing.SetMulticore(false);
+    core_timing.Initialize([]() {});
+
+    std::vector<std::uintptr_t> fired;
+    std::shared_ptr<Core::Timing::EventType> event;
+    event = Core::Timing::CreateEvent(
+        "callback", [&](std::uintptr_t user_data, std::chrono::nanoseconds) {
+            fired.push_back(user_data);
+            if (user_data != 0) {
+                return;
+            }
+            // Event 1 is due in the same batch, event 2 is still in the wheel
+            core_timing.UnscheduleEvent(event, 1);
+            core_timing.UnscheduleEvent(event, 2);
+            // Scheduling again with the same user data must not be affected by the cancellation
+            core_timing.ScheduleEvent(std::chrono::nanoseconds{100}, event, 1);
+        });
+
+    core_timing.ScheduleEvent(std::chrono::nanoseconds{1000}, event, 0);
+    core_timing.ScheduleEvent(std::chrono::nanoseconds{1000}, event, 1);
+    core_timing.ScheduleEvent(std::chrono::nanoseconds{1'000'000}, event, 2);
+    core_timing.ScheduleEvent(std::chrono::nanoseconds{2'000'000}, event, 3);
+
+    while (core_timing.Advance()) {
+        core_timing.Idle();
+    }
+
+    const std::vector<std::uintptr_t> expected{0, 1, 3};
+    REQUIRE(fired == expected);
+    REQUIRE(!core_timing.Advance());
+
+    core_timing.Shutdown();
+}
@@ -471,3 +471,80 @@ TEST_CASE("BufferBase: Unaligned page region query") {
     REQUIRE(buffer.IsRegionCpuModified(c + 4000, 1000));
     REQUIRE(buffer.IsRegionCpuModified(c + 4000, 1));
 }
+
+TEST_CASE("BufferBase: Sparse pages in huge buffer", "[video_core]") {
+    RasterizerInterface rasterizer;
+    constexpr u64 SIZE = WORD * 64 * 32;
+    BufferBase buffer(rasterizer, c, SIZE);
+    buffer.UnmarkRegionAsCpuModified(c, SIZE);
+    REQUIRE(!buffer.IsRegionCpuModified(c, SIZE));
+    REQUIRE(buffer.ModifiedCpuRegion(c, SIZE) == Range{0, 0});
+
+    static constexpr std::array<u64, 4> offsets{PAGE * 5, WORD * 64 + PAGE * 63, WORD * 1000,
+                                                SIZE - PAGE};
+    for (const u64 offset : offsets) {
+        buffer.MarkRegionAsCpuModified(c + offset, PAGE);
+    }
+    REQUIRE(buffer.IsRegionCpuModified(c, SIZE));
+    REQUIRE(buffer.IsRegionCpuModified(c + WORD * 900, WORD * 200));
+    REQUIRE(!buffer.IsRegionCpuModified(c + WORD * 2, WORD * 61));
+    REQUIRE(!buffer.IsRegionCpuModified(c + WORD * 1001, SIZE - WORD * 1003));
+    REQUIRE(buffer.ModifiedCpuRegion(c, SIZE) == Range{PAGE * 5, SIZE});
+    REQUIRE(buffer.ModifiedCpuRegion(c + WORD * 2, WORD * 1000) ==
+            Range{WORD * 64 + PAGE * 63, WORD * 1000 + PAGE});
+
+    size_t num_ranges = 0;
+    buffer.ForEachUploadRange(c, SIZE, [&](u64 offset, u64 size) {
+        REQUIRE(offset == offsets.at(num_ranges));
+        REQUIRE(size == PAGE);
+        ++num_ranges;
+    });
+    REQUIRE(num_ranges == offsets.size());
+    REQUIRE(!buffer.IsRegionCpuModified(c, SIZE));
+    REQUIRE(rasterizer.Count() == SIZE / PAGE);
+}
+
+TEST_CASE("BufferBase: Contiguous range across huge buffer words", "[video_core]") {
+    RasterizerInterface rasterizer;
+    constexpr u64 SIZE = WORD * 64 * 4;
+    BufferBase buffer(rasterizer, c, SIZE);
+    buffer.UnmarkRegionAsCpuModified(c, SIZE);
+    buffer.MarkRegionAsCpuModified(c + WORD * 63 + PAGE * 60, WORD * 2);
+    buffer.MarkRegionAsCpuModified(c + WORD * 200, PAGE);
+
+    int num_ranges = 0;
+    buffer.ForEachUploadRange(c + WORD * 64, SIZE, [&](u64 offset, u64 size) {
+        static constexpr std::array<u64, 2> range_offsets{WORD * 64, WORD * 200};
+        static constexpr std::array<u64, 2> sizes{WORD + PAGE * 60, PAGE};
+        REQUIRE(offset == range_offsets.at(num_ranges));
+        REQUIRE(size == sizes.at(num_ranges));
+        ++num_ranges;
+    });
+    REQUIRE(num_ranges == 2);
+    REQUIRE(buffer.IsRegionCpuModified(c + WORD * 63, WORD));
+    REQUIRE(!buffer.IsRegionCpuModified(c + WORD * 64, SIZE - WORD * 64));
+}
+
+TEST_CASE("BufferBase: GPU pages in huge buffer", "[video_core]") {
+    RasterizerInterface rasterizer;
+    constexpr u64 SIZE = WORD * 64 * 8;
+    BufferBase buffer(rasterizer, c, SIZE);
+    buffer.UnmarkRegionAsCpuModified(c, SIZE);
+    REQUIRE(!buffer.IsRegionGpuModified(c, SIZE));
+
+    buffer.MarkRegionAsGpuModified(c + WORD * 100, PAGE * 2);
+    buffer.MarkRegionAsGpuModified(c + WORD * 400, PAGE);
+    buffer.MarkRegionAsCpuModified(c + WORD * 400, PAGE);
+    REQUIRE(buffer.IsRegionGpuModified(c, SIZE));
+    REQUIRE(!buffer.IsRegionGpuModified(c + WORD * 400, PAGE));
+    REQUIRE(buffer.ModifiedGpuRegion(c, SIZE) == Range{WORD * 100, WORD * 100 + PAGE * 2});
+
+    int num_ranges = 0;
+    buffer.ForEachDownloadRange([&](u64 offset, u64 size) {
+        REQUIRE(offset == WORD * 100);
+        REQUIRE(size == PAGE * 2);
+        ++num_ranges;
+    });
+    REQUIRE(num_ranges == 1);
+    REQUIRE(!buffer.IsRegionGpuModified(c, SIZE));
+}
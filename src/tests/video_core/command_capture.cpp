@@ -0,0 +1,104 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "core/core.h"
+#include "video_core/command_capture.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/memory_manager.h"
+
+namespace {
+using Tegra::CaptureMapRecord;
+using Tegra::CaptureRecord;
+using Tegra::CaptureRecordType;
+using Tegra::CaptureUnmapRecord;
+
+std::string MakeTempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/// Records an allocation, a submission and an unmap through a recorder writing to path
+void RecordCapture(const std::string& path, const std::vector<u32>& words) {
+    Core::System& system = Core::System::GetInstance();
+    Tegra::MemoryManager memory_manager(system);
+    Tegra::CommandRecorder recorder(system.Memory(), path);
+
+    std::vector<Tegra::CommandHeader> headers(words.size());
+    std::memcpy(headers.data(), words.data(), words.size() * sizeof(u32));
+
+    recorder.RecordMap(0x10000, 0, 0x2000);
+    recorder.RecordSubmit(memory_manager, Tegra::CommandList{std::move(headers)});
+
+    // Writes and submissions while paused are not part of the capture
+    recorder.SetPaused(true);
+    recorder.OnCPUWrite(0x10000, 0x1000);
+    recorder.RecordSubmit(memory_manager, Tegra::CommandList{});
+    recorder.SetPaused(false);
+
+    recorder.RecordUnmap(0x10000, 0, 0x2000);
+}
+
+template <typename T>
+T ReadPayload(const CaptureRecord& record) {
+    REQUIRE(record.payload.size() == sizeof(T));
+    T value;
+    std::memcpy(&value, record.payload.data(), sizeof(T));
+    return value;
+}
+} // Anonymous namespace
+
+TEST_CASE("CommandCapture: Round trip", "[video_core]") {
+    const std::string path = MakeTempPath("yuzu_command_capture_round_trip.bin");
+    const std::vector<u32> words{0x20018000, 0x00001234, 0x2001c040, 0xdeadbeef};
+    RecordCapture(path, words);
+
+    const std::optional<Tegra::Capture> capture = Tegra::ReadCapture(path);
+    REQUIRE(capture);
+    REQUIRE(capture->records.size() == 3);
+
+    REQUIRE(capture->records[0].type == CaptureRecordType::Map);
+    const auto map = ReadPayload<CaptureMapRecord>(capture->records[0]);
+    REQUIRE(map.gpu_addr == 0x10000);
+    REQUIRE(map.cpu_addr == 0);
+    REQUIRE(map.size == 0x2000);
+
+    REQUIRE(capture->records[1].type == CaptureRecordType::Submit);
+    const std::span<const u8> payload = capture->records[1].payload;
+    REQUIRE(payload.size() == words.size() * sizeof(u32));
+    REQUIRE(std::memcmp(payload.data(), words.data(), payload.size()) == 0);
+
+    REQUIRE(capture->records[2].type == CaptureRecordType::Unmap);
+    const auto unmap = ReadPayload<CaptureUnmapRecord>(capture->records[2]);
+    REQUIRE(unmap.gpu_addr == 0x10000);
+    REQUIRE(unmap.size == 0x2000);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("CommandCapture: Truncated capture", "[video_core]") {
+    const std::string path = MakeTempPath("yuzu_command_capture_truncated.bin");
+    RecordCapture(path, {0x20018000, 0x00001234});
+    {
+        // Leave a partial record header at the end, like a capture interrupted while writing
+        Common::FS::IOFile file(path, "ab");
+        REQUIRE(file.IsOpen());
+        const u32 partial_header = static_cast<u32>(CaptureRecordType::Memory);
+        REQUIRE(file.WriteObject(partial_header) == 1);
+    }
+    const std::optional<Tegra::Capture> capture = Tegra::ReadCapture(path);
+    REQUIRE(capture);
+    REQUIRE(capture->records.size() == 3);
+    REQUIRE(capture->records.back().type == CaptureRecordType::Unmap);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,271 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <span>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "video_core/surface.h"
+#include "video_core/texture_cache/decode_bc.h"
+#include "video_core/texture_cache/types.h"
+
+namespace {
+using VideoCore::Surface::PixelFormat;
+
+using Texel = std::array<u8, 4>;
+
+constexpr Texel BLACK{0, 0, 0, 0xff};
+constexpr Texel TRANSPARENT{0, 0, 0, 0};
+constexpr Texel RED{0xff, 0, 0, 0xff};
+constexpr Texel GREEN{0, 0xff, 0, 0xff};
+constexpr Texel BLUE{0, 0, 0xff, 0xff};
+
+/// Decodes a single 4x4 block and returns its texels in row major order
+template <size_t N>
+std::array<Texel, 16> DecodeBlock(PixelFormat format, const std::array<u8, N>& block) {
+    std::array<Texel, 16> texels{};
+    VideoCommon::DecompressBCn(block, VideoCommon::Extent3D{4, 4, 1}, format,
+                               std::span(texels.front().data(), sizeof(texels)));
+    return texels;
+}
+
+// Blocks are packed following the bit layouts of the S3TC, RGTC and BPTC specifications.
+// Expected texels are derived from the interpolation rules of each format.
+
+// color0 = 0xf800 (red), color1 = 0x001f (blue), indices 0, 1, 2, 3 repeated
+constexpr std::array<u8, 8> BC1_FOUR_COLORS{0x00, 0xf8, 0x1f, 0x00, 0xe4, 0xe4, 0xe4, 0xe4};
+
+// color0 = 0x001f (blue) <= color1 = 0xf800 (red), selecting the punchthrough palette
+constexpr std::array<u8, 8> BC1_THREE_COLORS{0x1f, 0x00, 0x00, 0xf8, 0xe4, 0xe4, 0xe4, 0xe4};
+} // Anonymous namespace
+
+TEST_CASE("DecodeBC: BC1 four colors", "[video_core]") {
+    constexpr std::array<Texel, 4> palette{{
+        RED,
+        BLUE,
+        {170, 0, 85, 0xff},
+        {85, 0, 170, 0xff},
+    }};
+    const auto texels = DecodeBlock(PixelFormat::BC1_RGBA_UNORM, BC1_FOUR_COLORS);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        REQUIRE(texels[texel] == palette[texel % 4]);
+    }
+}
+
+TEST_CASE("DecodeBC: BC1 three colors and punchthrough alpha", "[video_core]") {
+    constexpr std::array<Texel, 4> palette{{
+        BLUE,
+        RED,
+        {127, 0, 127, 0xff},
+        TRANSPARENT,
+    }};
+    const auto texels = DecodeBlock(PixelFormat::BC1_RGBA_UNORM, BC1_THREE_COLORS);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        REQUIRE(texels[texel] == palette[texel % 4]);
+    }
+}
+
+TEST_CASE("DecodeBC: Unaligned extent", "[video_core]") {
+    std::array<Texel, 4> texels{};
+    VideoCommon::DecompressBCn(BC1_FOUR_COLORS, VideoCommon::Extent3D{2, 2, 1},
+                               PixelFormat::BC1_RGBA_UNORM,
+                               std::span(texels.front().data(), sizeof(texels)));
+    REQUIRE(texels[0] == RED);
+    REQUIRE(texels[1] == BLUE);
+    REQUIRE(texels[2] == RED);
+    REQUIRE(texels[3] == BLUE);
+}
+
+TEST_CASE("DecodeBC: BC2", "[video_core]") {
+    // Explicit alpha of texel i is i, white color
+    constexpr std::array<u8, 16> block{0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+                                       0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00};
+    const auto texels = DecodeBlock(PixelFormat::BC2_UNORM, block);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        const Texel expected{0xff, 0xff, 0xff, static_cast<u8>(texel * 0x11)};
+        REQUIRE(texels[texel] == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC3", "[video_core]") {
+    // alpha0 = 255 > alpha1 = 0, indices 0 to 7 repeated, green color
+    constexpr std::array<u8, 16> block{0xff, 0x00, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa,
+                                       0xe0, 0x07, 0xe0, 0x07, 0x00, 0x00, 0x00, 0x00};
+    constexpr std::array<u8, 8> alpha{255, 0, 218, 182, 145, 109, 72, 36};
+    const auto texels = DecodeBlock(PixelFormat::BC3_UNORM, block);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        const Texel expected{0, 0xff, 0, alpha[texel % 8]};
+        REQUIRE(texels[texel] == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC4", "[video_core]") {
+    // red0 = 0 <= red1 = 255, six interpolated values plus 0 and 255
+    constexpr std::array<u8, 8> block{0x00, 0xff, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa};
+    constexpr std::array<u8, 8> red{0, 255, 51, 102, 153, 204, 0, 255};
+    const auto texels = DecodeBlock(PixelFormat::BC4_UNORM, block);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        const Texel expected{red[texel % 8], 0, 0, 0xff};
+        REQUIRE(texels[texel] == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC5", "[video_core]") {
+    // red0 = 200 > red1 = 100, green0 = 10 <= green1 = 20
+    constexpr std::array<u8, 16> block{0xc8, 0x64, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa,
+                                       0x0a, 0x14, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa};
+    constexpr std::array<u8, 8> red{200, 100, 185, 171, 157, 142, 128, 114};
+    constexpr std::array<u8, 8> green{10, 20, 12, 14, 16, 18, 0, 255};
+    const auto texels = DecodeBlock(PixelFormat::BC5_UNORM, block);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        const Texel expected{red[texel % 8], green[texel % 8], 0, 0xff};
+        REQUIRE(texels[texel] == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC4 signed", "[video_core]") {
+    // red0 = -128 (read as -127) <= red1 = 127, six interpolated values plus -127 and 127.
+    // Texels are signed normalized, so one is 0x7f and -1 is 0x81.
+    constexpr std::array<u8, 8> block{0x80, 0x7f, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa};
+    constexpr std::array<u8, 8> red{0x81, 0x7f, 0xb4, 0xe7, 0x19, 0x4c, 0x81, 0x7f};
+    const auto texels = DecodeBlock(PixelFormat::BC4_SNORM, block);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        const Texel expected{red[texel % 8], 0, 0, 0x7f};
+        REQUIRE(texels[texel] == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC5 signed", "[video_core]") {
+    // red0 = 100 > red1 = -100, green0 = -128 and green1 = -127 are both read as -127
+    constexpr std::array<u8, 16> block{0x64, 0x9c, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa,
+                                       0x80, 0x81, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa};
+    constexpr std::array<u8, 8> red{0x64, 0x9c, 0x47, 0x2a, 0x0e, 0xf2, 0xd6, 0xb9};
+    constexpr std::array<u8, 8> green{0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0x7f};
+    const auto texels = DecodeBlock(PixelFormat::BC5_SNORM, block);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        const Texel expected{red[texel % 8], green[texel % 8], 0, 0x7f};
+        REQUIRE(texels[texel] == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC6H unsigned mode 11", "[video_core]") {
+    // Untransformed 10-bit endpoints: red 1023 to 1023, green 0 to 1023, blue 462 to 462.
+    // Indices of the first five texels are 0, 1, 4, 7 and 15, the rest are 0.
+    constexpr std::array<u8, 16> block{0xe3, 0x7f, 0x00, 0x9c, 0xfb, 0xff, 0x7f, 0xe7,
+                                       0x10, 0x74, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00};
+    constexpr std::array<u8, 5> green{0, 0, 2, 195, 255};
+    const auto texels = DecodeBlock(PixelFormat::BC6H_UFLOAT, block);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        const Texel expected{0xff, texel < green.size() ? green[texel] : u8{0}, 128, 0xff};
+        REQUIRE(texels[texel] == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC6H unsigned mode 12", "[video_core]") {
+    // Transformed 11-bit endpoints: red 1000 with a delta of -100, green and blue 0.
+    // The first texel selects the first endpoint, the rest select the second one.
+    constexpr std::array<u8, 16> block{0x07, 0x7d, 0x00, 0x00, 0xe0, 0x0c, 0x00, 0x00,
+                                       0xf0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    const auto texels = DecodeBlock(PixelFormat::BC6H_UFLOAT, block);
+    constexpr Texel expected{104, 0, 0, 0xff};
+    REQUIRE(texels[0] == RED);
+    for (size_t texel = 1; texel < texels.size(); ++texel) {
+        REQUIRE(texels[texel] == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC6H unsigned reserved mode", "[video_core]") {
+    std::array<u8, 16> block{};
+    block[0] = 0x13;
+    const auto texels = DecodeBlock(PixelFormat::BC6H_UFLOAT, block);
+    for (const Texel& texel : texels) {
+        REQUIRE(texel == BLACK);
+    }
+}
+
+TEST_CASE("DecodeBC: BC6H signed", "[video_core]") {
+    // Mode 11 with both endpoints set to red -5, green 511 and blue 231.
+    // Negative values are clamped to zero and 511 saturates to one.
+    constexpr std::array<u8, 16> block{0x63, 0xff, 0xff, 0xce, 0xd9, 0xff, 0xbf, 0x73,
+                                       0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    constexpr Texel expected{0, 0xff, 130, 0xff};
+    const auto texels = DecodeBlock(PixelFormat::BC6H_SFLOAT, block);
+    for (const Texel& texel : texels) {
+        REQUIRE(texel == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC7 mode 6", "[video_core]") {
+    // Single subset, endpoints 0 and 127 with p-bits 0 and 1, texel i has index i
+    constexpr std::array<u8, 16> block{0x40, 0xc0, 0x1f, 0xf0, 0x07, 0xfc, 0x01, 0x7f,
+                                       0x11, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe};
+    constexpr std::array<u8, 16> values{0,   16,  36,  52,  68,  84,  104, 120,
+                                        135, 151, 171, 187, 203, 219, 239, 255};
+    const auto texels = DecodeBlock(PixelFormat::BC7_UNORM, block);
+    for (size_t texel = 0; texel < texels.size(); ++texel) {
+        const u8 value = values[texel];
+        const Texel expected{value, value, value, value};
+        REQUIRE(texels[texel] == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC7 mode 1 two subsets", "[video_core]") {
+    // Partition 0, the first subset is solid red and the second one is a blue gradient.
+    // The anchor texel of the second subset (15) has a 2-bit index.
+    constexpr std::array<u8, 16> block{0x02, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                       0x00, 0xfc, 0x90, 0x88, 0x1d, 0x91, 0x9a, 0xfd};
+    constexpr Texel solid{253, 0, 0, 0xff};
+    const std::array<Texel, 16> expected{{
+        solid,
+        solid,
+        {0, 0, 36, 0xff},
+        {0, 0, 71, 0xff},
+        solid,
+        solid,
+        {0, 0, 107, 0xff},
+        {0, 0, 146, 0xff},
+        solid,
+        solid,
+        {0, 0, 182, 0xff},
+        {0, 0, 217, 0xff},
+        solid,
+        solid,
+        {0, 0, 253, 0xff},
+        {0, 0, 107, 0xff},
+    }};
+    REQUIRE(DecodeBlock(PixelFormat::BC7_UNORM, block) == expected);
+}
+
+TEST_CASE("DecodeBC: BC7 mode 2 three subsets", "[video_core]") {
+    // Partition 0 with solid red, green and blue subsets
+    constexpr std::array<u8, 16> block{0x04, 0xfe, 0x07, 0x00, 0x00, 0x00, 0xfe, 0x07,
+                                       0x00, 0x00, 0x00, 0xfe, 0xaf, 0x55, 0x55, 0xd5};
+    const std::array<Texel, 16> expected{
+        RED, RED,  GREEN, GREEN, RED,  RED,  GREEN, GREEN,
+        RED, BLUE, BLUE,  GREEN, BLUE, BLUE, BLUE,  BLUE,
+    };
+    REQUIRE(DecodeBlock(PixelFormat::BC7_UNORM, block) == expected);
+}
+
+TEST_CASE("DecodeBC: BC7 mode 5 rotation", "[video_core]") {
+    // Red color and 0x40 alpha, rotation 1 swaps the red and alpha channels
+    constexpr std::array<u8, 16> block{0x60, 0xff, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x01,
+                                       0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    constexpr Texel expected{0x40, 0, 0, 0xff};
+    const auto texels = DecodeBlock(PixelFormat::BC7_UNORM, block);
+    for (const Texel& texel : texels) {
+        REQUIRE(texel == expected);
+    }
+}
+
+TEST_CASE("DecodeBC: BC7 reserved mode", "[video_core]") {
+    std::array<u8, 16> block{};
+    block[8] = 0xff;
+    const auto texels = DecodeBlock(PixelFormat::BC7_UNORM, block);
+    for (const Texel& texel : texels) {
+        REQUIRE(texel == TRANSPARENT);
+    }
+}
@@ -0,0 +1,264 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_hle.h"
+#include "video_core/macro/macro_interpreter.h"
+#include "video_core/memory_manager.h"
+
+namespace {
+using Tegra::Engines::Maxwell3D;
+using Tegra::Macro::ALUOperation;
+using Tegra::Macro::BranchCondition;
+using Tegra::Macro::Opcode;
+using Tegra::Macro::Operation;
+using Tegra::Macro::ResultOperation;
+
+// Hash that doesn't match any of the hand written HLE macros
+constexpr u64 UNKNOWN_HASH = 0;
+
+// Sets the method address register with an increment of one method per send
+constexpr s32 MethodAddress(s32 method) {
+    return method | (1 << 12);
+}
+
+Opcode MakeAddImmediate(ResultOperation result_operation, u32 dst, u32 src_a, s32 immediate) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::AddImmediate);
+    opcode.result_operation.Assign(result_operation);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(immediate);
+    return opcode;
+}
+
+Opcode MakeALU(ResultOperation result_operation, ALUOperation alu_operation, u32 dst, u32 src_a,
+               u32 src_b) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::ALU);
+    opcode.result_operation.Assign(result_operation);
+    opcode.alu_operation.Assign(alu_operation);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.src_b.Assign(src_b);
+    return opcode;
+}
+
+Opcode MakeExtract(ResultOperation result_operation, u32 dst, u32 src, u32 bit, u32 size) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::ExtractInsert);
+    opcode.result_operation.Assign(result_operation);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(0);
+    opcode.src_b.Assign(src);
+    opcode.bf_src_bit.Assign(bit);
+    opcode.bf_size.Assign(size);
+    opcode.bf_dst_bit.Assign(0);
+    return opcode;
+}
+
+Opcode MakeRead(u32 dst, u32 src_a, s32 immediate) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::Read);
+    opcode.result_operation.Assign(ResultOperation::Move);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(immediate);
+    return opcode;
+}
+
+Opcode MakeBranch(BranchCondition condition, u32 src_a, s32 offset) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::Branch);
+    opcode.branch_condition.Assign(condition);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(offset);
+    return opcode;
+}
+
+/// Appends an exit and its delay slot
+void AppendExit(std::vector<u32>& code) {
+    Opcode exit = MakeAddImmediate(ResultOperation::Move, 0, 0, 0);
+    exit.is_exit.Assign(1);
+    code.push_back(exit.raw);
+    code.push_back(MakeAddImmediate(ResultOperation::Move, 0, 0, 0).raw);
+}
+
+/// Binds a const buffer of size params[0] at address params[1]:params[2] to the vertex stage,
+/// with the valid bit and index from params[3]
+std::vector<u32> MakeBindConstBufferMacro() {
+    const s32 cb_size = static_cast<s32>(MAXWELL3D_REG_INDEX(const_buffer.cb_size));
+    const s32 cb_bind = static_cast<s32>(MAXWELL3D_REG_INDEX(cb_bind[0]));
+    std::vector<u32> code{
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, MethodAddress(cb_size)).raw,
+        MakeAddImmediate(ResultOperation::FetchAndSend, 2, 1, 0).raw,
+        MakeAddImmediate(ResultOperation::FetchAndSend, 3, 2, 0).raw,
+        MakeALU(ResultOperation::IgnoreAndFetch, ALUOperation::Add, 4, 0, 0).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSend, 0, 3, 0).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, MethodAddress(cb_bind)).raw,
+        MakeExtract(ResultOperation::Move, 5, 4, 0, 9).raw,
+        MakeAddImmediate(ResultOperation::Move, 6, 0, 0x1f1).raw,
+        MakeALU(ResultOperation::MoveAndSend, ALUOperation::And, 0, 5, 6).raw,
+    };
+    AppendExit(code);
+    return code;
+}
+
+/// Writes the clear color from params[0..3] with a constant loop, the depth masked from the
+/// current depth register and the stencil from params[4]
+std::vector<u32> MakeClearValuesMacro() {
+    const s32 clear_color = static_cast<s32>(MAXWELL3D_REG_INDEX(clear_color[0]));
+    const s32 clear_depth = static_cast<s32>(MAXWELL3D_REG_INDEX(clear_depth));
+    std::vector<u32> code{
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, MethodAddress(clear_color)).raw,
+        MakeAddImmediate(ResultOperation::Move, 2, 0, 3).raw,
+        // loop: send the current parameter and fetch the next one
+        MakeAddImmediate(ResultOperation::FetchAndSend, 1, 1, 0).raw,
+        MakeAddImmediate(ResultOperation::Move, 2, 2, -1).raw,
+        MakeBranch(BranchCondition::NotZero, 2, -2).raw,
+        MakeAddImmediate(ResultOperation::Move, 0, 0, 0).raw,
+        MakeAddImmediate(ResultOperation::FetchAndSend, 5, 1, 0).raw,
+        MakeRead(3, 0, clear_depth).raw,
+        MakeAddImmediate(ResultOperation::Move, 4, 0, 0xffff).raw,
+        MakeALU(ResultOperation::MoveAndSend, ALUOperation::And, 3, 3, 4).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0,
+                         MethodAddress(static_cast<s32>(MAXWELL3D_REG_INDEX(clear_stencil))))
+            .raw,
+        MakeAddImmediate(ResultOperation::MoveAndSend, 0, 5, 0).raw,
+    };
+    AppendExit(code);
+    return code;
+}
+
+/// Draws params[1] vertices from params[2] with the topology in the low bits of params[0]
+std::vector<u32> MakeDrawArraysMacro() {
+    const s32 vertex_begin = static_cast<s32>(MAXWELL3D_REG_INDEX(draw.vertex_begin_gl));
+    const s32 vertex_end = static_cast<s32>(MAXWELL3D_REG_INDEX(draw.vertex_end_gl));
+    const s32 first = static_cast<s32>(MAXWELL3D_REG_INDEX(vertex_buffer.first));
+    std::vector<u32> code{
+        MakeALU(ResultOperation::IgnoreAndFetch, ALUOperation::Add, 2, 0, 0).raw,
+        MakeALU(ResultOperation::IgnoreAndFetch, ALUOperation::Add, 3, 0, 0).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, MethodAddress(first)).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSend, 0, 3, 0).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, MethodAddress(vertex_begin)).raw,
+        MakeExtract(ResultOperation::MoveAndSend, 0, 1, 0, 16).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0,
+                         MethodAddress(static_cast<s32>(MAXWELL3D_REG_INDEX(vertex_buffer.count))))
+            .raw,
+        MakeAddImmediate(ResultOperation::MoveAndSend, 0, 2, 0).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, MethodAddress(vertex_end)).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSend, 0, 0, 0).raw,
+    };
+    AppendExit(code);
+    return code;
+}
+
+/// Counts params[0] down to zero, the number of iterations is only known at runtime
+std::vector<u32> MakeDynamicLoopMacro() {
+    std::vector<u32> code{
+        MakeAddImmediate(ResultOperation::Move, 2, 1, 0).raw,
+        MakeAddImmediate(ResultOperation::Move, 2, 2, -1).raw,
+        MakeBranch(BranchCondition::NotZero, 2, -1).raw,
+        MakeAddImmediate(ResultOperation::Move, 0, 0, 0).raw,
+    };
+    AppendExit(code);
+    return code;
+}
+
+bool operator==(const Maxwell3D::MMEDrawState& lhs, const Maxwell3D::MMEDrawState& rhs) {
+    return lhs.current_mode == rhs.current_mode && lhs.current_count == rhs.current_count &&
+           lhs.instance_count == rhs.instance_count && lhs.instance_mode == rhs.instance_mode &&
+           lhs.gl_begin_consume == rhs.gl_begin_consume && lhs.gl_end_count == rhs.gl_end_count;
+}
+
+bool operator==(const Maxwell3D::State& lhs, const Maxwell3D::State& rhs) {
+    for (std::size_t stage = 0; stage < lhs.shader_stages.size(); ++stage) {
+        const auto& lhs_buffers = lhs.shader_stages[stage].const_buffers;
+        const auto& rhs_buffers = rhs.shader_stages[stage].const_buffers;
+        for (std::size_t index = 0; index < lhs_buffers.size(); ++index) {
+            if (lhs_buffers[index].enabled != rhs_buffers[index].enabled ||
+                lhs_buffers[index].address != rhs_buffers[index].address ||
+                lhs_buffers[index].size != rhs_buffers[index].size) {
+                return false;
+            }
+        }
+    }
+    return lhs.current_instance == rhs.current_instance;
+}
+
+/// Executes a macro with the interpreter and its HLE replacement on separate engines, and checks
+/// that both leave the engines in the same state
+void RunDifferentialTest(const std::vector<u32>& code,
+                         const std::vector<std::vector<u32>>& parameter_sets) {
+    Core::System& system = Core::System::GetInstance();
+    Tegra::MemoryManager memory_manager(system);
+    const auto interpreted = std::make_unique<Maxwell3D>(system, memory_manager);
+    const auto replaced = std::make_unique<Maxwell3D>(system, memory_manager);
+
+    auto hle_program = Tegra::HLEMacro(*replaced).GetHLEProgram(UNKNOWN_HASH, code);
+    REQUIRE(hle_program.has_value());
+    Tegra::MacroInterpreterImpl interpreter(*interpreted, code);
+
+    u32 seed = 0x1234;
+    for (const std::vector<u32>& parameters : parameter_sets) {
+        // Registers read by the macros start with the same garbage on both engines
+        for (u32& value : interpreted->regs.reg_array) {
+            seed = seed * 1103515245 + 12345;
+            value = seed;
+        }
+        replaced->regs = interpreted->regs;
+
+        interpreter.Execute(parameters, 0);
+        (*hle_program)->Execute(parameters, 0);
+
+        REQUIRE(std::memcmp(&interpreted->regs, &replaced->regs, sizeof(Maxwell3D::Regs)) == 0);
+        REQUIRE(interpreted->mme_draw == replaced->mme_draw);
+        REQUIRE(interpreted->state == replaced->state);
+
+        interpreted->mme_draw = {};
+        replaced->mme_draw = {};
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("MacroHLE: Const buffer bind", "[video_core]") {
+    RunDifferentialTest(MakeBindConstBufferMacro(), {
+                                                        {0x10000, 0x1, 0x2000, 0x31},
+                                                        {0x100, 0x0, 0xdead0000, 0xf0},
+                                                        {0xffffffff, 0xff, 0x0, 0x111},
+                                                    });
+}
+
+TEST_CASE("MacroHLE: Clear values", "[video_core]") {
+    RunDifferentialTest(MakeClearValuesMacro(), {
+                                                    {0x3f800000, 0x0, 0x3f000000, 0x0, 0xff},
+                                                    {0x1, 0x2, 0x3, 0x4, 0x5},
+                                                });
+}
+
+TEST_CASE("MacroHLE: Draw arrays", "[video_core]") {
+    RunDifferentialTest(MakeDrawArraysMacro(), {
+                                                   {0x4, 0x300, 0x0},
+                                                   {0x10005, 0x3, 0x10},
+                                               });
+}
+
+TEST_CASE("MacroHLE: Data dependent loops are not replaced", "[video_core]") {
+    Core::System& system = Core::System::GetInstance();
+    Tegra::MemoryManager memory_manager(system);
+    Maxwell3D maxwell3d(system, memory_manager);
+
+    const Tegra::HLEMacro hle(maxwell3d);
+    REQUIRE(!hle.GetHLEProgram(UNKNOWN_HASH, MakeDynamicLoopMacro()).has_value());
+}
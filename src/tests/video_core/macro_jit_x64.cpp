@@ -0,0 +1,214 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef ARCHITECTURE_x86_64
+
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "core/core.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_interpreter.h"
+#include "video_core/macro/macro_jit_x64.h"
+#include "video_core/memory_manager.h"
+
+namespace {
+using Tegra::Engines::Maxwell3D;
+using Tegra::Macro::ALUOperation;
+using Tegra::Macro::BranchCondition;
+using Tegra::Macro::Opcode;
+using Tegra::Macro::Operation;
+using Tegra::Macro::ResultOperation;
+
+// Sets the method address register with an increment of one method per send
+constexpr s32 MethodAddress(s32 method) {
+    return method | (1 << 12);
+}
+
+// Sends of the macros below go to the clear color registers, writing them has no side effects
+const s32 CLEAR_COLOR = static_cast<s32>(MAXWELL3D_REG_INDEX(clear_color[0]));
+
+Opcode MakeAddImmediate(ResultOperation result_operation, u32 dst, u32 src_a, s32 immediate) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::AddImmediate);
+    opcode.result_operation.Assign(result_operation);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(immediate);
+    return opcode;
+}
+
+Opcode MakeALU(ResultOperation result_operation, ALUOperation alu_operation, u32 dst, u32 src_a,
+               u32 src_b) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::ALU);
+    opcode.result_operation.Assign(result_operation);
+    opcode.alu_operation.Assign(alu_operation);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.src_b.Assign(src_b);
+    return opcode;
+}
+
+Opcode MakeBitfield(Operation operation, ResultOperation result_operation, u32 dst, u32 src_a,
+                    u32 src_b, u32 src_bit, u32 size, u32 dst_bit) {
+    Opcode opcode{};
+    opcode.operation.Assign(operation);
+    opcode.result_operation.Assign(result_operation);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.src_b.Assign(src_b);
+    opcode.bf_src_bit.Assign(src_bit);
+    opcode.bf_size.Assign(size);
+    opcode.bf_dst_bit.Assign(dst_bit);
+    return opcode;
+}
+
+Opcode MakeRead(u32 dst, u32 src_a, s32 immediate) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::Read);
+    opcode.result_operation.Assign(ResultOperation::Move);
+    opcode.dst.Assign(dst);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(immediate);
+    return opcode;
+}
+
+Opcode MakeBranch(BranchCondition condition, u32 src_a, s32 offset) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::Branch);
+    opcode.branch_condition.Assign(condition);
+    opcode.src_a.Assign(src_a);
+    opcode.immediate.Assign(offset);
+    return opcode;
+}
+
+/// Appends an exit and its delay slot
+void AppendExit(std::vector<u32>& code) {
+    Opcode exit = MakeAddImmediate(ResultOperation::Move, 0, 0, 0);
+    exit.is_exit.Assign(1);
+    code.push_back(exit.raw);
+    code.push_back(MakeAddImmediate(ResultOperation::Move, 0, 0, 0).raw);
+}
+
+/// Computes values from constants only, with a branch that is never taken and one that always is
+std::vector<u32> MakeConstantMacro() {
+    std::vector<u32> code{
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, MethodAddress(CLEAR_COLOR)).raw,
+        MakeAddImmediate(ResultOperation::Move, 2, 0, 0x1234).raw,
+        MakeAddImmediate(ResultOperation::Move, 3, 2, -0x34).raw,
+        MakeALU(ResultOperation::MoveAndSend, ALUOperation::Add, 4, 2, 3).raw,
+        MakeBitfield(Operation::ExtractInsert, ResultOperation::MoveAndSend, 5, 3, 2, 4, 8, 16)
+            .raw,
+        MakeBranch(BranchCondition::Zero, 2, 3).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSend, 6, 5, 1).raw,
+        MakeBranch(BranchCondition::NotZero, 3, 2).raw,
+        MakeAddImmediate(ResultOperation::Move, 7, 0, 7).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSend, 0, 7, 0).raw,
+    };
+    AppendExit(code);
+    return code;
+}
+
+/// Takes a different path depending on the low bits of params[0], then sends fetched parameters
+std::vector<u32> MakeFirstParameterMacro() {
+    std::vector<u32> code{
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, MethodAddress(CLEAR_COLOR)).raw,
+        MakeBitfield(Operation::ExtractInsert, ResultOperation::Move, 2, 0, 1, 0, 4, 0).raw,
+        MakeBranch(BranchCondition::Zero, 2, 4).raw,
+        MakeAddImmediate(ResultOperation::Move, 3, 1, 0x10).raw,
+        MakeAddImmediate(ResultOperation::MoveAndSend, 0, 3, 1).raw,
+        MakeAddImmediate(ResultOperation::FetchAndSend, 4, 2, 0).raw,
+        MakeAddImmediate(ResultOperation::FetchAndSend, 5, 3, 0).raw,
+        MakeALU(ResultOperation::MoveAndSend, ALUOperation::Add, 0, 5, 1).raw,
+    };
+    AppendExit(code);
+    return code;
+}
+
+/// Shifts fields of params[0] by amounts read from the engine registers
+std::vector<u32> MakeShiftMacro() {
+    const s32 clear_depth = static_cast<s32>(MAXWELL3D_REG_INDEX(clear_depth));
+    std::vector<u32> code{
+        MakeAddImmediate(ResultOperation::MoveAndSetMethod, 0, 0, MethodAddress(CLEAR_COLOR)).raw,
+        MakeRead(2, 0, clear_depth).raw,
+        MakeBitfield(Operation::ExtractInsert, ResultOperation::Move, 2, 0, 2, 0, 4, 0).raw,
+        MakeBitfield(Operation::ExtractShiftLeftImmediate, ResultOperation::MoveAndSend, 3, 2, 1,
+                     0, 6, 3)
+            .raw,
+        MakeBitfield(Operation::ExtractShiftLeftRegister, ResultOperation::MoveAndSend, 4, 2, 1,
+                     5, 7, 0)
+            .raw,
+        MakeALU(ResultOperation::MoveAndSend, ALUOperation::Xor, 5, 3, 4).raw,
+    };
+    AppendExit(code);
+    return code;
+}
+
+/// Executes a macro with the interpreter, the JIT and the JIT specialized for the first parameter
+/// on separate engines, and checks that all of them leave the engines in the same state
+void RunEquivalenceTest(const std::vector<u32>& code,
+                        const std::vector<std::vector<u32>>& parameter_sets) {
+    Core::System& system = Core::System::GetInstance();
+    Tegra::MemoryManager memory_manager(system);
+    const auto interpreted = std::make_unique<Maxwell3D>(system, memory_manager);
+    const auto compiled = std::make_unique<Maxwell3D>(system, memory_manager);
+    const auto specialized = std::make_unique<Maxwell3D>(system, memory_manager);
+
+    Tegra::MacroInterpreterImpl interpreter(*interpreted, code);
+    Tegra::MacroJITx64Impl jit(*compiled, code, std::nullopt);
+
+    u32 seed = 0x1234;
+    for (const std::vector<u32>& parameters : parameter_sets) {
+        // Registers read by the macros start with the same garbage on every engine
+        for (u32& value : interpreted->regs.reg_array) {
+            seed = seed * 1103515245 + 12345;
+            value = seed;
+        }
+        compiled->regs = interpreted->regs;
+        specialized->regs = interpreted->regs;
+
+        Tegra::MacroJITx64Impl specialized_jit(*specialized, code, parameters.front());
+        interpreter.Execute(parameters, 0);
+        jit.Execute(parameters, 0);
+        specialized_jit.Execute(parameters, 0);
+
+        REQUIRE(std::memcmp(&interpreted->regs, &compiled->regs, sizeof(Maxwell3D::Regs)) == 0);
+        REQUIRE(std::memcmp(&interpreted->regs, &specialized->regs, sizeof(Maxwell3D::Regs)) ==
+                0);
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("MacroJITx64: Constant folding", "[video_core]") {
+    RunEquivalenceTest(MakeConstantMacro(), {
+                                                {0x0},
+                                                {0xdeadbeef},
+                                            });
+}
+
+TEST_CASE("MacroJITx64: First parameter specialization", "[video_core]") {
+    RunEquivalenceTest(MakeFirstParameterMacro(), {
+                                                      {0x0, 0x11, 0x22},
+                                                      {0x30, 0x11, 0x22},
+                                                      {0x5, 0xffffffff, 0x7},
+                                                      {0xfffffff3, 0x1, 0x2},
+                                                  });
+}
+
+TEST_CASE("MacroJITx64: Register shifts", "[video_core]") {
+    RunEquivalenceTest(MakeShiftMacro(), {
+                                             {0x12345678},
+                                             {0xffffffff},
+                                             {0x0},
+                                         });
+}
+
+#endif
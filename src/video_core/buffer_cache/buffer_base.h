@@ -38,6 +38,7 @@ class BufferBase {
     static constexpr u64 PAGES_PER_WORD = 64;
     static constexpr u64 BYTES_PER_PAGE = Core::Memory::PAGE_SIZE;
     static constexpr u64 BYTES_PER_WORD = PAGES_PER_WORD * BYTES_PER_PAGE;
+    static constexpr u64 WORDS_PER_SUMMARY_WORD = 64;
 
     /// Vector tracking modified pages tightly packed with small vector optimization
     union WrittenWords {
@@ -61,14 +62,29 @@ class BufferBase {
             if (IsShort()) {
                 cpu.stack = ~u64{0};
                 gpu.stack = 0;
+                cpu_summary.stack = 1;
+                gpu_summary.stack = 0;
             } else {
-                // Share allocation between CPU and GPU pages and set their default values
+                // Share allocation between CPU and GPU pages and their summaries, then set their
+                // default values
                 const size_t num_words = NumWords();
-                u64* const alloc = new u64[num_words * 2];
+                const size_t num_summary_words = NumSummaryWords();
+                u64* const alloc = new u64[(num_words + num_summary_words) * 2];
                 cpu.heap = alloc;
                 gpu.heap = alloc + num_words;
+                cpu_summary.heap = alloc + num_words * 2;
+                gpu_summary.heap = alloc + num_words * 2 + num_summary_words;
                 std::fill_n(cpu.heap, num_words, ~u64{0});
                 std::fill_n(gpu.heap, num_words, 0);
+                std::fill_n(cpu_summary.heap, num_summary_words, ~u64{0});
+                std::fill_n(gpu_summary.heap, num_summary_words, 0);
+
+                // Clean up tailing summary bits
+                const u64 last_local_word = NumWords() % WORDS_PER_SUMMARY_WORD;
+                const u64 summary_shift =
+                    (WORDS_PER_SUMMARY_WORD - last_local_word) % WORDS_PER_SUMMARY_WORD;
+                u64& last_summary_word = cpu_summary.heap[num_summary_words - 1];
+                last_summary_word = (last_summary_word << summary_shift) >> summary_shift;
             }
             // Clean up tailing bits
             const u64 last_local_page =
@@ -87,12 +103,15 @@ class BufferBase {
             size_bytes = rhs.size_bytes;
             cpu = rhs.cpu;
             gpu = rhs.gpu;
+            cpu_summary = rhs.cpu_summary;
+            gpu_summary = rhs.gpu_summary;
             rhs.cpu.heap = nullptr;
             return *this;
         }
 
         GpuCpuWords(GpuCpuWords&& rhs) noexcept
-            : size_bytes{rhs.size_bytes}, cpu{rhs.cpu}, gpu{rhs.gpu} {
+            : size_bytes{rhs.size_bytes}, cpu{rhs.cpu}, gpu{rhs.gpu},
+              cpu_summary{rhs.cpu_summary}, gpu_summary{rhs.gpu_summary} {
             rhs.cpu.heap = nullptr;
         }
 
@@ -109,6 +128,11 @@ class BufferBase {
             return Common::DivCeil(size_bytes, BYTES_PER_WORD);
         }
 
+        /// Returns the number of summary words of the buffer
+        [[nodiscard]] size_t NumSummaryWords() const noexcept {
+            return Common::DivCeil(NumWords(), WORDS_PER_SUMMARY_WORD);
+        }
+
         /// Release buffer resources
         void Release() {
             if (!IsShort()) {
@@ -120,6 +144,8 @@ class BufferBase {
         u64 size_bytes = 0;
         WrittenWords cpu;
         WrittenWords gpu;
+        WrittenWords cpu_summary; ///< One bit per CPU word, set when the word is not zero
+        WrittenWords gpu_summary; ///< One bit per GPU word, set when the word is not zero
     };
 
 public:
@@ -160,22 +186,22 @@ public:
 
     /// Mark region as CPU modified, notifying the rasterizer about this change
     void MarkRegionAsCpuModified(VAddr dirty_cpu_addr, u64 size) {
-        ChangeRegionState<true, true>(words.cpu, dirty_cpu_addr, size);
+        ChangeRegionState<true, true>(words.cpu, words.cpu_summary, dirty_cpu_addr, size);
     }
 
     /// Unmark region as CPU modified, notifying the rasterizer about this change
     void UnmarkRegionAsCpuModified(VAddr dirty_cpu_addr, u64 size) {
-        ChangeRegionState<false, true>(words.cpu, dirty_cpu_addr, size);
+        ChangeRegionState<false, true>(words.cpu, words.cpu_summary, dirty_cpu_addr, size);
     }
 
     /// Mark region as modified from the host GPU
     void MarkRegionAsGpuModified(VAddr dirty_cpu_addr, u64 size) noexcept {
-        ChangeRegionState<true, false>(words.gpu, dirty_cpu_addr, size);
+        ChangeRegionState<true, false>(words.gpu, words.gpu_summary, dirty_cpu_addr, size);
     }
 
     /// Unmark region as modified from the host GPU
     void UnmarkRegionAsGpuModified(VAddr dirty_cpu_addr, u64 size) noexcept {
-        ChangeRegionState<false, false>(words.gpu, dirty_cpu_addr, size);
+        ChangeRegionState<false, false>(words.gpu, words.gpu_summary, dirty_cpu_addr, size);
     }
 
     /// Call 'func' for each CPU modified range and unmark those pages as CPU modified
@@ -237,6 +263,7 @@ private:
      * Change the state of a range of pages
      *
      * @param written_words Pages to be marked or unmarked as modified
+     * @param summary_words Summary of the pages to be marked or unmarked as modified
      * @param dirty_addr    Base address to mark or unmark as modified
      * @param size          Size in bytes to mark or unmark as modified
      *
@@ -244,8 +271,8 @@ private:
      * @tparam notify_rasterizer True when the rasterizer has to be notified about the changes
      */
     template <bool enable, bool notify_rasterizer>
-    void ChangeRegionState(WrittenWords& written_words, u64 dirty_addr,
-                           s64 size) noexcept(!notify_rasterizer) {
+    void ChangeRegionState(WrittenWords& written_words, WrittenWords& summary_words,
+                           u64 dirty_addr, s64 size) noexcept(!notify_rasterizer) {
         const s64 difference = dirty_addr - cpu_addr;
         const u64 offset = std::max<s64>(difference, 0);
         size += std::min<s64>(difference, 0);
@@ -253,6 +280,7 @@ private:
             return;
         }
         u64* const state_words = written_words.Pointer(IsShort());
+        u64* const state_summary_words = summary_words.Pointer(IsShort());
         const u64 offset_end = std::min(offset + size, SizeBytes());
         const u64 begin_page_index = offset / BYTES_PER_PAGE;
         const u64 begin_word_index = begin_page_index / PAGES_PER_WORD;
@@ -276,11 +304,55 @@ private:
             } else {
                 state_words[word_index] &= ~bits;
             }
+            UpdateSummary(state_summary_words, word_index, state_words[word_index]);
             page_index = 0;
             ++word_index;
         }
     }
 
+    /**
+     * Update the summary bit of a word after its state has changed
+     *
+     * @param summary_words Summary of the words to update
+     * @param word_index    Index to the word that has changed
+     * @param word          New state of the word
+     */
+    static void UpdateSummary(u64* summary_words, u64 word_index, u64 word) noexcept {
+        const u64 bit = u64{1} << (word_index % WORDS_PER_SUMMARY_WORD);
+        u64& summary_word = summary_words[word_index / WORDS_PER_SUMMARY_WORD];
+        summary_word = word != 0 ? (summary_word | bit) : (summary_word & ~bit);
+    }
+
+    /**
+     * Returns the index of the first word in a range that is not zero, skipping clean words 64 at
+     * a time through the summary
+     *
+     * @param summary_words Summary of the words to search
+     * @param word_begin    Index to the first word to search
+     * @param word_end      Index to the end of the words to search
+     *
+     * @returns The index to the first word that is not zero, word_end when there is none
+     */
+    [[nodiscard]] static u64 NextModifiedWord(const u64* summary_words, u64 word_begin,
+                                              u64 word_end) noexcept {
+        u64 summary_index = word_begin / WORDS_PER_SUMMARY_WORD;
+        const u64 summary_index_end = Common::DivCeil(word_end, WORDS_PER_SUMMARY_WORD);
+        if (summary_index >= summary_index_end) {
+            return word_end;
+        }
+        // Ignore the words before the beginning of the range in the first summary word
+        u64 summary = summary_words[summary_index];
+        summary &= ~u64{0} << (word_begin % WORDS_PER_SUMMARY_WORD);
+        while (summary == 0) {
+            if (++summary_index == summary_index_end) {
+                return word_end;
+            }
+            summary = summary_words[summary_index];
+        }
+        const u64 word_index = summary_index * WORDS_PER_SUMMARY_WORD + std::countr_zero(summary);
+        return std::min(word_index, word_end);
+    }
+
     /**
      * Notify rasterizer about changes in the CPU tracking state of a word in the buffer
      *
@@ -328,40 +400,23 @@ private:
             return;
         }
         const u64* const cpu_words = words.cpu.Pointer(IsShort());
-        const u64 query_end = query_begin + std::min(static_cast<u64>(size), SizeBytes());
+        const u64 query_end = std::min(query_begin + static_cast<u64>(size), SizeBytes());
         u64* const state_words = (gpu ? words.gpu : words.cpu).Pointer(IsShort());
-        u64* const words_begin = state_words + query_begin / BYTES_PER_WORD;
-        u64* const words_end = state_words + Common::DivCeil(query_end, BYTES_PER_WORD);
-
-        const auto modified = [](u64 word) { return word != 0; };
-        const auto first_modified_word = std::find_if(words_begin, words_end, modified);
-        if (first_modified_word == words_end) {
-            // Exit early when the buffer is not modified
-            return;
-        }
-        const auto last_modified_word = std::find_if_not(first_modified_word, words_end, modified);
-
-        const u64 word_index_begin = std::distance(state_words, first_modified_word);
-        const u64 word_index_end = std::distance(state_words, last_modified_word);
-
-        const unsigned local_page_begin = std::countr_zero(*first_modified_word);
-        const unsigned local_page_end = PAGES_PER_WORD - std::countl_zero(last_modified_word[-1]);
-        const u64 word_page_begin = word_index_begin * PAGES_PER_WORD;
-        const u64 word_page_end = (word_index_end - 1) * PAGES_PER_WORD;
+        u64* const summary_words = (gpu ? words.gpu_summary : words.cpu_summary).Pointer(IsShort());
         const u64 query_page_begin = query_begin / BYTES_PER_PAGE;
         const u64 query_page_end = Common::DivCeil(query_end, BYTES_PER_PAGE);
-        const u64 page_index_begin = std::max(word_page_begin + local_page_begin, query_page_begin);
-        const u64 page_index_end = std::min(word_page_end + local_page_end, query_page_end);
-        const u64 first_word_page_begin = page_index_begin % PAGES_PER_WORD;
-        const u64 last_word_page_end = (page_index_end - 1) % PAGES_PER_WORD + 1;
+        const u64 word_index_begin = query_page_begin / PAGES_PER_WORD;
+        const u64 word_index_end = Common::DivCeil(query_page_end, PAGES_PER_WORD);
 
-        u64 page_begin = first_word_page_begin;
         u64 current_base = 0;
         u64 current_size = 0;
         bool on_going = false;
-        for (u64 word_index = word_index_begin; word_index < word_index_end; ++word_index) {
-            const bool is_last_word = word_index + 1 == word_index_end;
-            const u64 page_end = is_last_word ? last_word_page_end : PAGES_PER_WORD;
+        for (u64 word_index = NextModifiedWord(summary_words, word_index_begin, word_index_end);
+             word_index < word_index_end;
+             word_index = NextModifiedWord(summary_words, word_index + 1, word_index_end)) {
+            const u64 word_page_begin = word_index * PAGES_PER_WORD;
+            const u64 page_begin = std::max(query_page_begin, word_page_begin) - word_page_begin;
+            const u64 page_end = std::min(query_page_end - word_page_begin, PAGES_PER_WORD);
             const u64 right_offset = page_begin;
             const u64 left_offset = PAGES_PER_WORD - page_end;
             u64 bits = ~u64{0};
@@ -370,31 +425,31 @@ private:
 
             const u64 current_word = state_words[word_index] & bits;
             state_words[word_index] &= ~bits;
+            UpdateSummary(summary_words, word_index, state_words[word_index]);
 
             // Exclude CPU modified pages when visiting GPU pages
-            const u64 word = current_word & ~(gpu ? cpu_words[word_index] : 0);
+            u64 word = current_word & ~(gpu ? cpu_words[word_index] : 0);
             if constexpr (notify_rasterizer) {
                 NotifyRasterizer<true>(word_index, word, ~u64{0});
             }
-            u64 page = page_begin;
-            page_begin = 0;
-
-            while (page < page_end) {
-                const int empty_bits = std::countr_zero(word >> page);
-                if (on_going && empty_bits != 0) {
+            while (word != 0) {
+                const int empty_bits = std::countr_zero(word);
+                const int continuous_bits = std::countr_one(word >> empty_bits);
+                const u64 page = word_page_begin + empty_bits;
+                if (on_going && current_base + current_size != page) {
+                    // Ranges are only merged when they are contiguous, even across words
                     InvokeModifiedRange(func, current_size, current_base);
-                    current_size = 0;
                     on_going = false;
                 }
-                page += empty_bits;
-
-                const int continuous_bits = std::countr_one(word >> page);
-                if (!on_going && continuous_bits != 0) {
-                    current_base = word_index * PAGES_PER_WORD + page;
+                if (!on_going) {
+                    current_base = page;
+                    current_size = 0;
                     on_going = true;
                 }
                 current_size += continuous_bits;
-                page += continuous_bits;
+
+                const u64 visited_bits = empty_bits + continuous_bits;
+                word = visited_bits < PAGES_PER_WORD ? word & (~u64{0} << visited_bits) : 0;
             }
         }
         if (on_going && current_size > 0) {
@@ -420,16 +475,21 @@ private:
     [[nodiscard]] bool IsRegionModified(u64 offset, u64 size) const noexcept {
         const u64* const cpu_words = words.cpu.Pointer(IsShort());
         const u64* const state_words = (gpu ? words.gpu : words.cpu).Pointer(IsShort());
+        const u64* const summary_words =
+            (gpu ? words.gpu_summary : words.cpu_summary).Pointer(IsShort());
         const u64 num_query_words = size / BYTES_PER_WORD + 1;
         const u64 word_begin = offset / BYTES_PER_WORD;
         const u64 word_end = std::min(word_begin + num_query_words, NumWords());
         const u64 page_limit = Common::DivCeil(offset + size, BYTES_PER_PAGE);
-        u64 page_index = (offset / BYTES_PER_PAGE) % PAGES_PER_WORD;
-        for (u64 word_index = word_begin; word_index < word_end; ++word_index, page_index = 0) {
+        const u64 first_page_index = (offset / BYTES_PER_PAGE) % PAGES_PER_WORD;
+        for (u64 word_index = NextModifiedWord(summary_words, word_begin, word_end);
+             word_index < word_end;
+             word_index = NextModifiedWord(summary_words, word_index + 1, word_end)) {
             const u64 word = state_words[word_index] & ~(gpu ? cpu_words[word_index] : 0);
             if (word == 0) {
                 continue;
             }
+            const u64 page_index = word_index == word_begin ? first_page_index : 0;
             const u64 page_end = std::min((word_index + 1) * PAGES_PER_WORD, page_limit);
             const u64 local_page_end = page_end % PAGES_PER_WORD;
             const u64 page_end_shift = (PAGES_PER_WORD - local_page_end) % PAGES_PER_WORD;
@@ -452,6 +512,8 @@ private:
     [[nodiscard]] std::pair<u64, u64> ModifiedRegion(u64 offset, u64 size) const noexcept {
         const u64* const cpu_words = words.cpu.Pointer(IsShort());
         const u64* const state_words = (gpu ? words.gpu : words.cpu).Pointer(IsShort());
+        const u64* const summary_words =
+            (gpu ? words.gpu_summary : words.cpu_summary).Pointer(IsShort());
         const u64 num_query_words = size / BYTES_PER_WORD + 1;
         const u64 word_begin = offset / BYTES_PER_WORD;
         const u64 word_end = std::min(word_begin + num_query_words, NumWords());
@@ -459,7 +521,9 @@ private:
         const u64 page_limit = Common::DivCeil(offset + size, BYTES_PER_PAGE);
         u64 begin = std::numeric_limits<u64>::max();
         u64 end = 0;
-        for (u64 word_index = word_begin; word_index < word_end; ++word_index) {
+        for (u64 word_index = NextModifiedWord(summary_words, word_begin, word_end);
+             word_index < word_end;
+             word_index = NextModifiedWord(summary_words, word_index + 1, word_end)) {
             const u64 word = state_words[word_index] & ~(gpu ? cpu_words[word_index] : 0);
             if (word == 0) {
                 continue;
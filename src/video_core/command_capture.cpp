@@ -0,0 +1,515 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include "common/alignment.h"
+#include "common/common_paths.h"
+#include "common/div_ceil.h"
+#include "common/logging/log.h"
+#include "common/scope_exit.h"
+#include "core/core.h"
+#include "core/hle/kernel/memory/page_table.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+#include "video_core/command_capture.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/gpu.h"
+#include "video_core/memory_manager.h"
+#include "video_core/rasterizer_interface.h"
+
+namespace Tegra {
+
+namespace {
+
+constexpr u32 FILE_MAGIC = 0x43475a59; // "YZGC"
+
+// Version of the file format, increment when the layout of the file changes
+constexpr u32 FILE_VERSION = 2;
+
+// Largest amount of guest memory stored in a single record
+constexpr std::size_t MAX_MEMORY_RECORD_SIZE = 16ULL * 1024 * 1024;
+
+// Granularity of the heap of guest processes
+constexpr std::size_t HEAP_ALIGNMENT = 0x200000;
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+struct RecordHeader {
+    CaptureRecordType type;
+    u32 size;
+};
+static_assert(std::is_trivially_copyable_v<RecordHeader>);
+
+static_assert(std::is_trivially_copyable_v<CaptureMapRecord>);
+static_assert(std::is_trivially_copyable_v<CaptureUnmapRecord>);
+static_assert(std::is_trivially_copyable_v<CaptureMemoryRecord>);
+
+std::string MakeCapturePath() {
+    const std::string dir = Common::FS::GetUserPath(Common::FS::UserPath::DumpDir) + "gpu_commands";
+    if (!Common::FS::CreateFullPath(dir + DIR_SEP)) {
+        LOG_ERROR(HW_GPU, "Failed to create directory={}", dir);
+    }
+    const std::time_t t = std::time(nullptr);
+    // %F Date format expanded is "%Y-%m-%d"
+    return fmt::format("{}" DIR_SEP "{:%F-%H-%M-%S}.bin", dir, *std::localtime(&t));
+}
+
+// Appends a page to a list of runs, extending the last run when the page follows it
+void AppendPage(std::vector<std::pair<VAddr, u64>>& runs, u64 page) {
+    const VAddr addr = page << Core::Memory::PAGE_BITS;
+    if (!runs.empty() && runs.back().first + runs.back().second == addr) {
+        runs.back().second += Core::Memory::PAGE_SIZE;
+    } else {
+        runs.emplace_back(addr, Core::Memory::PAGE_SIZE);
+    }
+}
+
+} // Anonymous namespace
+
+std::optional<Capture> ReadCapture(const std::string& path) {
+    Capture capture;
+    {
+        Common::FS::IOFile file(path, "rb");
+        if (!file.IsOpen()) {
+            LOG_ERROR(HW_GPU, "Failed to open GPU command capture in path={}", path);
+            return std::nullopt;
+        }
+        capture.data.resize(file.GetSize());
+        if (file.ReadBytes(capture.data.data(), capture.data.size()) != capture.data.size()) {
+            LOG_ERROR(HW_GPU, "Failed to read GPU command capture in path={}", path);
+            return std::nullopt;
+        }
+    }
+    const std::vector<u8>& data = capture.data;
+    FileHeader header{};
+    if (data.size() < sizeof(header)) {
+        LOG_ERROR(HW_GPU, "GPU command capture is too small");
+        return std::nullopt;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION) {
+        LOG_ERROR(HW_GPU, "GPU command capture has an invalid header");
+        return std::nullopt;
+    }
+    std::size_t offset = sizeof(header);
+    while (offset < data.size()) {
+        RecordHeader record{};
+        if (data.size() - offset < sizeof(record)) {
+            LOG_WARNING(HW_GPU, "GPU command capture is truncated");
+            break;
+        }
+        std::memcpy(&record, data.data() + offset, sizeof(record));
+        offset += sizeof(record);
+        if (data.size() - offset < record.size) {
+            LOG_WARNING(HW_GPU, "GPU command capture is truncated");
+            break;
+        }
+        const std::span<const u8> payload(data.data() + offset, record.size);
+        offset += record.size;
+
+        switch (record.type) {
+        case CaptureRecordType::Map:
+            if (record.size != sizeof(CaptureMapRecord)) {
+                LOG_ERROR(HW_GPU, "Invalid map record size={}", record.size);
+                return std::nullopt;
+            }
+            break;
+        case CaptureRecordType::Unmap:
+            if (record.size != sizeof(CaptureUnmapRecord)) {
+                LOG_ERROR(HW_GPU, "Invalid unmap record size={}", record.size);
+                return std::nullopt;
+            }
+            break;
+        case CaptureRecordType::Memory: {
+            CaptureMemoryRecord memory{};
+            if (record.size < sizeof(memory)) {
+                LOG_ERROR(HW_GPU, "Invalid memory record size={}", record.size);
+                return std::nullopt;
+            }
+            std::memcpy(&memory, payload.data(), sizeof(memory));
+            if (memory.size != record.size - sizeof(memory)) {
+                LOG_ERROR(HW_GPU, "Invalid memory record at cpu_addr=0x{:X}", memory.cpu_addr);
+                return std::nullopt;
+            }
+            break;
+        }
+        case CaptureRecordType::Submit:
+            if (record.size % sizeof(u32) != 0) {
+                LOG_ERROR(HW_GPU, "Invalid submit record size={}", record.size);
+                return std::nullopt;
+            }
+            break;
+        default:
+            LOG_ERROR(HW_GPU, "Unknown record type={}", static_cast<u32>(record.type));
+            return std::nullopt;
+        }
+        capture.records.push_back({record.type, payload});
+    }
+    return capture;
+}
+
+CommandRecorder::CommandRecorder(Core::Memory::Memory& cpu_memory_)
+    : CommandRecorder(cpu_memory_, MakeCapturePath()) {}
+
+CommandRecorder::CommandRecorder(Core::Memory::Memory& cpu_memory_, const std::string& path)
+    : cpu_memory{cpu_memory_} {
+    if (!file.Open(path, "wb")) {
+        LOG_ERROR(HW_GPU, "Failed to open GPU command capture in path={}", path);
+        return;
+    }
+    const FileHeader header{
+        .magic = FILE_MAGIC,
+        .version = FILE_VERSION,
+    };
+    if (file.WriteObject(header) != 1) {
+        LOG_ERROR(HW_GPU, "Failed to write GPU command capture header in path={}", path);
+        file.Close();
+        return;
+    }
+    LOG_INFO(HW_GPU, "Recording GPU commands to path={}", path);
+}
+
+CommandRecorder::~CommandRecorder() = default;
+
+void CommandRecorder::BindRasterizer(VideoCore::RasterizerInterface& rasterizer_) {
+    PageRuns runs;
+    {
+        std::scoped_lock lock{mutex};
+        rasterizer = &rasterizer_;
+        std::vector<u64> pages;
+        pages.reserve(mapped_pages.size());
+        for (const auto& [page, num_mappings] : mapped_pages) {
+            pages.push_back(page);
+        }
+        std::ranges::sort(pages);
+        for (const u64 page : pages) {
+            AppendPage(runs, page);
+        }
+    }
+    // Pages mapped before the rasterizer existed start reporting writes now
+    UpdatePagesCachedCount(runs, 1);
+}
+
+void CommandRecorder::RecordSubmit(const MemoryManager& memory_manager,
+                                   const CommandList& command_list) {
+    std::scoped_lock lock{mutex};
+    if (is_paused || !file.IsOpen()) {
+        return;
+    }
+    RecordMemoryChanges();
+
+    if (!command_list.prefetch_command_list.empty()) {
+        const auto& headers = command_list.prefetch_command_list;
+        WriteRecord(CaptureRecordType::Submit, headers.data(),
+                    headers.size() * sizeof(CommandHeader));
+        return;
+    }
+    // Pushbuffers can be modified by the guest once they are processed, store their contents
+    std::vector<u32> words;
+    for (const CommandListHeader& header : command_list.command_lists) {
+        const std::size_t offset = words.size();
+        words.resize(offset + header.size);
+        memory_manager.ReadBlockUnsafe(header.addr, words.data() + offset,
+                                       header.size * sizeof(u32));
+    }
+    WriteRecord(CaptureRecordType::Submit, words.data(), words.size() * sizeof(u32));
+}
+
+void CommandRecorder::RecordMap(GPUVAddr gpu_addr, VAddr cpu_addr, u64 size) {
+    PageRuns new_runs;
+    {
+        std::scoped_lock lock{mutex};
+        if (is_paused) {
+            return;
+        }
+        const CaptureMapRecord record{
+            .gpu_addr = gpu_addr,
+            .cpu_addr = cpu_addr,
+            .size = size,
+        };
+        WriteRecord(CaptureRecordType::Map, &record, sizeof(record));
+
+        if (cpu_addr == 0) {
+            return;
+        }
+        // New pages are dirty, so their contents are recorded before the next submission
+        const u64 page_end = Common::DivCeil(cpu_addr + size, Core::Memory::PAGE_SIZE);
+        for (u64 page = cpu_addr >> Core::Memory::PAGE_BITS; page < page_end; ++page) {
+            if (mapped_pages[page]++ == 0) {
+                dirty_pages.insert(page);
+                AppendPage(new_runs, page);
+            }
+        }
+        if (!rasterizer) {
+            return;
+        }
+    }
+    // Marking pages as cached can flush the rasterizer, don't hold the mutex while doing it
+    UpdatePagesCachedCount(new_runs, 1);
+}
+
+void CommandRecorder::RecordUnmap(GPUVAddr gpu_addr, VAddr cpu_addr, u64 size) {
+    PageRuns removed_runs;
+    {
+        std::scoped_lock lock{mutex};
+        if (is_paused) {
+            return;
+        }
+        const CaptureUnmapRecord record{
+            .gpu_addr = gpu_addr,
+            .size = size,
+        };
+        WriteRecord(CaptureRecordType::Unmap, &record, sizeof(record));
+
+        const u64 page_end = Common::DivCeil(cpu_addr + size, Core::Memory::PAGE_SIZE);
+        for (u64 page = cpu_addr >> Core::Memory::PAGE_BITS; page < page_end; ++page) {
+            const auto it = mapped_pages.find(page);
+            if (it == mapped_pages.end() || --it->second != 0) {
+                continue;
+            }
+            mapped_pages.erase(it);
+            dirty_pages.erase(page);
+            AppendPage(removed_runs, page);
+        }
+        if (!rasterizer) {
+            return;
+        }
+    }
+    UpdatePagesCachedCount(removed_runs, -1);
+}
+
+void CommandRecorder::OnCPUWrite(VAddr addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    if (is_paused || mapped_pages.empty()) {
+        return;
+    }
+    const u64 page_end = Common::DivCeil(addr + size, Core::Memory::PAGE_SIZE);
+    for (u64 page = addr >> Core::Memory::PAGE_BITS; page < page_end; ++page) {
+        if (mapped_pages.contains(page)) {
+            dirty_pages.insert(page);
+        }
+    }
+}
+
+void CommandRecorder::SetPaused(bool is_paused_) {
+    std::scoped_lock lock{mutex};
+    is_paused = is_paused_;
+}
+
+void CommandRecorder::RecordMemoryChanges() {
+    std::vector<u8> record;
+    VAddr record_addr = 0;
+    const auto flush = [&] {
+        const std::size_t size = record.size() - sizeof(CaptureMemoryRecord);
+        if (size == 0) {
+            return;
+        }
+        const CaptureMemoryRecord header{
+            .cpu_addr = record_addr,
+            .size = size,
+        };
+        std::memcpy(record.data(), &header, sizeof(header));
+        WriteRecord(CaptureRecordType::Memory, record.data(), record.size());
+        record.resize(sizeof(CaptureMemoryRecord));
+    };
+    record.resize(sizeof(CaptureMemoryRecord));
+
+    for (const u64 page : dirty_pages) {
+        const VAddr addr = page << Core::Memory::PAGE_BITS;
+        const u8* const pointer = cpu_memory.GetPointer(addr);
+        if (!pointer) {
+            continue;
+        }
+        const std::size_t size = record.size() - sizeof(CaptureMemoryRecord);
+        if (size != 0 && (record_addr + size != addr || size >= MAX_MEMORY_RECORD_SIZE)) {
+            flush();
+        }
+        if (record.size() == sizeof(CaptureMemoryRecord)) {
+            record_addr = addr;
+        }
+        record.insert(record.end(), pointer, pointer + Core::Memory::PAGE_SIZE);
+    }
+    flush();
+    dirty_pages.clear();
+}
+
+void CommandRecorder::WriteRecord(CaptureRecordType type, const void* data, std::size_t size) {
+    if (!file.IsOpen()) {
+        return;
+    }
+    const RecordHeader header{
+        .type = type,
+        .size = static_cast<u32>(size),
+    };
+    if (file.WriteObject(header) != 1 ||
+        file.WriteBytes(static_cast<const u8*>(data), size) != size) {
+        LOG_ERROR(HW_GPU, "Failed to write GPU command capture record, stopping the capture");
+        file.Close();
+    }
+}
+
+void CommandRecorder::UpdatePagesCachedCount(const PageRuns& runs, int delta) {
+    for (const auto& [addr, size] : runs) {
+        rasterizer->UpdatePagesCachedCount(addr, size, delta);
+    }
+}
+
+CommandReplayer::CommandReplayer(Core::System& system_) : system{system_}, gpu{system.GPU()} {}
+
+std::optional<ReplayStats> CommandReplayer::Replay(const std::string& path) {
+    // Load the whole capture up front so reading the file is not part of the measurement
+    const std::optional<Capture> capture = ReadCapture(path);
+    if (!capture) {
+        return std::nullopt;
+    }
+    // Find the CPU ranges mapped by the capture before replaying anything
+    std::vector<Relocation> mapped_ranges;
+    for (const CaptureRecord& record : capture->records) {
+        if (record.type != CaptureRecordType::Map) {
+            continue;
+        }
+        CaptureMapRecord map{};
+        std::memcpy(&map, record.payload.data(), sizeof(map));
+        if (map.cpu_addr != 0) {
+            mapped_ranges.push_back({
+                .capture_begin = Common::AlignDown(map.cpu_addr, Core::Memory::PAGE_SIZE),
+                .capture_end = Common::AlignUp(map.cpu_addr + map.size, Core::Memory::PAGE_SIZE),
+                .replay_addr = 0,
+            });
+        }
+    }
+    if (!AllocateMemory(mapped_ranges)) {
+        return std::nullopt;
+    }
+
+    // Don't record the replayed capture into a new capture
+    CommandRecorder* const recorder = gpu.GetCommandRecorder();
+    if (recorder) {
+        recorder->SetPaused(true);
+    }
+    SCOPE_EXIT({
+        if (recorder) {
+            recorder->SetPaused(false);
+        }
+    });
+
+    MemoryManager& memory_manager = gpu.MemoryManager();
+    Core::Memory::Memory& cpu_memory = system.Memory();
+    ReplayStats stats;
+    bool is_gpu_busy = false;
+    const auto start_time = std::chrono::steady_clock::now();
+
+    for (const CaptureRecord& record : capture->records) {
+        switch (record.type) {
+        case CaptureRecordType::Map: {
+            CaptureMapRecord map{};
+            std::memcpy(&map, record.payload.data(), sizeof(map));
+            if (map.cpu_addr == 0) {
+                void(memory_manager.AllocateFixed(map.gpu_addr, map.size));
+            } else {
+                void(memory_manager.Map(*Relocate(map.cpu_addr), map.gpu_addr, map.size));
+            }
+            ++stats.num_mappings;
+            break;
+        }
+        case CaptureRecordType::Unmap: {
+            CaptureUnmapRecord unmap{};
+            std::memcpy(&unmap, record.payload.data(), sizeof(unmap));
+            memory_manager.Unmap(unmap.gpu_addr, unmap.size);
+            break;
+        }
+        case CaptureRecordType::Memory: {
+            CaptureMemoryRecord memory{};
+            std::memcpy(&memory, record.payload.data(), sizeof(memory));
+            const std::optional<VAddr> cpu_addr = Relocate(memory.cpu_addr);
+            if (!cpu_addr) {
+                LOG_ERROR(HW_GPU, "Invalid memory record at cpu_addr=0x{:X}", memory.cpu_addr);
+                return std::nullopt;
+            }
+            // The guest would have waited for the GPU before reusing memory it reads from
+            if (is_gpu_busy) {
+                gpu.WaitIdle();
+                is_gpu_busy = false;
+            }
+            cpu_memory.WriteBlock(*cpu_addr, record.payload.data() + sizeof(memory), memory.size);
+            stats.memory_bytes += memory.size;
+            break;
+        }
+        case CaptureRecordType::Submit: {
+            std::vector<CommandHeader> headers(record.payload.size() / sizeof(CommandHeader));
+            std::memcpy(headers.data(), record.payload.data(), record.payload.size());
+            stats.num_words += headers.size();
+            ++stats.num_submissions;
+            gpu.PushGPUEntries(CommandList{std::move(headers)});
+            is_gpu_busy = true;
+            break;
+        }
+        }
+    }
+    gpu.WaitIdle();
+
+    stats.time = std::chrono::steady_clock::now() - start_time;
+    return stats;
+}
+
+bool CommandReplayer::AllocateMemory(const std::vector<Relocation>& ranges) {
+    // Merge overlapping ranges, so aliased mappings share the same memory on replay
+    std::vector<Relocation> sorted_ranges = ranges;
+    std::ranges::sort(sorted_ranges, {}, &Relocation::capture_begin);
+    relocations.clear();
+    for (const Relocation& range : sorted_ranges) {
+        if (!relocations.empty() && range.capture_begin <= relocations.back().capture_end) {
+            relocations.back().capture_end =
+                std::max(relocations.back().capture_end, range.capture_end);
+        } else {
+            relocations.push_back(range);
+        }
+    }
+    u64 total_size = 0;
+    for (const Relocation& relocation : relocations) {
+        total_size += relocation.capture_end - relocation.capture_begin;
+    }
+    if (total_size == 0) {
+        return true;
+    }
+
+    auto& page_table = system.CurrentProcess()->PageTable();
+    const u64 heap_size = page_table.GetHeapSize();
+    const auto heap_addr = page_table.SetHeapSize(Common::AlignUp(heap_size + total_size,
+                                                                  HEAP_ALIGNMENT));
+    if (heap_addr.Failed()) {
+        LOG_ERROR(HW_GPU, "Failed to allocate {} MiB for the GPU command capture",
+                  total_size / (1024 * 1024));
+        return false;
+    }
+    VAddr replay_addr = *heap_addr + heap_size;
+    for (Relocation& relocation : relocations) {
+        relocation.replay_addr = replay_addr;
+        replay_addr += relocation.capture_end - relocation.capture_begin;
+    }
+    return true;
+}
+
+std::optional<VAddr> CommandReplayer::Relocate(VAddr capture_addr) const {
+    const auto it = std::ranges::upper_bound(relocations, capture_addr, {},
+                                             &Relocation::capture_begin);
+    if (it == relocations.begin() || capture_addr >= std::prev(it)->capture_end) {
+        return std::nullopt;
+    }
+    return std::prev(it)->replay_addr + (capture_addr - std::prev(it)->capture_begin);
+}
+
+} // namespace Tegra
@@ -0,0 +1,184 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Core {
+class System;
+}
+
+namespace Core::Memory {
+class Memory;
+}
+
+namespace VideoCore {
+class RasterizerInterface;
+}
+
+namespace Tegra {
+
+class GPU;
+class MemoryManager;
+struct CommandList;
+
+/// Types of the records of a capture file
+enum class CaptureRecordType : u32 {
+    Map,
+    Unmap,
+    Submit,
+    Memory,
+};
+
+/// Payload of a map record
+struct CaptureMapRecord {
+    u64 gpu_addr;
+    u64 cpu_addr;
+    u64 size;
+};
+
+/// Payload of an unmap record
+struct CaptureUnmapRecord {
+    u64 gpu_addr;
+    u64 size;
+};
+
+/// Header of the payload of a memory record, followed by the contents of the CPU range
+struct CaptureMemoryRecord {
+    u64 cpu_addr;
+    u64 size;
+};
+
+/// Record of a capture file, its payload points into the data of the capture
+struct CaptureRecord {
+    CaptureRecordType type;
+    std::span<const u8> payload;
+};
+
+/// Capture file loaded in memory and split in records
+struct Capture {
+    std::vector<u8> data;
+    std::vector<CaptureRecord> records;
+};
+
+/// Reads a capture file and validates the size of its records, returns null on failure
+[[nodiscard]] std::optional<Capture> ReadCapture(const std::string& path);
+
+/**
+ * Records the command lists submitted to the GPU and the changes to the GPU address space, so GPU
+ * workloads can be replayed without emulating the guest. Command lists are recorded with the
+ * contents of their pushbuffers at the time of submission. Before each submission, the pages of
+ * guest memory mapped to the GPU that were written since the previous submission are recorded too.
+ * Mapped pages are marked as cached in the rasterizer, so CPU writes to them are notified through
+ * OnCPUWrite. Like for the rasterizer caches, writes through host pointers are not seen.
+ */
+class CommandRecorder {
+public:
+    /// Records to a new file in the dump directory
+    explicit CommandRecorder(Core::Memory::Memory& cpu_memory_);
+
+    explicit CommandRecorder(Core::Memory::Memory& cpu_memory_, const std::string& path);
+
+    ~CommandRecorder();
+
+    /// Binds the rasterizer notified of the pages that have to report CPU writes
+    void BindRasterizer(VideoCore::RasterizerInterface& rasterizer_);
+
+    /// Records a command list, reading its pushbuffers from GPU memory
+    void RecordSubmit(const MemoryManager& memory_manager, const CommandList& command_list);
+
+    /// Records a GPU range mapped to CPU memory, or only allocated when cpu_addr is zero
+    void RecordMap(GPUVAddr gpu_addr, VAddr cpu_addr, u64 size);
+
+    /// Records an unmapped GPU range that was mapped to cpu_addr
+    void RecordUnmap(GPUVAddr gpu_addr, VAddr cpu_addr, u64 size);
+
+    /// Notifies a CPU write, so the written pages are recorded before the next submission
+    void OnCPUWrite(VAddr addr, u64 size);
+
+    /// Stops or resumes recording, used to avoid recording replayed captures
+    void SetPaused(bool is_paused_);
+
+private:
+    /// Runs of pages, as their first CPU address and their size in bytes
+    using PageRuns = std::vector<std::pair<VAddr, u64>>;
+
+    /// Records the contents of the mapped pages written since they were last recorded
+    void RecordMemoryChanges();
+
+    /// Writes a record to the capture file, the mutex has to be held
+    void WriteRecord(CaptureRecordType type, const void* data, std::size_t size);
+
+    /// Updates the cached pages of the rasterizer, the mutex must not be held
+    void UpdatePagesCachedCount(const PageRuns& runs, int delta);
+
+    Core::Memory::Memory& cpu_memory;
+    VideoCore::RasterizerInterface* rasterizer = nullptr;
+
+    std::mutex mutex;
+    Common::FS::IOFile file;
+    bool is_paused = false;
+
+    /// Number of GPU mappings of each page of CPU memory, indexed by page number
+    std::unordered_map<u64, u32> mapped_pages;
+
+    /// Mapped pages written since they were last recorded, sorted to merge contiguous pages
+    std::set<u64> dirty_pages;
+};
+
+/// Statistics of a replayed capture
+struct ReplayStats {
+    u64 num_submissions{};
+    u64 num_words{};
+    u64 num_mappings{};
+    u64 memory_bytes{};
+    std::chrono::nanoseconds time{};
+};
+
+/**
+ * Replays captures from CommandRecorder as fast as the GPU can process them. The CPU memory
+ * mapped to the GPU in the capture is backed by heap memory of the current process, which can be
+ * an empty process (see Core::System::LoadEmptyProcess). Recorded guest memory is written back
+ * before the submissions that follow it. Writing guest memory waits for the GPU to go idle first,
+ * since the guest synchronization is not part of the capture.
+ */
+class CommandReplayer {
+public:
+    explicit CommandReplayer(Core::System& system_);
+
+    /// Replays a capture file and waits for the GPU to process it, returns null on failure
+    std::optional<ReplayStats> Replay(const std::string& path);
+
+private:
+    /// CPU range of the capture, relocated to the heap of the current process
+    struct Relocation {
+        VAddr capture_begin;
+        VAddr capture_end;
+        VAddr replay_addr;
+    };
+
+    /// Allocates heap memory for the CPU ranges mapped in the capture, returns false on failure
+    bool AllocateMemory(const std::vector<Relocation>& ranges);
+
+    /// Translates a CPU address of the capture to the current process
+    std::optional<VAddr> Relocate(VAddr capture_addr) const;
+
+    Core::System& system;
+    GPU& gpu;
+    std::vector<Relocation> relocations;
+};
+
+} // namespace Tegra
@@ -95,6 +95,13 @@ bool DmaPusher::Step() {
                 dma_state.is_last_call = true;
                 index += max_write;
                 continue;
+            } else if (!dma_increment_once) {
+                const u32 max_write = static_cast<u32>(
+                    std::min<std::size_t>(index + dma_state.method_count, command_headers.size()) -
+                    index);
+                CallIncreasingMethods(&command_header.argument, max_write);
+                index += max_write;
+                continue;
             } else {
                 dma_state.is_last_call = dma_state.method_count <= 1;
                 CallMethod(command_header.argument);
@@ -174,4 +181,23 @@ void DmaPusher::CallMultiMethod(const u32* base_start, u32 num_methods) const {
     }
 }
 
+void DmaPusher::CallIncreasingMethods(const u32* base_start, u32 num_methods) {
+    // Puller methods are handled by the GPU one at a time
+    u32 index = 0;
+    for (; index < num_methods && dma_state.method < non_puller_methods; ++index) {
+        dma_state.is_last_call = dma_state.method_count <= 1;
+        CallMethod(base_start[index]);
+        ++dma_state.method;
+        --dma_state.method_count;
+    }
+    if (index < num_methods) {
+        const u32 num_engine_methods = num_methods - index;
+        subchannels[dma_state.subchannel]->CallIncreasingMethods(
+            dma_state.method, base_start + index, num_engine_methods, dma_state.method_count);
+        dma_state.method += num_engine_methods;
+        dma_state.method_count -= num_engine_methods;
+    }
+    dma_state.is_last_call = true;
+}
+
 } // namespace Tegra
@@ -125,6 +125,7 @@ private:
 
     void CallMethod(u32 argument) const;
     void CallMultiMethod(const u32* base_start, u32 num_methods) const;
+    void CallIncreasingMethods(const u32* base_start, u32 num_methods);
 
     std::vector<CommandHeader> command_headers; ///< Buffer for list of commands fetched at once
 
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 
 #include "common/assert.h"
@@ -24,15 +25,35 @@ void State::ProcessExec(const bool is_linear_) {
 }
 
 void State::ProcessData(const u32 data, const bool is_last_call) {
-    const u32 sub_copy_size = std::min(4U, copy_size - write_offset);
-    std::memcpy(&inner_buffer[write_offset], &data, sub_copy_size);
-    write_offset += sub_copy_size;
-    if (!is_last_call) {
+    ProcessData(&data, 1, is_last_call);
+}
+
+void State::ProcessData(const u32* data, std::size_t num_words, bool is_last_call) {
+    const std::size_t remaining = copy_size - write_offset;
+    const std::size_t size = std::min(num_words * sizeof(u32), remaining);
+    if (size == 0) {
+        return;
+    }
+    if (write_offset == 0 && size == copy_size) {
+        // The whole transfer is in this run, skip the copy to the staging buffer
+        write_offset = copy_size;
+        WriteData(reinterpret_cast<const u8*>(data));
         return;
     }
+    std::memcpy(&inner_buffer[write_offset], data, size);
+    write_offset += static_cast<u32>(size);
+    // Transfers split across command lists are written as they arrive
+    if (write_offset == copy_size || is_last_call) {
+        WriteData(inner_buffer.data());
+    }
+}
+
+void State::WriteData(const u8* data) {
     const GPUVAddr address{regs.dest.Address()};
+    // Always write to guest memory, the destination can be read by the guest or by later command
+    // lists, and the buffer cache uploads invalidated ranges again from there
     if (is_linear) {
-        memory_manager.WriteBlock(address, inner_buffer.data(), copy_size);
+        memory_manager.WriteBlock(address, data, copy_size);
     } else {
         UNIMPLEMENTED_IF(regs.dest.z != 0);
         UNIMPLEMENTED_IF(regs.dest.depth != 1);
@@ -43,8 +64,7 @@ void State::ProcessData(const u32 data, const bool is_last_call) {
         tmp_buffer.resize(dst_size);
         memory_manager.ReadBlock(address, tmp_buffer.data(), dst_size);
         Tegra::Texture::SwizzleKepler(regs.dest.width, regs.dest.height, regs.dest.x, regs.dest.y,
-                                      regs.dest.BlockHeight(), copy_size, inner_buffer.data(),
-                                      tmp_buffer.data());
+                                      regs.dest.BlockHeight(), copy_size, data, tmp_buffer.data());
         memory_manager.WriteBlock(address, tmp_buffer.data(), dst_size);
     }
 }
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
+
 #include "common/bit_field.h"
 #include "common/common_types.h"
 
@@ -60,7 +62,14 @@ public:
     void ProcessExec(bool is_linear_);
     void ProcessData(u32 data, bool is_last_call);
 
+    /// Processes a run of data words. When the run holds the whole transfer, it's written to
+    /// memory straight from the words without staging them.
+    void ProcessData(const u32* data, std::size_t num_words, bool is_last_call);
+
 private:
+    /// Writes copy_size bytes of data to the destination
+    void WriteData(const u8* data);
+
     u32 write_offset = 0;
     u32 copy_size = 0;
     std::vector<u8> inner_buffer;
@@ -42,6 +42,15 @@ void KeplerMemory::CallMethod(u32 method, u32 method_argument, bool is_last_call
 
 void KeplerMemory::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
                                    u32 methods_pending) {
+    if (method == KEPLERMEMORY_REG_INDEX(data)) {
+        const bool is_last_call = amount == methods_pending;
+        regs.reg_array[method] = base_start[amount - 1];
+        upload_state.ProcessData(base_start, amount, is_last_call);
+        if (is_last_call) {
+            system.GPU().Maxwell3D().OnMemoryWrite();
+        }
+        return;
+    }
     for (std::size_t i = 0; i < amount; i++) {
         CallMethod(method, base_start[i], methods_pending - static_cast<u32>(i) <= 1);
     }
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <optional>
 #include "common/assert.h"
@@ -121,6 +122,34 @@ void Maxwell3D::InitializeRegisterDefaults() {
     mme_inline[MAXWELL3D_REG_INDEX(draw.vertex_begin_gl)] = true;
     mme_inline[MAXWELL3D_REG_INDEX(vertex_buffer.count)] = true;
     mme_inline[MAXWELL3D_REG_INDEX(index_array.count)] = true;
+
+    // Methods handled by ProcessMethodCall
+    for (const std::size_t method : {
+             MAXWELL3D_REG_INDEX(wait_for_idle),
+             MAXWELL3D_REG_INDEX(shadow_ram_control),
+             MAXWELL3D_REG_INDEX(macros.data),
+             MAXWELL3D_REG_INDEX(macros.bind),
+             MAXWELL3D_REG_INDEX(firmware[4]),
+             MAXWELL3D_REG_INDEX(draw.vertex_end_gl),
+             MAXWELL3D_REG_INDEX(clear_buffers),
+             MAXWELL3D_REG_INDEX(query.query_get),
+             MAXWELL3D_REG_INDEX(condition.mode),
+             MAXWELL3D_REG_INDEX(counter_reset),
+             MAXWELL3D_REG_INDEX(sync_info),
+             MAXWELL3D_REG_INDEX(exec_upload),
+             MAXWELL3D_REG_INDEX(data_upload),
+             MAXWELL3D_REG_INDEX(fragment_barrier),
+             MAXWELL3D_REG_INDEX(tiled_cache_barrier),
+         }) {
+        trigger_methods.set(method);
+    }
+    for (std::size_t index = 0; index < regs.const_buffer.cb_data.size(); ++index) {
+        trigger_methods.set(MAXWELL3D_REG_INDEX(const_buffer.cb_data) + index);
+    }
+    constexpr std::size_t cb_bind_stride = sizeof(regs.cb_bind[0]) / sizeof(u32);
+    for (std::size_t stage = 0; stage < Regs::MaxShaderStage; ++stage) {
+        trigger_methods.set(MAXWELL3D_REG_INDEX(cb_bind) + stage * cb_bind_stride);
+    }
 }
 
 void Maxwell3D::ProcessMacro(u32 method, const u32* base_start, u32 amount, bool is_last_call) {
@@ -165,8 +194,41 @@ void Maxwell3D::ProcessDirtyRegisters(u32 method, u32 argument) {
     }
 }
 
+void Maxwell3D::WriteRegisters(u32 method, const u32* base_start, u32 amount) {
+    const auto control = shadow_state.shadow_ram_control;
+    if (control == Regs::ShadowRamControl::Track ||
+        control == Regs::ShadowRamControl::TrackWithFilter) {
+        std::memcpy(&shadow_state.reg_array[method], base_start, amount * sizeof(u32));
+    }
+    for (u32 i = 0; i < amount; ++i) {
+        if (regs.reg_array[method + i] == base_start[i]) {
+            continue;
+        }
+        for (const auto& table : dirty.tables) {
+            dirty.flags[table[method + i]] = true;
+        }
+    }
+    std::memcpy(&regs.reg_array[method], base_start, amount * sizeof(u32));
+}
+
+u32 Maxwell3D::CountBulkWritableMethods(u32 method, u32 amount) const {
+    // Pending const buffer data, macro arguments and replayed shadow RAM change how registers are
+    // written, let CallMethod deal with them
+    if (cb_data_state.current != null_cb_data || executing_macro != 0 ||
+        shadow_state.shadow_ram_control == Regs::ShadowRamControl::Replay) {
+        return 0;
+    }
+    const u32 end = std::min(method + amount, MacroRegistersStart);
+    u32 count = 0;
+    while (method + count < end && !trigger_methods[method + count]) {
+        ++count;
+    }
+    return count;
+}
+
 void Maxwell3D::ProcessMethodCall(u32 method, u32 argument, u32 nonshadow_argument,
                                   bool is_last_call) {
+    // Methods handled here have to be in trigger_methods
     switch (method) {
     case MAXWELL3D_REG_INDEX(wait_for_idle):
         return rasterizer->WaitForIdle();
@@ -305,6 +367,13 @@ void Maxwell3D::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
     case MAXWELL3D_REG_INDEX(const_buffer.cb_data) + 15:
         ProcessCBMultiData(method, base_start, amount);
         break;
+    case MAXWELL3D_REG_INDEX(data_upload):
+        // Replayed shadow values replace the data, those still go through the slow path
+        if (shadow_state.shadow_ram_control != Regs::ShadowRamControl::Replay) {
+            ProcessUploadMultiData(base_start, amount, amount == methods_pending);
+            break;
+        }
+        [[fallthrough]];
     default:
         for (std::size_t i = 0; i < amount; i++) {
             CallMethod(method, base_start[i], methods_pending - static_cast<u32>(i) <= 1);
@@ -313,6 +382,21 @@ void Maxwell3D::CallMultiMethod(u32 method, const u32* base_start, u32 amount,
     }
 }
 
+void Maxwell3D::CallIncreasingMethods(u32 method, const u32* base_start, u32 amount,
+                                      u32 methods_pending) {
+    u32 index = 0;
+    while (index < amount) {
+        const u32 num_bulk = CountBulkWritableMethods(method + index, amount - index);
+        if (num_bulk == 0) {
+            CallMethod(method + index, base_start[index], methods_pending - index <= 1);
+            ++index;
+            continue;
+        }
+        WriteRegisters(method + index, base_start + index, num_bulk);
+        index += num_bulk;
+    }
+}
+
 void Maxwell3D::StepInstance(const MMEDrawMode expected_mode, const u32 count) {
     if (mme_draw.current_mode == MMEDrawMode::Undefined) {
         if (mme_draw.gl_begin_consume) {
@@ -622,6 +706,19 @@ void Maxwell3D::ProcessCBMultiData(u32 method, const u32* start_base, u32 amount
     regs.const_buffer.cb_pos = regs.const_buffer.cb_pos + 4 * amount;
 }
 
+void Maxwell3D::ProcessUploadMultiData(const u32* start_base, u32 amount, bool is_last_call) {
+    if (cb_data_state.current != null_cb_data) {
+        FinishCBData();
+    }
+    const u32 argument = ProcessShadowRam(MAXWELL3D_REG_INDEX(data_upload), start_base[amount - 1]);
+    ProcessDirtyRegisters(MAXWELL3D_REG_INDEX(data_upload), argument);
+
+    upload_state.ProcessData(start_base, amount, is_last_call);
+    if (is_last_call) {
+        OnMemoryWrite();
+    }
+}
+
 void Maxwell3D::FinishCBData() {
     // Write the input value to the current const buffer at the current position.
     const GPUVAddr buffer_address = regs.const_buffer.BufferAddress();
@@ -1418,6 +1418,10 @@ public:
     void CallMultiMethod(u32 method, const u32* base_start, u32 amount,
                          u32 methods_pending) override;
 
+    /// Write multiple values to consecutive registers starting at method.
+    void CallIncreasingMethods(u32 method, const u32* base_start, u32 amount,
+                               u32 methods_pending) override;
+
     /// Write the value to the register identified by method.
     void CallMethodFromMME(u32 method, u32 method_argument);
 
@@ -1491,6 +1495,12 @@ private:
 
     void ProcessDirtyRegisters(u32 method, u32 argument);
 
+    /// Writes consecutive registers without side effects with a single dirty flags pass.
+    void WriteRegisters(u32 method, const u32* base_start, u32 amount);
+
+    /// Returns the number of consecutive registers from method that can be written in bulk.
+    u32 CountBulkWritableMethods(u32 method, u32 amount) const;
+
     void ProcessMethodCall(u32 method, u32 argument, u32 nonshadow_argument, bool is_last_call);
 
     /// Retrieves information about a specific TIC entry from the TIC buffer.
@@ -1540,6 +1550,9 @@ private:
     void ProcessCBMultiData(u32 method, const u32* start_base, u32 amount);
     void FinishCBData();
 
+    /// Handles a run of writes to the DATA_UPLOAD register.
+    void ProcessUploadMultiData(const u32* start_base, u32 amount, bool is_last_call);
+
     /// Handles a write to the CB_BIND register.
     void ProcessCBBind(std::size_t stage_index);
 
@@ -1562,6 +1575,9 @@ private:
 
     std::array<bool, Regs::NUM_REGS> mme_inline{};
 
+    /// Registers with side effects on write, they are never written in bulk.
+    std::bitset<Regs::NUM_REGS> trigger_methods{};
+
     /// Macro method that is currently being executed / being fed parameters.
     u32 executing_macro = 0;
     /// Parameters that have been submitted to the macro call so far.
@@ -13,6 +13,7 @@
 #include "core/hardware_interrupt_manager.h"
 #include "core/memory.h"
 #include "core/settings.h"
+#include "video_core/command_capture.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/engines/kepler_memory.h"
@@ -38,7 +39,12 @@ GPU::GPU(Core::System& system_, bool is_async_, bool use_nvdec_)
       maxwell_dma{std::make_unique<Engines::MaxwellDMA>(system, *memory_manager)},
       kepler_memory{std::make_unique<Engines::KeplerMemory>(system, *memory_manager)},
       shader_notify{std::make_unique<VideoCore::ShaderNotify>()}, is_async{is_async_},
-      gpu_thread{system_, is_async_} {}
+      gpu_thread{system_, is_async_} {
+    if (Settings::values.record_gpu_commands) {
+        command_recorder = std::make_unique<Tegra::CommandRecorder>(system.Memory());
+        memory_manager->BindCommandRecorder(*command_recorder);
+    }
+}
 
 GPU::~GPU() = default;
 
@@ -50,6 +56,9 @@ void GPU::BindRenderer(std::unique_ptr<VideoCore::RendererBase> renderer_) {
     maxwell_3d->BindRasterizer(rasterizer);
     fermi_2d->BindRasterizer(rasterizer);
     kepler_compute->BindRasterizer(rasterizer);
+    if (command_recorder) {
+        command_recorder->BindRasterizer(rasterizer);
+    }
 }
 
 Engines::Maxwell3D& GPU::Maxwell3D() {
@@ -76,6 +85,10 @@ const MemoryManager& GPU::MemoryManager() const {
     return *memory_manager;
 }
 
+CommandRecorder* GPU::GetCommandRecorder() {
+    return command_recorder.get();
+}
+
 DmaPusher& GPU::DmaPusher() {
     return *dma_pusher;
 }
@@ -474,6 +487,9 @@ void GPU::ReleaseContext() {
 }
 
 void GPU::PushGPUEntries(Tegra::CommandList&& entries) {
+    if (command_recorder) {
+        command_recorder->RecordSubmit(*memory_manager, entries);
+    }
     gpu_thread.SubmitList(std::move(entries));
 }
 
@@ -507,10 +523,16 @@ void GPU::FlushRegion(VAddr addr, u64 size) {
 }
 
 void GPU::InvalidateRegion(VAddr addr, u64 size) {
+    if (command_recorder) {
+        command_recorder->OnCPUWrite(addr, size);
+    }
     gpu_thread.InvalidateRegion(addr, size);
 }
 
 void GPU::FlushAndInvalidateRegion(VAddr addr, u64 size) {
+    if (command_recorder) {
+        command_recorder->OnCPUWrite(addr, size);
+    }
     gpu_thread.FlushAndInvalidateRegion(addr, size);
 }
 
@@ -101,6 +101,7 @@ enum class DepthFormat : u32 {
 };
 
 struct CommandListHeader;
+class CommandRecorder;
 class DebugContext;
 
 namespace Engines {
@@ -187,6 +188,9 @@ public:
     /// Returns a const reference to the GPU memory manager.
     [[nodiscard]] const Tegra::MemoryManager& MemoryManager() const;
 
+    /// Returns the command recorder, or null when GPU commands are not being recorded.
+    [[nodiscard]] Tegra::CommandRecorder* GetCommandRecorder();
+
     /// Returns a reference to the GPU DMA pusher.
     [[nodiscard]] Tegra::DmaPusher& DmaPusher();
 
@@ -383,6 +387,8 @@ private:
     std::unique_ptr<Engines::KeplerMemory> kepler_memory;
     /// Shader build notifier
     std::unique_ptr<VideoCore::ShaderNotify> shader_notify;
+    /// Command list recorder, only created when recording is enabled
+    std::unique_ptr<Tegra::CommandRecorder> command_recorder;
 
     std::array<std::atomic<u32>, Service::Nvidia::MaxSyncPoints> syncpoints{};
 
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+
 #include "common/assert.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
@@ -16,6 +18,9 @@
 
 namespace VideoCommon::GPUThread {
 
+/// Maximum number of commands taken from the queue at once
+constexpr std::size_t COMMAND_BATCH_SIZE = 32;
+
 /// Runs the GPU thread
 static void RunThread(Core::System& system, VideoCore::RendererBase& renderer,
                       Core::Frontend::GraphicsContext& context, Tegra::DmaPusher& dma_pusher,
@@ -39,32 +44,40 @@ static void RunThread(Core::System& system, VideoCore::RendererBase& renderer,
 
     auto current_context = context.Acquire();
 
-    CommandDataContainer next;
+    std::array<CommandDataContainer, COMMAND_BATCH_SIZE> batch;
     while (state.is_running) {
-        next = state.queue.PopWait();
-        if (auto* submit_list = std::get_if<SubmitListCommand>(&next.data)) {
-            dma_pusher.Push(std::move(submit_list->entries));
-            dma_pusher.DispatchCalls();
-        } else if (auto* command_list = std::get_if<SubmitChCommandEntries>(&next.data)) {
-            // NVDEC
-            cdma_pusher.Push(std::move(command_list->entries));
-            cdma_pusher.DispatchCalls();
-        } else if (const auto* data = std::get_if<SwapBuffersCommand>(&next.data)) {
-            renderer.SwapBuffers(data->framebuffer ? &*data->framebuffer : nullptr);
-        } else if (std::holds_alternative<OnCommandListEndCommand>(next.data)) {
-            renderer.Rasterizer().ReleaseFences();
-        } else if (std::holds_alternative<GPUTickCommand>(next.data)) {
-            system.GPU().TickWork();
-        } else if (const auto* flush = std::get_if<FlushRegionCommand>(&next.data)) {
-            renderer.Rasterizer().FlushRegion(flush->addr, flush->size);
-        } else if (const auto* invalidate = std::get_if<InvalidateRegionCommand>(&next.data)) {
-            renderer.Rasterizer().OnCPUWrite(invalidate->addr, invalidate->size);
-        } else if (std::holds_alternative<EndProcessingCommand>(next.data)) {
-            return;
-        } else {
-            UNREACHABLE();
+        // Take all pending commands at once, only wait for the producers when there are none
+        std::size_t count = state.queue.TryPopBatch(batch.begin(), batch.size());
+        if (count == 0) {
+            batch[0] = state.queue.PopWait();
+            count = 1;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            CommandDataContainer& next = batch[i];
+            if (auto* submit_list = std::get_if<SubmitListCommand>(&next.data)) {
+                dma_pusher.Push(std::move(submit_list->entries));
+                dma_pusher.DispatchCalls();
+            } else if (auto* command_list = std::get_if<SubmitChCommandEntries>(&next.data)) {
+                // NVDEC
+                cdma_pusher.Push(std::move(command_list->entries));
+                cdma_pusher.DispatchCalls();
+            } else if (const auto* data = std::get_if<SwapBuffersCommand>(&next.data)) {
+                renderer.SwapBuffers(data->framebuffer ? &*data->framebuffer : nullptr);
+            } else if (std::holds_alternative<OnCommandListEndCommand>(next.data)) {
+                renderer.Rasterizer().ReleaseFences();
+            } else if (std::holds_alternative<GPUTickCommand>(next.data)) {
+                system.GPU().TickWork();
+            } else if (const auto* flush = std::get_if<FlushRegionCommand>(&next.data)) {
+                renderer.Rasterizer().FlushRegion(flush->addr, flush->size);
+            } else if (const auto* invalidate = std::get_if<InvalidateRegionCommand>(&next.data)) {
+                renderer.Rasterizer().OnCPUWrite(invalidate->addr, invalidate->size);
+            } else if (std::holds_alternative<EndProcessingCommand>(next.data)) {
+                return;
+            } else {
+                UNREACHABLE();
+            }
+            state.signaled_fence.store(next.fence);
         }
-        state.signaled_fence.store(next.fence);
     }
 }
 
@@ -11,7 +11,7 @@
 #include <thread>
 #include <variant>
 
-#include "common/threadsafe_queue.h"
+#include "common/bounded_threadsafe_queue.h"
 #include "video_core/framebuffer_config.h"
 
 namespace Tegra {
@@ -108,7 +108,11 @@ struct CommandDataContainer {
 struct SynchState final {
     std::atomic_bool is_running{true};
 
-    using CommandQueue = Common::MPSCQueue<CommandDataContainer>;
+    /// Commands pending for the GPU thread. The queue is bounded: once 0x400 commands are pending,
+    /// producers block in Push until the GPU thread pops one. Producers may push while holding the
+    /// queue's write lock and the NVFlinger guard (buffer swaps from the composition), so the GPU
+    /// thread must never take either of them, which includes pushing commands to its own queue.
+    using CommandQueue = Common::BoundedMPSCQueue<CommandDataContainer>;
     CommandQueue queue;
     u64 last_fence{};
     std::atomic<u64> signaled_fence{};
@@ -2,7 +2,19 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <optional>
+
+#ifdef ARCHITECTURE_x86_64
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
 #include <boost/container_hash/hash.hpp>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -15,10 +27,41 @@
 
 namespace Tegra {
 
+namespace {
+
+// Number of consecutive calls with the same first parameter before a macro is specialized for it
+constexpr u32 SPECIALIZATION_THRESHOLD = 64;
+
+// Number of macros logged when the engine is destroyed with profiling enabled
+constexpr std::size_t NUM_LOGGED_PROFILES = 16;
+
+/// Returns a timestamp in host ticks, cycles when the host has a time stamp counter
+u64 GetTicks() {
+#ifdef ARCHITECTURE_x86_64
+    return __rdtsc();
+#else
+    return static_cast<u64>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+} // Anonymous namespace
+
 MacroEngine::MacroEngine(Engines::Maxwell3D& maxwell3d)
-    : hle_macros{std::make_unique<Tegra::HLEMacro>(maxwell3d)} {}
+    : hle_macros{std::make_unique<Tegra::HLEMacro>(maxwell3d)},
+      is_profiling{Settings::values.profile_macros} {}
 
-MacroEngine::~MacroEngine() = default;
+MacroEngine::~MacroEngine() {
+    if (!is_profiling) {
+        return;
+    }
+    const std::vector<MacroProfile> profile = GetProfile();
+    const std::size_t num_logged = std::min(profile.size(), NUM_LOGGED_PROFILES);
+    for (std::size_t index = 0; index < num_logged; ++index) {
+        const MacroProfile& entry = profile[index];
+        LOG_INFO(HW_GPU, "Macro 0x{:016x}: {} executions, {} ticks{}", entry.hash,
+                 entry.num_executions, entry.num_ticks, entry.is_hle ? " (HLE)" : "");
+    }
+}
 
 void MacroEngine::AddCode(u32 method, u32 data) {
     uploaded_macro_code[method].push_back(data);
@@ -26,55 +69,124 @@ void MacroEngine::AddCode(u32 method, u32 data) {
 
 void MacroEngine::Execute(Engines::Maxwell3D& maxwell3d, u32 method,
                           const std::vector<u32>& parameters) {
-    auto compiled_macro = macro_cache.find(method);
-    if (compiled_macro != macro_cache.end()) {
-        const auto& cache_info = compiled_macro->second;
-        if (cache_info.has_hle_program) {
-            cache_info.hle_program->Execute(parameters, method);
-        } else {
-            cache_info.lle_program->Execute(parameters, method);
-        }
+    CacheInfo* cache_info;
+    if (const auto it = macro_cache.find(method); it != macro_cache.end()) {
+        cache_info = &it->second;
     } else {
         // Macro not compiled, check if it's uploaded and if so, compile it
-        std::optional<u32> mid_method;
-        const auto macro_code = uploaded_macro_code.find(method);
-        if (macro_code == uploaded_macro_code.end()) {
-            for (const auto& [method_base, code] : uploaded_macro_code) {
-                if (method >= method_base && (method - method_base) < code.size()) {
-                    mid_method = method_base;
-                    break;
-                }
-            }
-            if (!mid_method.has_value()) {
-                UNREACHABLE_MSG("Macro 0x{0:x} was not uploaded", method);
-                return;
-            }
+        cache_info = CompileMacro(method);
+        if (!cache_info) {
+            return;
         }
-        auto& cache_info = macro_cache[method];
+    }
+    CachedMacro& program = SelectProgram(*cache_info, parameters);
+    if (!is_profiling) {
+        program.Execute(parameters, method);
+        return;
+    }
+    const u64 start_ticks = GetTicks();
+    program.Execute(parameters, method);
+    cache_info->profile->num_ticks += GetTicks() - start_ticks;
+    ++cache_info->profile->num_executions;
+}
+
+std::vector<MacroProfile> MacroEngine::GetProfile() const {
+    std::vector<MacroProfile> result;
+    result.reserve(profiles.size());
+    for (const auto& [hash, profile] : profiles) {
+        result.push_back(profile);
+    }
+    std::ranges::sort(result, std::ranges::greater{}, &MacroProfile::num_ticks);
+    return result;
+}
 
+MacroEngine::CacheInfo* MacroEngine::CompileMacro(u32 method) {
+    std::optional<u32> mid_method;
+    const auto macro_code = uploaded_macro_code.find(method);
+    if (macro_code == uploaded_macro_code.end()) {
+        for (const auto& [method_base, code] : uploaded_macro_code) {
+            if (method >= method_base && (method - method_base) < code.size()) {
+                mid_method = method_base;
+                break;
+            }
+        }
         if (!mid_method.has_value()) {
-            cache_info.lle_program = Compile(macro_code->second);
-            cache_info.hash = boost::hash_value(macro_code->second);
-        } else {
-            const auto& macro_cached = uploaded_macro_code[mid_method.value()];
-            const auto rebased_method = method - mid_method.value();
-            auto& code = uploaded_macro_code[method];
-            code.resize(macro_cached.size() - rebased_method);
-            std::memcpy(code.data(), macro_cached.data() + rebased_method,
-                        code.size() * sizeof(u32));
-            cache_info.hash = boost::hash_value(code);
-            cache_info.lle_program = Compile(code);
+            UNREACHABLE_MSG("Macro 0x{0:x} was not uploaded", method);
+            return nullptr;
         }
+    }
+    auto& cache_info = macro_cache[method];
+
+    if (!mid_method.has_value()) {
+        cache_info.lle_program = Compile(macro_code->second);
+        cache_info.hash = boost::hash_value(macro_code->second);
+        cache_info.code = macro_code->second;
+    } else {
+        const auto& macro_cached = uploaded_macro_code[mid_method.value()];
+        const auto rebased_method = method - mid_method.value();
+        auto& code = uploaded_macro_code[method];
+        code.resize(macro_cached.size() - rebased_method);
+        std::memcpy(code.data(), macro_cached.data() + rebased_method,
+                    code.size() * sizeof(u32));
+        cache_info.hash = boost::hash_value(code);
+        cache_info.lle_program = Compile(code);
+        cache_info.code = code;
+    }
 
-        auto hle_program = hle_macros->GetHLEProgram(cache_info.hash);
-        if (hle_program.has_value()) {
-            cache_info.has_hle_program = true;
-            cache_info.hle_program = std::move(hle_program.value());
-            cache_info.hle_program->Execute(parameters, method);
-        } else {
-            cache_info.lle_program->Execute(parameters, method);
+    auto hle_program = hle_macros->GetHLEProgram(cache_info.hash, cache_info.code);
+    if (hle_program.has_value()) {
+        cache_info.has_hle_program = true;
+        cache_info.hle_program = std::move(hle_program.value());
+    } else {
+        // Specialize macros that were hot in previous runs without waiting for them to warm up.
+        // This run may call them with a different parameter, so keep watching their calls.
+        cache_info.disk_cache_key = MacroDiskCache::MakeKey(cache_info.code);
+        if (const auto first_parameter = disk_cache.FindSpecialization(cache_info.disk_cache_key)) {
+            cache_info.specialized_program = CompileSpecialized(cache_info.code, *first_parameter);
+            cache_info.specialized_parameter = *first_parameter;
         }
     }
+
+    MacroProfile& profile = profiles[cache_info.hash];
+    profile.hash = cache_info.hash;
+    profile.is_hle = cache_info.has_hle_program;
+    cache_info.profile = &profile;
+    return &cache_info;
+}
+
+CachedMacro& MacroEngine::SelectProgram(CacheInfo& cache_info,
+                                        const std::vector<u32>& parameters) {
+    if (cache_info.has_hle_program) {
+        return *cache_info.hle_program;
+    }
+    if (parameters.empty()) {
+        return *cache_info.lle_program;
+    }
+    const u32 first_parameter = parameters.front();
+    if (cache_info.specialized_program && first_parameter == cache_info.specialized_parameter) {
+        return *cache_info.specialized_program;
+    }
+    if (cache_info.has_tried_specialization) {
+        return *cache_info.lle_program;
+    }
+    if (cache_info.num_constant_calls == 0 || first_parameter != cache_info.first_parameter) {
+        cache_info.first_parameter = first_parameter;
+        cache_info.num_constant_calls = 1;
+        return *cache_info.lle_program;
+    }
+    if (++cache_info.num_constant_calls < SPECIALIZATION_THRESHOLD) {
+        return *cache_info.lle_program;
+    }
+    cache_info.has_tried_specialization = true;
+    std::unique_ptr<CachedMacro> specialized_program =
+        CompileSpecialized(cache_info.code, first_parameter);
+    if (!specialized_program) {
+        return *cache_info.lle_program;
+    }
+    cache_info.specialized_program = std::move(specialized_program);
+    cache_info.specialized_parameter = first_parameter;
+    disk_cache.SaveSpecialization(cache_info.disk_cache_key, first_parameter);
+    return *cache_info.specialized_program;
 }
 
 std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d) {
@@ -9,6 +9,7 @@
 #include <vector>
 #include "common/bit_field.h"
 #include "common/common_types.h"
+#include "video_core/macro/macro_disk_cache.h"
 
 namespace Tegra {
 
@@ -98,6 +99,14 @@ union MethodAddress {
 
 class HLEMacro;
 
+/// Execution statistics of a macro, they show which macros are worth implementing in HLE
+struct MacroProfile {
+    u64 hash{};
+    u64 num_executions{};
+    u64 num_ticks{};
+    bool is_hle{};
+};
+
 class CachedMacro {
 public:
     virtual ~CachedMacro() = default;
@@ -121,20 +130,50 @@ public:
     // Compiles the macro if its not in the cache, and executes the compiled macro
     void Execute(Engines::Maxwell3D& maxwell3d, u32 method, const std::vector<u32>& parameters);
 
+    /// Returns the statistics of the executed macros sorted by the host time spent on them.
+    /// Statistics are only collected when macro profiling is enabled.
+    [[nodiscard]] std::vector<MacroProfile> GetProfile() const;
+
 protected:
     virtual std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) = 0;
 
+    /// Compiles a macro that is only executed when its first parameter is first_parameter.
+    /// Returns null when the backend doesn't specialize macros.
+    virtual std::unique_ptr<CachedMacro> CompileSpecialized(
+        [[maybe_unused]] const std::vector<u32>& code, [[maybe_unused]] u32 first_parameter) {
+        return nullptr;
+    }
+
 private:
     struct CacheInfo {
         std::unique_ptr<CachedMacro> lle_program{};
         std::unique_ptr<CachedMacro> hle_program{};
+        std::unique_ptr<CachedMacro> specialized_program{};
+        std::vector<u32> code{};
+        MacroProfile* profile{};
         u64 hash{};
+        u64 disk_cache_key{};
+        /// First parameter of the current run of calls, and the number of calls in the run
+        u32 first_parameter{};
+        u32 num_constant_calls{};
+        /// First parameter the specialized program was compiled for
+        u32 specialized_parameter{};
         bool has_hle_program{};
+        bool has_tried_specialization{};
     };
 
+    /// Compiles an uploaded macro, returns null when it was not uploaded
+    CacheInfo* CompileMacro(u32 method);
+
+    /// Returns the program to execute with the given parameters, specializing hot macros
+    CachedMacro& SelectProgram(CacheInfo& cache_info, const std::vector<u32>& parameters);
+
     std::unordered_map<u32, CacheInfo> macro_cache;
     std::unordered_map<u32, std::vector<u32>> uploaded_macro_code;
+    std::unordered_map<u64, MacroProfile> profiles;
     std::unique_ptr<HLEMacro> hle_macros;
+    MacroDiskCache disk_cache;
+    bool is_profiling{};
 };
 
 std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d);
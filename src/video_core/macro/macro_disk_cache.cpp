@@ -0,0 +1,176 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+
+#include "common/cityhash.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/thread_worker.h"
+#include "core/settings.h"
+#include "video_core/macro/macro_disk_cache.h"
+
+namespace Tegra {
+
+namespace {
+
+constexpr u32 FILE_MAGIC = 0x434d5a59; // "YZMC"
+
+// Version of the file format, increment when the layout of the file changes
+constexpr u32 FILE_VERSION = 2;
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+struct Entry {
+    u64 key;
+    u32 first_parameter;
+    u32 padding;
+    u64 checksum;
+};
+static_assert(std::is_trivially_copyable_v<Entry>);
+
+/// Returns the checksum of an entry, it covers every field that precedes it
+u64 EntryChecksum(const Entry& entry) {
+    return Common::CityHash64(reinterpret_cast<const char*>(&entry), offsetof(Entry, checksum));
+}
+
+} // Anonymous namespace
+
+MacroDiskCache::MacroDiskCache() {
+    if (!Settings::values.use_disk_shader_cache.GetValue()) {
+        return;
+    }
+    if (!Load()) {
+        LOG_INFO(HW_GPU, "Macro disk cache is invalid, removing");
+        specializations.clear();
+        Invalidate();
+    }
+    writer = std::make_unique<Common::ThreadWorker>(1, "yuzu:MacroDiskCache");
+    is_usable = true;
+}
+
+MacroDiskCache::~MacroDiskCache() = default;
+
+u64 MacroDiskCache::MakeKey(const std::vector<u32>& code) {
+    return Common::CityHash64(reinterpret_cast<const char*>(code.data()),
+                              code.size() * sizeof(u32));
+}
+
+std::optional<u32> MacroDiskCache::FindSpecialization(u64 key) const {
+    const auto it = specializations.find(key);
+    if (it == specializations.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void MacroDiskCache::SaveSpecialization(u64 key, u32 first_parameter) {
+    if (!is_usable) {
+        return;
+    }
+    const auto [it, is_new] = specializations.insert_or_assign(key, first_parameter);
+    if (!is_new && it->second == first_parameter) {
+        return;
+    }
+    writer->QueueWork([this, key, first_parameter, path = GetPath()] {
+        if (!EnsureDirectories()) {
+            return;
+        }
+        const bool existed = Common::FS::Exists(path);
+        Common::FS::IOFile file(path, "ab");
+        if (!file.IsOpen()) {
+            LOG_ERROR(HW_GPU, "Failed to open macro disk cache in path={}", path);
+            return;
+        }
+        if (!existed || file.GetSize() == 0) {
+            const FileHeader header{
+                .magic = FILE_MAGIC,
+                .version = FILE_VERSION,
+            };
+            if (file.WriteObject(header) != 1) {
+                LOG_ERROR(HW_GPU, "Failed to write macro disk cache header in path={}", path);
+                return;
+            }
+        }
+        Entry entry{
+            .key = key,
+            .first_parameter = first_parameter,
+            .padding = 0,
+            .checksum = 0,
+        };
+        entry.checksum = EntryChecksum(entry);
+        if (file.WriteObject(entry) != 1) {
+            LOG_ERROR(HW_GPU, "Failed to write macro disk cache entry={:016X}", key);
+        }
+    });
+}
+
+bool MacroDiskCache::Load() {
+    const std::string path = GetPath();
+    if (!Common::FS::Exists(path)) {
+        LOG_INFO(HW_GPU, "No macro disk cache found");
+        return true;
+    }
+    Common::FS::IOFile file(path, "rb");
+    if (!file.IsOpen()) {
+        return false;
+    }
+    FileHeader header{};
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) || header.magic != FILE_MAGIC) {
+        return false;
+    }
+    if (header.version != FILE_VERSION) {
+        LOG_INFO(HW_GPU, "Macro disk cache is from another version of the emulator");
+        return false;
+    }
+    const u64 file_size = file.GetSize();
+    u64 num_dropped = 0;
+    while (file.Tell() + sizeof(Entry) <= file_size) {
+        Entry entry{};
+        if (file.ReadBytes(&entry, sizeof(entry)) != sizeof(entry)) {
+            return false;
+        }
+        if (entry.checksum != EntryChecksum(entry)) {
+            ++num_dropped;
+            continue;
+        }
+        specializations.insert_or_assign(entry.key, entry.first_parameter);
+    }
+    if (num_dropped != 0) {
+        LOG_WARNING(HW_GPU, "Dropped {} corrupted macro disk cache entries", num_dropped);
+    }
+    LOG_INFO(HW_GPU, "Loaded {} macro specializations from the disk cache",
+             specializations.size());
+    return true;
+}
+
+void MacroDiskCache::Invalidate() {
+    if (!Common::FS::Delete(GetPath())) {
+        LOG_ERROR(HW_GPU, "Failed to invalidate macro disk cache file={}", GetPath());
+    }
+}
+
+bool MacroDiskCache::EnsureDirectories() const {
+    const auto CreateDir = [](const std::string& dir) {
+        if (!Common::FS::CreateDir(dir)) {
+            LOG_ERROR(HW_GPU, "Failed to create directory={}", dir);
+            return false;
+        }
+        return true;
+    };
+    const std::string cache_dir = Common::FS::GetUserPath(Common::FS::UserPath::CacheDir);
+    return CreateDir(cache_dir) && CreateDir(cache_dir + DIR_SEP "macro");
+}
+
+std::string MacroDiskCache::GetPath() const {
+    return Common::FS::SanitizePath(Common::FS::GetUserPath(Common::FS::UserPath::CacheDir) +
+                                    DIR_SEP "macro" DIR_SEP "jit.bin");
+}
+
+} // namespace Tegra
@@ -0,0 +1,60 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Common {
+class ThreadWorker;
+}
+
+namespace Tegra {
+
+/**
+ * Cache of the specialization decisions of the macro JIT, shared by every title since they are
+ * keyed by the macro code. Macros found in the cache are specialized as soon as they are compiled
+ * instead of after warming up. Only decisions are stored, programs are always compiled again so no
+ * executable code is trusted from disk. The whole file is loaded on boot, new decisions are
+ * appended from a worker.
+ */
+class MacroDiskCache {
+public:
+    explicit MacroDiskCache();
+    ~MacroDiskCache();
+
+    /// Returns the key of a macro from its code
+    [[nodiscard]] static u64 MakeKey(const std::vector<u32>& code);
+
+    /// Returns the first parameter the macro was specialized for, if any
+    [[nodiscard]] std::optional<u32> FindSpecialization(u64 key) const;
+
+    /// Saves that the macro was specialized for the given first parameter
+    void SaveSpecialization(u64 key, u32 first_parameter);
+
+private:
+    /// Loads the cache file, returns false when it's invalid
+    bool Load();
+
+    /// Removes the cache file
+    void Invalidate();
+
+    /// Create the cache directories. Returns true on success.
+    bool EnsureDirectories() const;
+
+    /// Gets the cache file path
+    std::string GetPath() const;
+
+    std::unique_ptr<Common::ThreadWorker> writer;
+    std::unordered_map<u64, u32> specializations;
+    bool is_usable = false;
+};
+
+} // namespace Tegra
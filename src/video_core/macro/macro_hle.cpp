@@ -2,10 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
+#include <optional>
 #include <vector>
+#include "common/logging/log.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/macro/macro_hle.h"
+#include "video_core/macro/macro_interpreter.h"
 #include "video_core/rasterizer_interface.h"
 
 namespace Tegra {
@@ -77,6 +81,418 @@ void HLE_0217920100488FF7(Engines::Maxwell3D& maxwell3d, const std::vector<u32>&
     maxwell3d.CallMethodFromMME(0x8e5, 0x0);
     maxwell3d.mme_draw.current_mode = Engines::Maxwell3D::MMEDrawMode::Undefined;
 }
+
+// Number of instructions the matcher executes before giving up on a macro
+constexpr u32 MAX_MATCHED_STEPS = 4096;
+
+/// Value known while matching a macro, it's ((source >> shift) & mask) + offset at runtime.
+/// Constants have a zero mask, so their value is the offset.
+struct SequenceValue {
+    enum class Source : u32 {
+        Constant,
+        Parameter,
+        Read,
+    };
+
+    static SequenceValue Constant(u32 value) {
+        return {.source = Source::Constant, .offset = value};
+    }
+
+    static SequenceValue Variable(Source source, u32 index) {
+        return {.source = source, .index = index, .mask = 0xffffffff};
+    }
+
+    [[nodiscard]] bool IsConstant() const {
+        return source == Source::Constant;
+    }
+
+    Source source = Source::Constant;
+    u32 index = 0;
+    u32 shift = 0;
+    u32 mask = 0;
+    u32 offset = 0;
+};
+
+/// Register read or method call done by a matched macro
+struct SequenceOperation {
+    enum class Type : u32 {
+        Read,
+        Send,
+    };
+
+    Type type;
+    u32 method;
+    SequenceValue value;
+};
+
+/// Methods sent by a macro, in the order it sends them
+struct MethodSequence {
+    std::vector<SequenceOperation> operations;
+    std::size_t num_parameters;
+    std::size_t num_reads;
+};
+
+/**
+ * Executes a macro with the parameters and read registers as unknowns. Branches have to be decided
+ * by constants and method addresses have to be constants, so the macro sends the same methods on
+ * every call and only the values sent change. Parameters and reads may only be moved around, masked
+ * or have their bitfields extracted and have constants added, anything else fails the match.
+ */
+class MethodSequenceMatcher {
+public:
+    explicit MethodSequenceMatcher(const std::vector<u32>& code_) : code{code_} {}
+
+    std::optional<MethodSequence> Match() {
+        registers[1] = SequenceValue::Variable(SequenceValue::Source::Parameter, 0);
+        while (!has_failed && Step(false)) {
+        }
+        if (has_failed) {
+            return std::nullopt;
+        }
+        return MethodSequence{
+            .operations = std::move(operations),
+            .num_parameters = next_parameter_index,
+            .num_reads = num_reads,
+        };
+    }
+
+private:
+    /// Mirrors MacroInterpreterImpl::Step, returns false when the macro exits or fails the match
+    bool Step(bool is_delay_slot) {
+        if (++num_steps > MAX_MATCHED_STEPS || pc % sizeof(u32) != 0 ||
+            pc >= code.size() * sizeof(u32)) {
+            return Fail();
+        }
+        const u32 base_address = pc;
+        const Macro::Opcode opcode{code[pc / sizeof(u32)]};
+        pc += 4;
+
+        if (delayed_pc) {
+            pc = *delayed_pc;
+            delayed_pc = std::nullopt;
+        }
+
+        switch (opcode.operation) {
+        case Macro::Operation::ALU: {
+            const std::optional<SequenceValue> result = GetALUResult(
+                opcode.alu_operation, registers[opcode.src_a], registers[opcode.src_b]);
+            if (!result) {
+                return Fail();
+            }
+            ProcessResult(opcode.result_operation, opcode.dst, *result);
+            break;
+        }
+        case Macro::Operation::AddImmediate: {
+            SequenceValue result = registers[opcode.src_a];
+            result.offset += static_cast<u32>(opcode.immediate.Value());
+            ProcessResult(opcode.result_operation, opcode.dst, result);
+            break;
+        }
+        case Macro::Operation::ExtractInsert: {
+            const std::optional<SequenceValue> result =
+                GetExtractInsertResult(opcode, registers[opcode.src_a], registers[opcode.src_b]);
+            if (!result) {
+                return Fail();
+            }
+            ProcessResult(opcode.result_operation, opcode.dst, *result);
+            break;
+        }
+        case Macro::Operation::ExtractShiftLeftImmediate:
+        case Macro::Operation::ExtractShiftLeftRegister: {
+            const SequenceValue& dst = registers[opcode.src_a];
+            const SequenceValue& src = registers[opcode.src_b];
+            if (!dst.IsConstant() || !src.IsConstant()) {
+                return Fail();
+            }
+            const u32 mask = opcode.GetBitfieldMask();
+            const u32 result = opcode.operation == Macro::Operation::ExtractShiftLeftImmediate
+                                   ? ((src.offset >> dst.offset) & mask) << opcode.bf_dst_bit
+                                   : ((src.offset >> opcode.bf_src_bit) & mask) << dst.offset;
+            ProcessResult(opcode.result_operation, opcode.dst, SequenceValue::Constant(result));
+            break;
+        }
+        case Macro::Operation::Read: {
+            const SequenceValue& address = registers[opcode.src_a];
+            if (!address.IsConstant()) {
+                return Fail();
+            }
+            const u32 method = address.offset + static_cast<u32>(opcode.immediate.Value());
+            if (method >= Engines::Maxwell3D::Regs::NUM_REGS) {
+                return Fail();
+            }
+            operations.push_back({
+                .type = SequenceOperation::Type::Read,
+                .method = method,
+                .value = {},
+            });
+            const SequenceValue result = SequenceValue::Variable(
+                SequenceValue::Source::Read, static_cast<u32>(num_reads++));
+            ProcessResult(opcode.result_operation, opcode.dst, result);
+            break;
+        }
+        case Macro::Operation::Branch: {
+            const SequenceValue& value = registers[opcode.src_a];
+            if (is_delay_slot || !value.IsConstant()) {
+                return Fail();
+            }
+            const bool is_zero = value.offset == 0;
+            const bool taken = opcode.branch_condition == Macro::BranchCondition::Zero
+                                   ? is_zero
+                                   : !is_zero;
+            if (taken) {
+                if (opcode.branch_annul) {
+                    pc = base_address + opcode.GetBranchTarget();
+                    return true;
+                }
+                delayed_pc = base_address + opcode.GetBranchTarget();
+                return Step(true);
+            }
+            break;
+        }
+        default:
+            return Fail();
+        }
+
+        if (opcode.is_exit && !is_delay_slot) {
+            Step(true);
+            return false;
+        }
+        return !has_failed;
+    }
+
+    std::optional<SequenceValue> GetALUResult(Macro::ALUOperation operation,
+                                              const SequenceValue& src_a,
+                                              const SequenceValue& src_b) {
+        if (src_a.IsConstant() && src_b.IsConstant()) {
+            return GetConstantALUResult(operation, src_a.offset, src_b.offset);
+        }
+        // Only operations that leave a variable unchanged or mask it can be matched
+        const bool is_b_variable = !src_b.IsConstant();
+        const SequenceValue& variable = is_b_variable ? src_b : src_a;
+        const u32 constant = is_b_variable ? src_a.offset : src_b.offset;
+        if ((!src_a.IsConstant() && !src_b.IsConstant()) || variable.offset != 0) {
+            return std::nullopt;
+        }
+        switch (operation) {
+        case Macro::ALUOperation::Add:
+        case Macro::ALUOperation::Or:
+        case Macro::ALUOperation::Xor:
+            if (constant != 0) {
+                return std::nullopt;
+            }
+            if (operation == Macro::ALUOperation::Add) {
+                carry_flag = false;
+            }
+            return variable;
+        case Macro::ALUOperation::Subtract:
+            if (is_b_variable || constant != 0) {
+                return std::nullopt;
+            }
+            carry_flag = true;
+            return variable;
+        case Macro::ALUOperation::And: {
+            SequenceValue result = variable;
+            result.mask &= constant;
+            return result;
+        }
+        default:
+            return std::nullopt;
+        }
+    }
+
+    /// The carry flag is always known, variables are only involved in operations with known carry
+    std::optional<SequenceValue> GetConstantALUResult(Macro::ALUOperation operation, u32 src_a,
+                                                      u32 src_b) {
+        switch (operation) {
+        case Macro::ALUOperation::Add:
+        case Macro::ALUOperation::AddWithCarry: {
+            const bool is_carry = operation == Macro::ALUOperation::AddWithCarry;
+            const u64 carry = is_carry && carry_flag ? 1 : 0;
+            const u64 result = static_cast<u64>(src_a) + src_b + carry;
+            carry_flag = result > 0xffffffff;
+            return SequenceValue::Constant(static_cast<u32>(result));
+        }
+        case Macro::ALUOperation::Subtract:
+        case Macro::ALUOperation::SubtractWithBorrow: {
+            const bool is_borrow = operation == Macro::ALUOperation::SubtractWithBorrow;
+            const u64 borrow = is_borrow && !carry_flag ? 1 : 0;
+            const u64 result = static_cast<u64>(src_a) - src_b - borrow;
+            carry_flag = result < 0x100000000;
+            return SequenceValue::Constant(static_cast<u32>(result));
+        }
+        case Macro::ALUOperation::Xor:
+            return SequenceValue::Constant(src_a ^ src_b);
+        case Macro::ALUOperation::Or:
+            return SequenceValue::Constant(src_a | src_b);
+        case Macro::ALUOperation::And:
+            return SequenceValue::Constant(src_a & src_b);
+        case Macro::ALUOperation::AndNot:
+            return SequenceValue::Constant(src_a & ~src_b);
+        case Macro::ALUOperation::Nand:
+            return SequenceValue::Constant(~(src_a & src_b));
+        default:
+            return std::nullopt;
+        }
+    }
+
+    std::optional<SequenceValue> GetExtractInsertResult(Macro::Opcode opcode,
+                                                        const SequenceValue& dst,
+                                                        const SequenceValue& src) const {
+        const u32 mask = opcode.GetBitfieldMask();
+        if (dst.IsConstant() && src.IsConstant()) {
+            const u32 field = (src.offset >> opcode.bf_src_bit) & mask;
+            const u32 result = (dst.offset & ~(mask << opcode.bf_dst_bit)) |
+                               (field << opcode.bf_dst_bit);
+            return SequenceValue::Constant(result);
+        }
+        // Extracting a bitfield into an empty register is the only variable form matched
+        const bool is_extract = dst.IsConstant() && dst.offset == 0 && opcode.bf_dst_bit == 0;
+        if (!is_extract || src.offset != 0) {
+            return std::nullopt;
+        }
+        const u32 shift = src.shift + opcode.bf_src_bit;
+        if (shift >= 32) {
+            return SequenceValue::Constant(0);
+        }
+        SequenceValue result = src;
+        result.shift = shift;
+        result.mask = (src.mask >> opcode.bf_src_bit) & mask;
+        return result;
+    }
+
+    void ProcessResult(Macro::ResultOperation operation, u32 reg, const SequenceValue& result) {
+        switch (operation) {
+        case Macro::ResultOperation::IgnoreAndFetch:
+            SetRegister(reg, FetchParameter());
+            break;
+        case Macro::ResultOperation::Move:
+            SetRegister(reg, result);
+            break;
+        case Macro::ResultOperation::MoveAndSetMethod:
+            SetRegister(reg, result);
+            SetMethodAddress(result);
+            break;
+        case Macro::ResultOperation::FetchAndSend:
+            SetRegister(reg, FetchParameter());
+            Send(result);
+            break;
+        case Macro::ResultOperation::MoveAndSend:
+            SetRegister(reg, result);
+            Send(result);
+            break;
+        case Macro::ResultOperation::FetchAndSetMethod:
+            SetRegister(reg, FetchParameter());
+            SetMethodAddress(result);
+            break;
+        case Macro::ResultOperation::MoveAndSetMethodFetchAndSend:
+            SetRegister(reg, result);
+            SetMethodAddress(result);
+            Send(FetchParameter());
+            break;
+        case Macro::ResultOperation::MoveAndSetMethodSend:
+            SetRegister(reg, result);
+            SetMethodAddress(result);
+            if (result.IsConstant()) {
+                Send(SequenceValue::Constant((result.offset >> 12) & 0b111111));
+            }
+            break;
+        default:
+            Fail();
+            break;
+        }
+    }
+
+    void SetRegister(u32 reg, const SequenceValue& value) {
+        if (reg != 0) {
+            registers[reg] = value;
+        }
+    }
+
+    void SetMethodAddress(const SequenceValue& address) {
+        if (!address.IsConstant()) {
+            Fail();
+            return;
+        }
+        method_address.raw = address.offset;
+    }
+
+    void Send(const SequenceValue& value) {
+        operations.push_back({
+            .type = SequenceOperation::Type::Send,
+            .method = method_address.address,
+            .value = value,
+        });
+        method_address.address.Assign(method_address.address.Value() +
+                                      method_address.increment.Value());
+    }
+
+    SequenceValue FetchParameter() {
+        return SequenceValue::Variable(SequenceValue::Source::Parameter, next_parameter_index++);
+    }
+
+    bool Fail() {
+        has_failed = true;
+        return false;
+    }
+
+    const std::vector<u32>& code;
+    std::array<SequenceValue, Macro::NUM_MACRO_REGISTERS> registers{};
+    std::vector<SequenceOperation> operations;
+    Macro::MethodAddress method_address{};
+    std::optional<u32> delayed_pc;
+    bool carry_flag = false;
+    std::size_t num_reads = 0;
+    u32 next_parameter_index = 1;
+    u32 num_steps = 0;
+    u32 pc = 0;
+    bool has_failed = false;
+};
+
+/// Replays the methods of a macro matched by MethodSequenceMatcher
+class HLEMethodSequence final : public CachedMacro {
+public:
+    explicit HLEMethodSequence(Engines::Maxwell3D& maxwell3d_, const std::vector<u32>& code_,
+                               MethodSequence sequence_)
+        : maxwell3d{maxwell3d_}, code{code_}, interpreter{maxwell3d_, code},
+          sequence{std::move(sequence_)}, reads(sequence.num_reads) {}
+
+    void Execute(const std::vector<u32>& parameters, u32 method) override {
+        if (parameters.size() != sequence.num_parameters) {
+            // Let the interpreter report macros called with the wrong number of parameters
+            return interpreter.Execute(parameters, method);
+        }
+        std::size_t read_index = 0;
+        for (const SequenceOperation& operation : sequence.operations) {
+            if (operation.type == SequenceOperation::Type::Read) {
+                reads[read_index++] = maxwell3d.GetRegisterValue(operation.method);
+                continue;
+            }
+            maxwell3d.CallMethodFromMME(operation.method, Evaluate(operation.value, parameters));
+        }
+    }
+
+private:
+    u32 Evaluate(const SequenceValue& value, const std::vector<u32>& parameters) const {
+        u32 source = 0;
+        switch (value.source) {
+        case SequenceValue::Source::Constant:
+            break;
+        case SequenceValue::Source::Parameter:
+            source = parameters[value.index];
+            break;
+        case SequenceValue::Source::Read:
+            source = reads[value.index];
+            break;
+        }
+        return ((source >> value.shift) & value.mask) + value.offset;
+    }
+
+    Engines::Maxwell3D& maxwell3d;
+    const std::vector<u32> code;
+    MacroInterpreterImpl interpreter;
+    const MethodSequence sequence;
+    std::vector<u32> reads;
+};
 } // Anonymous namespace
 
 constexpr std::array<std::pair<u64, HLEFunction>, 3> hle_funcs{{
@@ -88,13 +504,20 @@ constexpr std::array<std::pair<u64, HLEFunction>, 3> hle_funcs{{
 HLEMacro::HLEMacro(Engines::Maxwell3D& maxwell3d_) : maxwell3d{maxwell3d_} {}
 HLEMacro::~HLEMacro() = default;
 
-std::optional<std::unique_ptr<CachedMacro>> HLEMacro::GetHLEProgram(u64 hash) const {
+std::optional<std::unique_ptr<CachedMacro>> HLEMacro::GetHLEProgram(
+    u64 hash, const std::vector<u32>& code) const {
     const auto it = std::find_if(hle_funcs.cbegin(), hle_funcs.cend(),
                                  [hash](const auto& pair) { return pair.first == hash; });
-    if (it == hle_funcs.end()) {
+    if (it != hle_funcs.end()) {
+        return std::make_unique<HLEMacroImpl>(maxwell3d, it->second);
+    }
+    std::optional<MethodSequence> sequence = MethodSequenceMatcher{code}.Match();
+    if (!sequence) {
         return std::nullopt;
     }
-    return std::make_unique<HLEMacroImpl>(maxwell3d, it->second);
+    LOG_DEBUG(HW_GPU, "Replacing macro 0x{:016x} with a sequence of {} operations", hash,
+              sequence->operations.size());
+    return std::make_unique<HLEMethodSequence>(maxwell3d, code, std::move(*sequence));
 }
 
 HLEMacroImpl::~HLEMacroImpl() = default;
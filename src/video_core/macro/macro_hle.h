@@ -23,7 +23,15 @@ public:
     explicit HLEMacro(Engines::Maxwell3D& maxwell3d_);
     ~HLEMacro();
 
-    std::optional<std::unique_ptr<CachedMacro>> GetHLEProgram(u64 hash) const;
+    /**
+     * Returns a host implementation of a macro. Known macros are looked up by hash, the rest are
+     * replaced when their code is found to only send a fixed sequence of methods.
+     *
+     * @param hash Hash of the macro code
+     * @param code Code of the macro
+     */
+    std::optional<std::unique_ptr<CachedMacro>> GetHLEProgram(u64 hash,
+                                                             const std::vector<u32>& code) const;
 
 private:
     Engines::Maxwell3D& maxwell3d;
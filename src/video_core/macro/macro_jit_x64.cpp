@@ -32,11 +32,18 @@ MacroJITx64::MacroJITx64(Engines::Maxwell3D& maxwell3d_)
     : MacroEngine{maxwell3d_}, maxwell3d{maxwell3d_} {}
 
 std::unique_ptr<CachedMacro> MacroJITx64::Compile(const std::vector<u32>& code) {
-    return std::make_unique<MacroJITx64Impl>(maxwell3d, code);
+    return std::make_unique<MacroJITx64Impl>(maxwell3d, code, std::nullopt);
 }
 
-MacroJITx64Impl::MacroJITx64Impl(Engines::Maxwell3D& maxwell3d_, const std::vector<u32>& code_)
-    : CodeGenerator{MAX_CODE_SIZE}, code{code_}, maxwell3d{maxwell3d_} {
+std::unique_ptr<CachedMacro> MacroJITx64::CompileSpecialized(const std::vector<u32>& code,
+                                                             u32 first_parameter) {
+    return std::make_unique<MacroJITx64Impl>(maxwell3d, code, first_parameter);
+}
+
+MacroJITx64Impl::MacroJITx64Impl(Engines::Maxwell3D& maxwell3d_, const std::vector<u32>& code_,
+                                 std::optional<u32> first_parameter_)
+    : CodeGenerator{MAX_CODE_SIZE}, first_parameter{first_parameter_}, code{code_},
+      maxwell3d{maxwell3d_} {
     Compile();
 }
 
@@ -196,6 +203,7 @@ void MacroJITx64Impl::Compile_AddImmediate(Macro::Opcode opcode) {
         } else {
             mov(RESULT, opcode.immediate);
         }
+        constant_result = static_cast<u32>(opcode.immediate.Value());
     } else {
         auto result = Compile_GetRegister(opcode.src_a, RESULT);
         if (opcode.immediate > 2) {
@@ -205,6 +213,11 @@ void MacroJITx64Impl::Compile_AddImmediate(Macro::Opcode opcode) {
         } else if (opcode.immediate < 0) {
             sub(result, opcode.immediate * -1);
         }
+        // Only fold the immediates emitted above
+        const auto value = GetConstantRegister(opcode.src_a);
+        if (value && opcode.immediate != 2) {
+            constant_result = *value + static_cast<u32>(opcode.immediate.Value());
+        }
     }
     Compile_ProcessResult(opcode.result_operation, opcode.dst);
 }
@@ -235,6 +248,15 @@ void MacroJITx64Impl::Compile_ExtractInsert(Macro::Opcode opcode) {
         and_(dst, mask);
     }
     or_(dst, src);
+
+    // Fold the cases where the code above matches the bitfield semantics
+    const auto dst_value = GetConstantRegister(opcode.src_a);
+    const auto src_value = GetConstantRegister(opcode.src_b);
+    if (dst_value && src_value && opcode.bf_src_bit != 31 && opcode.bf_dst_bit != 31 &&
+        opcode.bf_size != 31) {
+        const u32 field = (*src_value >> opcode.bf_src_bit) & opcode.GetBitfieldMask();
+        constant_result = (*dst_value & mask) | (field << opcode.bf_dst_bit);
+    }
     Compile_ProcessResult(opcode.result_operation, opcode.dst);
 }
 
@@ -343,6 +365,16 @@ void Tegra::MacroJITx64Impl::Compile_Branch(Macro::Opcode opcode) {
     const s32 jump_address =
         static_cast<s32>(pc) + static_cast<s32>(opcode.GetBranchTarget() / sizeof(s32));
 
+    if (const auto value = GetConstantRegister(opcode.src_a)) {
+        const bool is_taken = (opcode.branch_condition == Macro::BranchCondition::Zero) ==
+                              (*value == 0);
+        if (!is_taken) {
+            // The branch is never taken, keep executing the following code unconditionally
+            return;
+        }
+    }
+    is_straight_line = false;
+
     Xbyak::Label end;
     auto value = Compile_GetRegister(opcode.src_a, eax);
     test(value, value);
@@ -395,9 +427,10 @@ void Tegra::MacroJITx64Impl::Compile_Branch(Macro::Opcode opcode) {
 void Tegra::MacroJITx64Impl::Optimizer_ScanFlags() {
     optimizer.can_skip_carry = true;
     optimizer.has_delayed_pc = false;
-    for (auto raw_op : code) {
+    optimizer.first_branch_target = static_cast<u32>(code.size());
+    for (std::size_t index = 0; index < code.size(); ++index) {
         Macro::Opcode op{};
-        op.raw = raw_op;
+        op.raw = code[index];
 
         if (op.operation == Macro::Operation::ALU) {
             // Scan for any ALU operations which actually use the carry flag, if they don't exist in
@@ -412,6 +445,12 @@ void Tegra::MacroJITx64Impl::Optimizer_ScanFlags() {
             if (!op.branch_annul) {
                 optimizer.has_delayed_pc = true;
             }
+            // Code after the first branch target can be reached with different register values
+            const s64 target =
+                static_cast<s64>(index) + op.GetBranchTarget() / static_cast<s32>(sizeof(u32));
+            if (target >= 0 && target < static_cast<s64>(optimizer.first_branch_target)) {
+                optimizer.first_branch_target = static_cast<u32>(target);
+            }
         }
     }
 }
@@ -428,7 +467,16 @@ void MacroJITx64Impl::Compile() {
     xor_(METHOD_ADDRESS, METHOD_ADDRESS);
     xor_(BRANCH_HOLDER, BRANCH_HOLDER);
 
-    mov(dword[STATE + offsetof(JITState, registers) + 4], Compile_FetchParameter());
+    if (first_parameter) {
+        // Specialized programs assume the value of the first parameter, it's checked by the caller
+        add(PARAMETERS, sizeof(u32));
+        mov(dword[STATE + offsetof(JITState, registers) + 4], *first_parameter);
+    } else {
+        mov(dword[STATE + offsetof(JITState, registers) + 4], Compile_FetchParameter());
+    }
+    constant_registers.fill(std::nullopt);
+    constant_registers[1] = first_parameter;
+    is_straight_line = true;
 
     // Track get register for zero registers and mark it as no-op
     optimizer.zero_reg_skip = true;
@@ -456,6 +504,9 @@ void MacroJITx64Impl::Compile() {
             next_opcode = {};
         }
         pc = i;
+        if (pc >= optimizer.first_branch_target) {
+            is_straight_line = false;
+        }
         Compile_NextInstruction();
     }
 
@@ -552,6 +603,13 @@ Xbyak::Reg32 MacroJITx64Impl::Compile_GetRegister(u32 index, Xbyak::Reg32 dst) {
 }
 
 void MacroJITx64Impl::Compile_ProcessResult(Macro::ResultOperation operation, u32 reg) {
+    // Track the value moved to the register, fetched parameters are not known
+    const bool is_fetch = operation == Macro::ResultOperation::IgnoreAndFetch ||
+                          operation == Macro::ResultOperation::FetchAndSend ||
+                          operation == Macro::ResultOperation::FetchAndSetMethod;
+    constant_registers[reg] = is_fetch ? std::nullopt : constant_result;
+    constant_result = std::nullopt;
+
     const auto SetRegister = [this](u32 reg_index, const Xbyak::Reg32& result) {
         // Register 0 is supposed to always return 0. NOP is implemented as a store to the zero
         // register.
@@ -607,6 +665,16 @@ void MacroJITx64Impl::Compile_ProcessResult(Macro::ResultOperation operation, u3
     }
 }
 
+std::optional<u32> MacroJITx64Impl::GetConstantRegister(u32 index) const {
+    if (index == 0) {
+        return 0;
+    }
+    if (!is_straight_line) {
+        return std::nullopt;
+    }
+    return constant_registers[index];
+}
+
 Macro::Opcode MacroJITx64Impl::GetOpCode() const {
     ASSERT(pc < code.size());
     return {code[pc]};
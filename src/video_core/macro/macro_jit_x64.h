@@ -6,6 +6,7 @@
 
 #include <array>
 #include <bitset>
+#include <optional>
 #include <xbyak.h>
 #include "common/bit_field.h"
 #include "common/common_types.h"
@@ -28,13 +29,19 @@ public:
 protected:
     std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) override;
 
+    std::unique_ptr<CachedMacro> CompileSpecialized(const std::vector<u32>& code,
+                                                    u32 first_parameter) override;
+
 private:
     Engines::Maxwell3D& maxwell3d;
 };
 
 class MacroJITx64Impl : public Xbyak::CodeGenerator, public CachedMacro {
 public:
-    explicit MacroJITx64Impl(Engines::Maxwell3D& maxwell3d_, const std::vector<u32>& code_);
+    /// Compiles the macro, specializing it for a constant first parameter when one is given
+    explicit MacroJITx64Impl(Engines::Maxwell3D& maxwell3d_, const std::vector<u32>& code_,
+                             std::optional<u32> first_parameter_);
+
     ~MacroJITx64Impl();
 
     void Execute(const std::vector<u32>& parameters, u32 method) override;
@@ -59,6 +66,9 @@ private:
     void Compile_ProcessResult(Macro::ResultOperation operation, u32 reg);
     void Compile_Send(Xbyak::Reg32 value);
 
+    /// Returns the value of a register when it's known at compile time
+    std::optional<u32> GetConstantRegister(u32 index) const;
+
     Macro::Opcode GetOpCode() const;
     std::bitset<32> PersistentCallerSavedRegs() const;
 
@@ -77,9 +87,17 @@ private:
         bool skip_dummy_addimmediate{};
         bool optimize_for_method_move{};
         bool enable_asserts{};
+        u32 first_branch_target{};
     };
     OptimizerState optimizer{};
 
+    /// Register values known at compile time, only tracked on the code executed unconditionally
+    /// from the start of the macro, as registers are only constant up to the first control flow.
+    std::array<std::optional<u32>, Macro::NUM_MACRO_REGISTERS> constant_registers{};
+    std::optional<u32> constant_result;
+    std::optional<u32> first_parameter;
+    bool is_straight_line{};
+
     std::optional<Macro::Opcode> next_opcode{};
     ProgramType program{nullptr};
 
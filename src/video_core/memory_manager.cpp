@@ -8,6 +8,7 @@
 #include "core/hle/kernel/memory/page_table.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
+#include "video_core/command_capture.h"
 #include "video_core/gpu.h"
 #include "video_core/memory_manager.h"
 #include "video_core/rasterizer_interface.h"
@@ -15,8 +16,7 @@
 
 namespace Tegra {
 
-MemoryManager::MemoryManager(Core::System& system_)
-    : system{system_}, page_table(page_table_size) {}
+MemoryManager::MemoryManager(Core::System& system_) : system{system_} {}
 
 MemoryManager::~MemoryManager() = default;
 
@@ -24,6 +24,10 @@ void MemoryManager::BindRasterizer(VideoCore::RasterizerInterface& rasterizer_)
     rasterizer = &rasterizer_;
 }
 
+void MemoryManager::BindCommandRecorder(CommandRecorder& recorder) {
+    command_recorder = &recorder;
+}
+
 GPUVAddr MemoryManager::UpdateRange(GPUVAddr gpu_addr, PageEntry page_entry, std::size_t size) {
     u64 remaining_size{size};
     for (u64 offset{}; offset < size; offset += page_size) {
@@ -38,6 +42,9 @@ GPUVAddr MemoryManager::UpdateRange(GPUVAddr gpu_addr, PageEntry page_entry, std
 }
 
 GPUVAddr MemoryManager::Map(VAddr cpu_addr, GPUVAddr gpu_addr, std::size_t size) {
+    if (command_recorder) {
+        command_recorder->RecordMap(gpu_addr, cpu_addr, size);
+    }
     return UpdateRange(gpu_addr, cpu_addr, size);
 }
 
@@ -62,6 +69,10 @@ void MemoryManager::Unmap(GPUVAddr gpu_addr, std::size_t size) {
 
     rasterizer->UnmapMemory(*cpu_addr, size);
 
+    if (command_recorder) {
+        command_recorder->RecordUnmap(gpu_addr, *cpu_addr, size);
+    }
+
     UpdateRange(gpu_addr, PageEntry::State::Unmapped, size);
 }
 
@@ -72,6 +83,9 @@ std::optional<GPUVAddr> MemoryManager::AllocateFixed(GPUVAddr gpu_addr, std::siz
         }
     }
 
+    if (command_recorder) {
+        command_recorder->RecordMap(gpu_addr, 0, size);
+    }
     return UpdateRange(gpu_addr, PageEntry::State::Allocated, size);
 }
 
@@ -101,8 +115,38 @@ void MemoryManager::TryUnlockPage(PageEntry page_entry, std::size_t size) {
                .IsSuccess());
 }
 
+PageEntry MemoryManager::TranslatePage(GPUVAddr gpu_addr) const {
+    const u64 page_index{PageEntryIndex(gpu_addr)};
+    const u64 cached{
+        translation_cache[page_index % translation_cache_size].load(std::memory_order_relaxed)};
+    if (cached >> 32 == page_index + 1) {
+        return PageEntry{static_cast<PageEntry::State>(static_cast<u32>(cached))};
+    }
+    return CacheTranslation(gpu_addr);
+}
+
+PageEntry MemoryManager::CacheTranslation(GPUVAddr gpu_addr) const {
+    const u64 page_index{PageEntryIndex(gpu_addr)};
+    std::atomic<u64>& cache_entry{translation_cache[page_index % translation_cache_size]};
+    const u64 generation{page_table_generation.load()};
+    const PageEntry page_entry{GetPageEntry(gpu_addr)};
+    cache_entry.store(((page_index + 1) << 32) | page_entry.Raw());
+
+    // The page table may have changed while it was walked, drop the entry in that case
+    if (page_table_generation.load() != generation) {
+        cache_entry.store(0);
+    }
+    return page_entry;
+}
+
 PageEntry MemoryManager::GetPageEntry(GPUVAddr gpu_addr) const {
-    return page_table[PageEntryIndex(gpu_addr)];
+    const std::size_t page_index{PageEntryIndex(gpu_addr)};
+    const PageBlock* const block{
+        page_directory[page_index >> page_block_bits].load(std::memory_order_acquire)};
+    if (!block) {
+        return PageEntry::State::Unmapped;
+    }
+    return (*block)[page_index & page_block_mask];
 }
 
 void MemoryManager::SetPageEntry(GPUVAddr gpu_addr, PageEntry page_entry, std::size_t size) {
@@ -110,12 +154,26 @@ void MemoryManager::SetPageEntry(GPUVAddr gpu_addr, PageEntry page_entry, std::s
     // improper tracking, but should be fixed in the future.
 
     //// Unlock the old page
-    // TryUnlockPage(page_table[PageEntryIndex(gpu_addr)], size);
+    // TryUnlockPage(GetPageEntry(gpu_addr), size);
 
     //// Lock the new page
     // TryLockPage(page_entry, size);
 
-    page_table[PageEntryIndex(gpu_addr)] = page_entry;
+    const std::size_t page_index{PageEntryIndex(gpu_addr)};
+    std::atomic<PageBlock*>& block{page_directory[page_index >> page_block_bits]};
+    if (!block.load(std::memory_order_relaxed)) {
+        if (page_entry.IsUnmapped()) {
+            // Blocks start unmapped, there is no need to allocate one
+            return;
+        }
+        PageBlock* const new_block{page_blocks.emplace_back(std::make_unique<PageBlock>()).get()};
+        block.store(new_block, std::memory_order_release);
+    }
+    (*block.load(std::memory_order_relaxed))[page_index & page_block_mask] = page_entry;
+
+    // Invalidate the cached translation after the page table has been updated
+    ++page_table_generation;
+    translation_cache[page_index % translation_cache_size].store(0);
 }
 
 std::optional<GPUVAddr> MemoryManager::FindFreeRange(std::size_t size, std::size_t align,
@@ -129,7 +187,17 @@ std::optional<GPUVAddr> MemoryManager::FindFreeRange(std::size_t size, std::size
     u64 available_size{};
     GPUVAddr gpu_addr{start_32bit_address ? address_space_start_low : address_space_start};
     while (gpu_addr + available_size < address_space_size) {
-        if (GetPageEntry(gpu_addr + available_size).IsUnmapped()) {
+        const GPUVAddr current_addr{gpu_addr + available_size};
+        const std::size_t page_index{PageEntryIndex(current_addr)};
+        if (!page_directory[page_index >> page_block_bits].load(std::memory_order_relaxed)) {
+            // Skip the rest of blocks that have never been allocated at once
+            const u64 block_offset{(page_index & page_block_mask) << page_bits};
+            available_size += (page_block_size << page_bits) - block_offset;
+
+            if (available_size >= size) {
+                return gpu_addr;
+            }
+        } else if (GetPageEntry(current_addr).IsUnmapped()) {
             available_size += page_size;
 
             if (available_size >= size) {
@@ -150,7 +218,7 @@ std::optional<GPUVAddr> MemoryManager::FindFreeRange(std::size_t size, std::size
 }
 
 std::optional<VAddr> MemoryManager::GpuToCpuAddress(GPUVAddr gpu_addr) const {
-    const auto page_entry{GetPageEntry(gpu_addr)};
+    const auto page_entry{TranslatePage(gpu_addr)};
     if (!page_entry.IsValid()) {
         return std::nullopt;
     }
@@ -193,140 +261,113 @@ template void MemoryManager::Write<u32>(GPUVAddr addr, u32 data);
 template void MemoryManager::Write<u64>(GPUVAddr addr, u64 data);
 
 u8* MemoryManager::GetPointer(GPUVAddr gpu_addr) {
-    if (!GetPageEntry(gpu_addr).IsValid()) {
-        return {};
-    }
-
-    const auto address{GpuToCpuAddress(gpu_addr)};
-    if (!address) {
+    const auto page_entry{TranslatePage(gpu_addr)};
+    if (!page_entry.IsValid()) {
         return {};
     }
 
-    return system.Memory().GetPointer(*address);
+    return system.Memory().GetPointer(page_entry.ToAddress() + (gpu_addr & page_mask));
 }
 
 const u8* MemoryManager::GetPointer(GPUVAddr gpu_addr) const {
-    if (!GetPageEntry(gpu_addr).IsValid()) {
-        return {};
-    }
-
-    const auto address{GpuToCpuAddress(gpu_addr)};
-    if (!address) {
+    const auto page_entry{TranslatePage(gpu_addr)};
+    if (!page_entry.IsValid()) {
         return {};
     }
 
-    return system.Memory().GetPointer(*address);
+    return system.Memory().GetPointer(page_entry.ToAddress() + (gpu_addr & page_mask));
 }
 
-void MemoryManager::ReadBlock(GPUVAddr gpu_src_addr, void* dest_buffer, std::size_t size) const {
-    std::size_t remaining_size{size};
-    std::size_t page_index{gpu_src_addr >> page_bits};
-    std::size_t page_offset{gpu_src_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-
-        if (const auto page_addr{GpuToCpuAddress(page_index << page_bits)}; page_addr) {
-            const auto src_addr{*page_addr + page_offset};
-
-            // Flush must happen on the rasterizer interface, such that memory is always synchronous
-            // when it is read (even when in asynchronous GPU mode). Fixes Dead Cells title menu.
-            rasterizer->FlushRegion(src_addr, copy_amount);
-            system.Memory().ReadBlockUnsafe(src_addr, dest_buffer, copy_amount);
+template <typename Func>
+void MemoryManager::ForEachCpuRange(GPUVAddr gpu_addr, std::size_t size, Func&& func) const {
+    std::optional<VAddr> run_cpu_addr;
+    std::size_t run_offset{};
+    std::size_t run_size{};
+    std::size_t offset{};
+    while (offset < size) {
+        const GPUVAddr current_gpu_addr{gpu_addr + offset};
+        const std::size_t num_bytes{
+            std::min(page_size - (current_gpu_addr & page_mask), size - offset)};
+        const std::optional<VAddr> cpu_addr{GpuToCpuAddress(current_gpu_addr)};
+
+        // Extend the current run when the page continues it in CPU memory
+        const bool is_contiguous{run_cpu_addr ? cpu_addr == *run_cpu_addr + run_size : !cpu_addr};
+        if (run_size > 0 && !is_contiguous) {
+            func(run_cpu_addr, run_offset, run_size);
+            run_size = 0;
         }
-
-        page_index++;
-        page_offset = 0;
-        dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
+        if (run_size == 0) {
+            run_cpu_addr = cpu_addr;
+            run_offset = offset;
+        }
+        run_size += num_bytes;
+        offset += num_bytes;
+    }
+    if (run_size > 0) {
+        func(run_cpu_addr, run_offset, run_size);
     }
 }
 
+void MemoryManager::ReadBlock(GPUVAddr gpu_src_addr, void* dest_buffer, std::size_t size) const {
+    u8* const dest{static_cast<u8*>(dest_buffer)};
+    ForEachCpuRange(gpu_src_addr, size,
+                    [&](std::optional<VAddr> src_addr, std::size_t offset, std::size_t num_bytes) {
+                        if (!src_addr) {
+                            return;
+                        }
+                        // Flush must happen on the rasterizer interface, such that memory is
+                        // always synchronous when it is read (even when in asynchronous GPU mode).
+                        // Fixes Dead Cells title menu.
+                        rasterizer->FlushRegion(*src_addr, num_bytes);
+                        system.Memory().ReadBlockUnsafe(*src_addr, dest + offset, num_bytes);
+                    });
+}
+
 void MemoryManager::ReadBlockUnsafe(GPUVAddr gpu_src_addr, void* dest_buffer,
                                     const std::size_t size) const {
-    std::size_t remaining_size{size};
-    std::size_t page_index{gpu_src_addr >> page_bits};
-    std::size_t page_offset{gpu_src_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-
-        if (const auto page_addr{GpuToCpuAddress(page_index << page_bits)}; page_addr) {
-            const auto src_addr{*page_addr + page_offset};
-            system.Memory().ReadBlockUnsafe(src_addr, dest_buffer, copy_amount);
-        } else {
-            std::memset(dest_buffer, 0, copy_amount);
-        }
-
-        page_index++;
-        page_offset = 0;
-        dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    u8* const dest{static_cast<u8*>(dest_buffer)};
+    ForEachCpuRange(gpu_src_addr, size,
+                    [&](std::optional<VAddr> src_addr, std::size_t offset, std::size_t num_bytes) {
+                        if (src_addr) {
+                            system.Memory().ReadBlockUnsafe(*src_addr, dest + offset, num_bytes);
+                        } else {
+                            std::memset(dest + offset, 0, num_bytes);
+                        }
+                    });
 }
 
 void MemoryManager::WriteBlock(GPUVAddr gpu_dest_addr, const void* src_buffer, std::size_t size) {
-    std::size_t remaining_size{size};
-    std::size_t page_index{gpu_dest_addr >> page_bits};
-    std::size_t page_offset{gpu_dest_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-
-        if (const auto page_addr{GpuToCpuAddress(page_index << page_bits)}; page_addr) {
-            const auto dest_addr{*page_addr + page_offset};
-
-            // Invalidate must happen on the rasterizer interface, such that memory is always
-            // synchronous when it is written (even when in asynchronous GPU mode).
-            rasterizer->InvalidateRegion(dest_addr, copy_amount);
-            system.Memory().WriteBlockUnsafe(dest_addr, src_buffer, copy_amount);
-        }
-
-        page_index++;
-        page_offset = 0;
-        src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    const u8* const src{static_cast<const u8*>(src_buffer)};
+    ForEachCpuRange(gpu_dest_addr, size,
+                    [&](std::optional<VAddr> dest_addr, std::size_t offset, std::size_t num_bytes) {
+                        if (!dest_addr) {
+                            return;
+                        }
+                        // Invalidate must happen on the rasterizer interface, such that memory is
+                        // always synchronous when it is written (even when in asynchronous GPU
+                        // mode).
+                        rasterizer->InvalidateRegion(*dest_addr, num_bytes);
+                        system.Memory().WriteBlockUnsafe(*dest_addr, src + offset, num_bytes);
+                    });
 }
 
 void MemoryManager::WriteBlockUnsafe(GPUVAddr gpu_dest_addr, const void* src_buffer,
                                      std::size_t size) {
-    std::size_t remaining_size{size};
-    std::size_t page_index{gpu_dest_addr >> page_bits};
-    std::size_t page_offset{gpu_dest_addr & page_mask};
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount{
-            std::min(static_cast<std::size_t>(page_size) - page_offset, remaining_size)};
-
-        if (const auto page_addr{GpuToCpuAddress(page_index << page_bits)}; page_addr) {
-            const auto dest_addr{*page_addr + page_offset};
-            system.Memory().WriteBlockUnsafe(dest_addr, src_buffer, copy_amount);
-        }
-
-        page_index++;
-        page_offset = 0;
-        src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    const u8* const src{static_cast<const u8*>(src_buffer)};
+    ForEachCpuRange(gpu_dest_addr, size,
+                    [&](std::optional<VAddr> dest_addr, std::size_t offset, std::size_t num_bytes) {
+                        if (dest_addr) {
+                            system.Memory().WriteBlockUnsafe(*dest_addr, src + offset, num_bytes);
+                        }
+                    });
 }
 
 void MemoryManager::FlushRegion(GPUVAddr gpu_addr, size_t size) const {
-    size_t remaining_size{size};
-    size_t page_index{gpu_addr >> page_bits};
-    size_t page_offset{gpu_addr & page_mask};
-    while (remaining_size > 0) {
-        const size_t num_bytes{std::min(page_size - page_offset, remaining_size)};
-        if (const auto page_addr{GpuToCpuAddress(page_index << page_bits)}; page_addr) {
-            rasterizer->FlushRegion(*page_addr + page_offset, num_bytes);
+    ForEachCpuRange(gpu_addr, size, [&](std::optional<VAddr> cpu_addr, size_t, size_t num_bytes) {
+        if (cpu_addr) {
+            rasterizer->FlushRegion(*cpu_addr, num_bytes);
         }
-        ++page_index;
-        page_offset = 0;
-        remaining_size -= num_bytes;
-    }
+    });
 }
 
 void MemoryManager::CopyBlock(GPUVAddr gpu_dest_addr, GPUVAddr gpu_src_addr, std::size_t size) {
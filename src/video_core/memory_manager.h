@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -20,6 +23,8 @@ class System;
 
 namespace Tegra {
 
+class CommandRecorder;
+
 class PageEntry final {
 public:
     enum class State : u32 {
@@ -51,6 +56,10 @@ public:
         return static_cast<VAddr>(state) << ShiftBits;
     }
 
+    [[nodiscard]] constexpr u32 Raw() const {
+        return static_cast<u32>(state);
+    }
+
     [[nodiscard]] constexpr PageEntry operator+(u64 offset) const {
         // If this is a reserved value, offsets do not apply
         if (!IsValid()) {
@@ -74,6 +83,9 @@ public:
     /// Binds a renderer to the memory manager.
     void BindRasterizer(VideoCore::RasterizerInterface& rasterizer);
 
+    /// Binds a recorder that is notified of the changes to the address space.
+    void BindCommandRecorder(CommandRecorder& recorder);
+
     [[nodiscard]] std::optional<VAddr> GpuToCpuAddress(GPUVAddr addr) const;
 
     template <typename T>
@@ -121,6 +133,13 @@ public:
     void Unmap(GPUVAddr gpu_addr, std::size_t size);
 
 private:
+    /// Returns the page entry of a GPU address, looking it up in the translation cache first
+    [[nodiscard]] PageEntry TranslatePage(GPUVAddr gpu_addr) const;
+
+    /// Walks the page table for a GPU address and stores the result in the translation cache
+    [[nodiscard]] PageEntry CacheTranslation(GPUVAddr gpu_addr) const;
+
+    /// Returns the page entry of a GPU address walking the page table
     [[nodiscard]] PageEntry GetPageEntry(GPUVAddr gpu_addr) const;
     void SetPageEntry(GPUVAddr gpu_addr, PageEntry page_entry, std::size_t size = page_size);
     GPUVAddr UpdateRange(GPUVAddr gpu_addr, PageEntry page_entry, std::size_t size);
@@ -132,6 +151,15 @@ private:
 
     void FlushRegion(GPUVAddr gpu_addr, size_t size) const;
 
+    /**
+     * Calls 'func' for each run of pages in a GPU range that are backed by contiguous CPU memory.
+     * Unmapped runs are passed with an empty CPU address.
+     * The signature of 'func' is (std::optional<VAddr> cpu_addr, size_t offset, size_t size),
+     * where offset is relative to the start of the GPU range.
+     */
+    template <typename Func>
+    void ForEachCpuRange(GPUVAddr gpu_addr, std::size_t size, Func&& func) const;
+
     [[nodiscard]] static constexpr std::size_t PageEntryIndex(GPUVAddr gpu_addr) {
         return (gpu_addr >> page_bits) & page_table_mask;
     }
@@ -145,12 +173,28 @@ private:
     static constexpr u64 page_table_bits{24};
     static constexpr u64 page_table_size{1 << page_table_bits};
     static constexpr u64 page_table_mask{page_table_size - 1};
+    static constexpr u64 page_block_bits{12};
+    static constexpr u64 page_block_size{1 << page_block_bits};
+    static constexpr u64 page_block_mask{page_block_size - 1};
+    static constexpr u64 page_directory_size{page_table_size / page_block_size};
+    static constexpr u64 translation_cache_size{256};
+
+    /// Second level of the page table, covering a contiguous range of GPU pages
+    using PageBlock = std::array<PageEntry, page_block_size>;
 
     Core::System& system;
 
     VideoCore::RasterizerInterface* rasterizer = nullptr;
+    CommandRecorder* command_recorder = nullptr;
+
+    /// First level of the page table, blocks are allocated the first time they are written
+    std::array<std::atomic<PageBlock*>, page_directory_size> page_directory{};
+    std::vector<std::unique_ptr<PageBlock>> page_blocks;
 
-    std::vector<PageEntry> page_table;
+    /// Direct mapped cache of translated pages, each entry packs the page index plus one in the
+    /// upper 32 bits and the raw page entry in the lower bits. Zero is an empty entry.
+    mutable std::array<std::atomic<u64>, translation_cache_size> translation_cache{};
+    std::atomic<u64> page_table_generation{};
 };
 
 } // namespace Tegra
@@ -0,0 +1,57 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+
+#include "video_core/buffer_cache/buffer_cache.h"
+#include "video_core/renderer_null/null_buffer_cache.h"
+
+namespace Null {
+
+Buffer::Buffer(VAddr cpu_addr_, std::size_t size_) : BufferBlock{cpu_addr_, size_}, data(size_) {}
+
+Buffer::~Buffer() = default;
+
+void Buffer::Upload(std::size_t offset, std::size_t data_size, const u8* data_) {
+    std::memcpy(data.data() + offset, data_, data_size);
+}
+
+void Buffer::Download(std::size_t offset, std::size_t data_size, u8* data_) {
+    std::memcpy(data_, data.data() + offset, data_size);
+}
+
+void Buffer::CopyFrom(const Buffer& src, std::size_t src_offset, std::size_t dst_offset,
+                      std::size_t copy_size) {
+    std::memcpy(data.data() + dst_offset, src.data.data() + src_offset, copy_size);
+}
+
+StreamBuffer::StreamBuffer() = default;
+
+StreamBuffer::~StreamBuffer() = default;
+
+std::pair<u8*, u64> StreamBuffer::Map(u64 size, u64 alignment) {
+    // Nothing reads previous chunks, so every mapping can start at the beginning of the buffer
+    if (data.size() < size) {
+        data.resize(size);
+    }
+    return {data.data(), 0};
+}
+
+BufferCache::BufferCache(VideoCore::RasterizerInterface& rasterizer_,
+                         Tegra::MemoryManager& gpu_memory_, Core::Memory::Memory& cpu_memory_,
+                         StreamBuffer& stream_buffer_)
+    : GenericBufferCache{rasterizer_, gpu_memory_, cpu_memory_, stream_buffer_} {}
+
+BufferCache::~BufferCache() = default;
+
+std::shared_ptr<Buffer> BufferCache::CreateBlock(VAddr cpu_addr, std::size_t size) {
+    return std::make_shared<Buffer>(cpu_addr, size);
+}
+
+BufferCache::BufferInfo BufferCache::GetEmptyBuffer(std::size_t) {
+    return {0, 0, 0};
+}
+
+} // namespace Null
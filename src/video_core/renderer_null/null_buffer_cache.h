@@ -0,0 +1,80 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/buffer_cache/buffer_cache.h"
+
+namespace Null {
+
+class Buffer : public VideoCommon::BufferBlock {
+public:
+    explicit Buffer(VAddr cpu_addr_, std::size_t size_);
+    ~Buffer();
+
+    void Upload(std::size_t offset, std::size_t data_size, const u8* data);
+
+    void Download(std::size_t offset, std::size_t data_size, u8* data);
+
+    void CopyFrom(const Buffer& src, std::size_t src_offset, std::size_t dst_offset,
+                  std::size_t copy_size);
+
+    u32 Handle() const noexcept {
+        return 0;
+    }
+
+    u64 Address() const noexcept {
+        return 0;
+    }
+
+private:
+    std::vector<u8> data;
+};
+
+/// Stream buffer backed by host memory, grows to fit the largest requested chunk.
+class StreamBuffer {
+public:
+    explicit StreamBuffer();
+    ~StreamBuffer();
+
+    /*
+     * Allocates a linear chunk of memory with at least "size" bytes.
+     * The return values are the pointer to the new chunk, and the offset within the buffer.
+     */
+    std::pair<u8*, u64> Map(u64 size, u64 alignment = 0);
+
+    void Unmap(u64 size) {}
+
+    u32 Handle() const noexcept {
+        return 0;
+    }
+
+    u64 Address() const noexcept {
+        return 0;
+    }
+
+private:
+    std::vector<u8> data;
+};
+
+using GenericBufferCache = VideoCommon::BufferCache<Buffer, u32, StreamBuffer>;
+class BufferCache final : public GenericBufferCache {
+public:
+    explicit BufferCache(VideoCore::RasterizerInterface& rasterizer,
+                         Tegra::MemoryManager& gpu_memory, Core::Memory::Memory& cpu_memory,
+                         StreamBuffer& stream_buffer);
+    ~BufferCache();
+
+    BufferInfo GetEmptyBuffer(std::size_t) override;
+
+protected:
+    std::shared_ptr<Buffer> CreateBlock(VAddr cpu_addr, std::size_t size) override;
+};
+
+} // namespace Null
@@ -0,0 +1,39 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+
+#include "video_core/renderer_null/null_fence_manager.h"
+
+namespace Null {
+
+InnerFence::InnerFence(u32 payload_, bool is_stubbed_) : FenceBase{payload_, is_stubbed_} {}
+
+InnerFence::InnerFence(GPUVAddr address_, u32 payload_, bool is_stubbed_)
+    : FenceBase{address_, payload_, is_stubbed_} {}
+
+InnerFence::~InnerFence() = default;
+
+FenceManager::FenceManager(VideoCore::RasterizerInterface& rasterizer_, Tegra::GPU& gpu_,
+                           TextureCache& texture_cache_, BufferCache& buffer_cache_,
+                           QueryCache& query_cache_)
+    : GenericFenceManager{rasterizer_, gpu_, texture_cache_, buffer_cache_, query_cache_} {}
+
+Fence FenceManager::CreateFence(u32 value, bool is_stubbed) {
+    return std::make_shared<InnerFence>(value, is_stubbed);
+}
+
+Fence FenceManager::CreateFence(GPUVAddr addr, u32 value, bool is_stubbed) {
+    return std::make_shared<InnerFence>(addr, value, is_stubbed);
+}
+
+void FenceManager::QueueFence(Fence&) {}
+
+bool FenceManager::IsFenceSignaled(Fence&) const {
+    return true;
+}
+
+void FenceManager::WaitFence(Fence&) {}
+
+} // namespace Null
@@ -0,0 +1,42 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+
+#include "common/common_types.h"
+#include "video_core/fence_manager.h"
+#include "video_core/renderer_null/null_buffer_cache.h"
+#include "video_core/renderer_null/null_query_cache.h"
+#include "video_core/renderer_null/null_texture_cache.h"
+
+namespace Null {
+
+/// Fence without a host counterpart, it's signaled as soon as it's queued.
+class InnerFence : public VideoCommon::FenceBase {
+public:
+    explicit InnerFence(u32 payload_, bool is_stubbed_);
+    explicit InnerFence(GPUVAddr address_, u32 payload_, bool is_stubbed_);
+    ~InnerFence();
+};
+
+using Fence = std::shared_ptr<InnerFence>;
+using GenericFenceManager = VideoCommon::FenceManager<Fence, TextureCache, BufferCache, QueryCache>;
+
+class FenceManager final : public GenericFenceManager {
+public:
+    explicit FenceManager(VideoCore::RasterizerInterface& rasterizer_, Tegra::GPU& gpu_,
+                          TextureCache& texture_cache_, BufferCache& buffer_cache_,
+                          QueryCache& query_cache_);
+
+protected:
+    Fence CreateFence(u32 value, bool is_stubbed) override;
+    Fence CreateFence(GPUVAddr addr, u32 value, bool is_stubbed) override;
+    void QueueFence(Fence& fence) override;
+    bool IsFenceSignaled(Fence& fence) const override;
+    void WaitFence(Fence& fence) override;
+};
+
+} // namespace Null
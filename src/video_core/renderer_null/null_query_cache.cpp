@@ -0,0 +1,41 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <utility>
+
+#include "video_core/renderer_null/null_query_cache.h"
+
+namespace Null {
+
+QueryCache::QueryCache(VideoCore::RasterizerInterface& rasterizer_,
+                       Tegra::Engines::Maxwell3D& maxwell3d_, Tegra::MemoryManager& gpu_memory_)
+    : QueryCacheBase(rasterizer_, maxwell3d_, gpu_memory_) {}
+
+QueryCache::~QueryCache() = default;
+
+HostCounter::HostCounter(QueryCache&, std::shared_ptr<HostCounter> dependency_,
+                         VideoCore::QueryType)
+    : HostCounterBase{std::move(dependency_)} {}
+
+HostCounter::~HostCounter() = default;
+
+u64 HostCounter::BlockingQuery() const {
+    // Report one sample so occlusion queries treat the geometry as visible
+    return 1;
+}
+
+CachedQuery::CachedQuery(QueryCache&, VideoCore::QueryType, VAddr cpu_addr_, u8* host_ptr_)
+    : CachedQueryBase{cpu_addr_, host_ptr_} {}
+
+CachedQuery::~CachedQuery() = default;
+
+CachedQuery::CachedQuery(CachedQuery&& rhs) noexcept : CachedQueryBase(std::move(rhs)) {}
+
+CachedQuery& CachedQuery::operator=(CachedQuery&& rhs) noexcept {
+    CachedQueryBase<HostCounter>::operator=(std::move(rhs));
+    return *this;
+}
+
+} // namespace Null
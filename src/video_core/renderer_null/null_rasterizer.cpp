@@ -0,0 +1,448 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <bitset>
+#include <span>
+#include <type_traits>
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "core/settings.h"
+#include "video_core/engines/kepler_compute.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/shader_type.h"
+#include "video_core/gpu.h"
+#include "video_core/memory_manager.h"
+#include "video_core/renderer_null/null_rasterizer.h"
+#include "video_core/texture_cache/texture_cache.h"
+#include "video_core/textures/texture.h"
+
+namespace Null {
+
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+using Tegra::Engines::ShaderType;
+using VideoCommon::Shader::ConstBuffer;
+using VideoCommon::Shader::ImageEntry;
+using VideoCommon::Shader::SamplerEntry;
+
+MICROPROFILE_DEFINE(Null_Drawing, "Null", "Drawing", MP_RGB(128, 128, 192));
+MICROPROFILE_DEFINE(Null_Compute, "Null", "Compute", MP_RGB(128, 128, 192));
+MICROPROFILE_DEFINE(Null_CacheManagement, "Null", "Cache Mgmt", MP_RGB(100, 255, 100));
+
+namespace {
+
+struct TextureHandle {
+    constexpr TextureHandle(u32 data, bool via_header_index) {
+        const Tegra::Texture::TextureHandle handle{data};
+        image = handle.tic_id;
+        sampler = via_header_index ? image : handle.tsc_id.Value();
+    }
+
+    u32 image;
+    u32 sampler;
+};
+
+template <typename Engine, typename Entry>
+TextureHandle GetTextureInfo(const Engine& engine, bool via_header_index, const Entry& entry,
+                             ShaderType shader_type, size_t index = 0) {
+    if constexpr (std::is_same_v<Entry, SamplerEntry>) {
+        if (entry.is_separated) {
+            const u32 buffer_1 = entry.buffer;
+            const u32 buffer_2 = entry.secondary_buffer;
+            const u32 offset_1 = entry.offset;
+            const u32 offset_2 = entry.secondary_offset;
+            const u32 handle_1 = engine.AccessConstBuffer32(shader_type, buffer_1, offset_1);
+            const u32 handle_2 = engine.AccessConstBuffer32(shader_type, buffer_2, offset_2);
+            return TextureHandle(handle_1 | handle_2, via_header_index);
+        }
+    }
+    if (entry.is_bindless) {
+        const u32 raw = engine.AccessConstBuffer32(shader_type, entry.buffer, entry.offset);
+        return TextureHandle(raw, via_header_index);
+    }
+    const u32 buffer = engine.GetBoundBuffer();
+    const u64 offset = (entry.offset + index) * sizeof(u32);
+    return TextureHandle(engine.AccessConstBuffer32(shader_type, buffer, offset), via_header_index);
+}
+
+std::size_t GetConstBufferSize(const Tegra::Engines::ConstBufferInfo& buffer,
+                               const ConstBuffer& entry) {
+    if (!entry.IsIndirect()) {
+        return entry.GetSize();
+    }
+    if (buffer.size > Maxwell::MaxConstBufferSize) {
+        LOG_WARNING(Render, "Indirect constbuffer size {} exceeds maximum {}", buffer.size,
+                    Maxwell::MaxConstBufferSize);
+        return Maxwell::MaxConstBufferSize;
+    }
+    return buffer.size;
+}
+
+} // Anonymous namespace
+
+RasterizerNull::RasterizerNull(Tegra::GPU& gpu_, Core::Memory::Memory& cpu_memory_)
+    : RasterizerAccelerated(cpu_memory_), gpu(gpu_), maxwell3d(gpu.Maxwell3D()),
+      kepler_compute(gpu.KeplerCompute()), gpu_memory(gpu.MemoryManager()),
+      texture_cache(texture_cache_runtime, *this, maxwell3d, kepler_compute, gpu_memory),
+      shader_cache(*this, maxwell3d, kepler_compute, gpu_memory),
+      query_cache(*this, maxwell3d, gpu_memory),
+      buffer_cache(*this, gpu_memory, cpu_memory_, stream_buffer),
+      fence_manager(*this, gpu, texture_cache, buffer_cache, query_cache) {}
+
+RasterizerNull::~RasterizerNull() = default;
+
+void RasterizerNull::Draw(bool is_indexed, bool is_instanced) {
+    MICROPROFILE_SCOPE(Null_Drawing);
+
+    query_cache.UpdateCounters();
+
+    size_t buffer_size = CalculateVertexArraysSize();
+    if (is_indexed) {
+        buffer_size = Common::AlignUp(buffer_size, 4) + CalculateIndexBufferSize();
+    }
+    // Space for the constant buffers of every stage
+    buffer_size += Maxwell::MaxShaderStage * Maxwell::MaxConstBuffers *
+                   (Maxwell::MaxConstBufferSize + sizeof(u32));
+    buffer_cache.Map(buffer_size);
+
+    SetupVertexAndIndexBuffers(is_indexed);
+
+    auto lock = texture_cache.AcquireLock();
+    SetupShaders();
+
+    buffer_cache.Unmap();
+    texture_cache.UpdateRenderTargets(false);
+    texture_cache.CommitAsyncDecodes();
+    texture_cache.GetFramebuffer();
+
+    gpu.TickWork();
+}
+
+void RasterizerNull::Clear() {
+    if (!maxwell3d.ShouldExecute()) {
+        return;
+    }
+    auto lock = texture_cache.AcquireLock();
+    texture_cache.UpdateRenderTargets(true);
+    texture_cache.GetFramebuffer();
+}
+
+void RasterizerNull::DispatchCompute(GPUVAddr code_addr) {
+    MICROPROFILE_SCOPE(Null_Compute);
+
+    const Shader* const kernel = shader_cache.GetComputeKernel(code_addr);
+
+    auto lock = texture_cache.AcquireLock();
+    image_view_indices.clear();
+    texture_cache.SynchronizeComputeDescriptors();
+    SetupComputeTextures(*kernel);
+    const std::span indices_span(image_view_indices.data(), image_view_indices.size());
+    texture_cache.FillComputeImageViews(indices_span, image_view_ids);
+    texture_cache.CommitAsyncDecodes();
+
+    const size_t buffer_size = Tegra::Engines::KeplerCompute::NumConstBuffers *
+                               (Maxwell::MaxConstBufferSize + sizeof(u32));
+    buffer_cache.Map(buffer_size);
+
+    SetupComputeConstBuffers(*kernel);
+    SetupComputeGlobalMemory(*kernel);
+
+    buffer_cache.Unmap();
+}
+
+void RasterizerNull::ResetCounter(VideoCore::QueryType type) {
+    query_cache.ResetCounter(type);
+}
+
+void RasterizerNull::Query(GPUVAddr gpu_addr, VideoCore::QueryType type,
+                           std::optional<u64> timestamp) {
+    query_cache.Query(gpu_addr, type, timestamp);
+}
+
+void RasterizerNull::FlushAll() {}
+
+void RasterizerNull::FlushRegion(VAddr addr, u64 size) {
+    MICROPROFILE_SCOPE(Null_CacheManagement);
+    if (addr == 0 || size == 0) {
+        return;
+    }
+    {
+        auto lock = texture_cache.AcquireLock();
+        texture_cache.DownloadMemory(addr, size);
+    }
+    buffer_cache.FlushRegion(addr, size);
+    query_cache.FlushRegion(addr, size);
+}
+
+bool RasterizerNull::MustFlushRegion(VAddr addr, u64 size) {
+    if (!Settings::IsGPULevelHigh()) {
+        return buffer_cache.MustFlushRegion(addr, size);
+    }
+    return texture_cache.IsRegionGpuModified(addr, size) ||
+           buffer_cache.MustFlushRegion(addr, size);
+}
+
+void RasterizerNull::InvalidateRegion(VAddr addr, u64 size) {
+    MICROPROFILE_SCOPE(Null_CacheManagement);
+    if (addr == 0 || size == 0) {
+        return;
+    }
+    {
+        auto lock = texture_cache.AcquireLock();
+        texture_cache.WriteMemory(addr, size);
+    }
+    shader_cache.InvalidateRegion(addr, size);
+    buffer_cache.InvalidateRegion(addr, size);
+    query_cache.InvalidateRegion(addr, size);
+}
+
+void RasterizerNull::OnCPUWrite(VAddr addr, u64 size) {
+    MICROPROFILE_SCOPE(Null_CacheManagement);
+    if (addr == 0 || size == 0) {
+        return;
+    }
+    {
+        auto lock = texture_cache.AcquireLock();
+        texture_cache.WriteMemory(addr, size);
+    }
+    shader_cache.OnCPUWrite(addr, size);
+    buffer_cache.OnCPUWrite(addr, size);
+}
+
+void RasterizerNull::SyncGuestHost() {
+    MICROPROFILE_SCOPE(Null_CacheManagement);
+    buffer_cache.SyncGuestHost();
+    shader_cache.SyncGuestHost();
+}
+
+void RasterizerNull::UnmapMemory(VAddr addr, u64 size) {
+    {
+        auto lock = texture_cache.AcquireLock();
+        texture_cache.UnmapMemory(addr, size);
+    }
+    buffer_cache.OnCPUWrite(addr, size);
+    shader_cache.OnCPUWrite(addr, size);
+}
+
+void RasterizerNull::SignalSemaphore(GPUVAddr addr, u32 value) {
+    if (!gpu.IsAsync()) {
+        gpu_memory.Write<u32>(addr, value);
+        return;
+    }
+    fence_manager.SignalSemaphore(addr, value);
+}
+
+void RasterizerNull::SignalSyncPoint(u32 value) {
+    if (!gpu.IsAsync()) {
+        gpu.IncrementSyncPoint(value);
+        return;
+    }
+    fence_manager.SignalSyncPoint(value);
+}
+
+void RasterizerNull::ReleaseFences() {
+    if (!gpu.IsAsync()) {
+        return;
+    }
+    fence_manager.WaitPendingFences();
+}
+
+void RasterizerNull::FlushAndInvalidateRegion(VAddr addr, u64 size) {
+    if (Settings::IsGPULevelExtreme()) {
+        FlushRegion(addr, size);
+    }
+    InvalidateRegion(addr, size);
+}
+
+void RasterizerNull::WaitForIdle() {}
+
+void RasterizerNull::FragmentBarrier() {}
+
+void RasterizerNull::TiledCacheBarrier() {}
+
+void RasterizerNull::FlushCommands() {}
+
+void RasterizerNull::TickFrame() {
+    fence_manager.TickFrame();
+    buffer_cache.TickFrame();
+    {
+        auto lock = texture_cache.AcquireLock();
+        texture_cache.TickFrame();
+    }
+}
+
+bool RasterizerNull::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Surface& src,
+                                           const Tegra::Engines::Fermi2D::Surface& dst,
+                                           const Tegra::Engines::Fermi2D::Config& copy_config) {
+    auto lock = texture_cache.AcquireLock();
+    texture_cache.BlitImage(dst, src, copy_config);
+    return true;
+}
+
+bool RasterizerNull::AccelerateDisplay(const Tegra::FramebufferConfig& config,
+                                       VAddr framebuffer_addr, u32 pixel_stride) {
+    if (framebuffer_addr == 0) {
+        return false;
+    }
+    MICROPROFILE_SCOPE(Null_CacheManagement);
+
+    auto lock = texture_cache.AcquireLock();
+    return texture_cache.TryFindFramebufferImageView(framebuffer_addr) != nullptr;
+}
+
+void RasterizerNull::LoadDiskResources(u64 title_id, const std::atomic_bool& stop_loading,
+                                       const VideoCore::DiskResourceLoadCallback& callback) {
+    texture_cache.LoadDiskResources(title_id, stop_loading);
+}
+
+void RasterizerNull::SetupVertexAndIndexBuffers(bool is_indexed) {
+    const auto& regs = maxwell3d.regs;
+    for (size_t index = 0; index < Maxwell::NumVertexArrays; ++index) {
+        const auto& vertex_array = regs.vertex_array[index];
+        if (!vertex_array.IsEnabled()) {
+            continue;
+        }
+        const GPUVAddr start = vertex_array.StartAddress();
+        const GPUVAddr end = regs.vertex_array_limit[index].LimitAddress();
+        ASSERT(end >= start);
+        if (end == start) {
+            continue;
+        }
+        buffer_cache.UploadMemory(start, end - start);
+    }
+    if (is_indexed) {
+        buffer_cache.UploadMemory(regs.index_array.IndexStart(), CalculateIndexBufferSize());
+    }
+}
+
+void RasterizerNull::SetupShaders() {
+    image_view_indices.clear();
+    texture_cache.SynchronizeGraphicsDescriptors();
+
+    for (size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+        if (!maxwell3d.regs.IsShaderConfigEnabled(index)) {
+            continue;
+        }
+        const auto program = static_cast<Maxwell::ShaderProgram>(index);
+        const Shader* const shader = shader_cache.GetStageProgram(program);
+
+        // Stage indices are 0 - 5
+        const size_t stage = index == 0 ? 0 : index - 1;
+        SetupDrawConstBuffers(stage, *shader);
+        SetupDrawGlobalMemory(stage, *shader);
+        SetupDrawTextures(stage, *shader);
+    }
+    const std::span indices_span(image_view_indices.data(), image_view_indices.size());
+    texture_cache.FillGraphicsImageViews(indices_span, image_view_ids);
+}
+
+void RasterizerNull::SetupDrawConstBuffers(size_t stage_index, const Shader& shader) {
+    const auto& shader_stage = maxwell3d.state.shader_stages[stage_index];
+    for (const auto& [index, entry] : shader.GetIR().GetConstantBuffers()) {
+        SetupConstBuffer(shader_stage.const_buffers[index], entry);
+    }
+}
+
+void RasterizerNull::SetupComputeConstBuffers(const Shader& kernel) {
+    const auto& launch_desc = kepler_compute.launch_description;
+    const std::bitset<8> mask = launch_desc.const_buffer_enable_mask.Value();
+    for (const auto& [index, entry] : kernel.GetIR().GetConstantBuffers()) {
+        const auto& config = launch_desc.const_buffer_config[index];
+        Tegra::Engines::ConstBufferInfo buffer;
+        buffer.address = config.Address();
+        buffer.size = config.size;
+        buffer.enabled = mask[index];
+        SetupConstBuffer(buffer, entry);
+    }
+}
+
+void RasterizerNull::SetupConstBuffer(const Tegra::Engines::ConstBufferInfo& buffer,
+                                      const ConstBuffer& entry) {
+    if (!buffer.enabled) {
+        return;
+    }
+    buffer_cache.UploadMemory(buffer.address, GetConstBufferSize(buffer, entry));
+}
+
+void RasterizerNull::SetupDrawGlobalMemory(size_t stage_index, const Shader& shader) {
+    const auto& cbufs = maxwell3d.state.shader_stages[stage_index];
+    for (const auto& [base, usage] : shader.GetIR().GetGlobalMemory()) {
+        const GPUVAddr addr{cbufs.const_buffers[base.cbuf_index].address + base.cbuf_offset};
+        SetupGlobalMemory(addr, usage.is_written);
+    }
+}
+
+void RasterizerNull::SetupComputeGlobalMemory(const Shader& kernel) {
+    const auto& cbufs = kepler_compute.launch_description.const_buffer_config;
+    for (const auto& [base, usage] : kernel.GetIR().GetGlobalMemory()) {
+        const GPUVAddr addr{cbufs[base.cbuf_index].Address() + base.cbuf_offset};
+        SetupGlobalMemory(addr, usage.is_written);
+    }
+}
+
+void RasterizerNull::SetupGlobalMemory(GPUVAddr addr, bool is_written) {
+    const GPUVAddr gpu_addr{gpu_memory.Read<u64>(addr)};
+    const u32 size{gpu_memory.Read<u32>(addr + 8)};
+    buffer_cache.UploadMemory(gpu_addr, size, 4, is_written);
+}
+
+void RasterizerNull::SetupDrawTextures(size_t stage_index, const Shader& shader) {
+    const bool via_header_index =
+        maxwell3d.regs.sampler_index == Maxwell::SamplerIndex::ViaHeaderIndex;
+    const auto shader_type = static_cast<ShaderType>(stage_index);
+    for (const SamplerEntry& entry : shader.GetIR().GetSamplers()) {
+        for (size_t index = 0; index < entry.size; ++index) {
+            const auto handle =
+                GetTextureInfo(maxwell3d, via_header_index, entry, shader_type, index);
+            texture_cache.GetGraphicsSampler(handle.sampler);
+            image_view_indices.push_back(handle.image);
+        }
+    }
+    for (const ImageEntry& entry : shader.GetIR().GetImages()) {
+        const auto handle = GetTextureInfo(maxwell3d, via_header_index, entry, shader_type);
+        image_view_indices.push_back(handle.image);
+    }
+}
+
+void RasterizerNull::SetupComputeTextures(const Shader& kernel) {
+    const bool via_header_index = kepler_compute.launch_description.linked_tsc;
+    for (const SamplerEntry& entry : kernel.GetIR().GetSamplers()) {
+        for (size_t index = 0; index < entry.size; ++index) {
+            const auto handle = GetTextureInfo(kepler_compute, via_header_index, entry,
+                                               ShaderType::Compute, index);
+            texture_cache.GetComputeSampler(handle.sampler);
+            image_view_indices.push_back(handle.image);
+        }
+    }
+    for (const ImageEntry& entry : kernel.GetIR().GetImages()) {
+        const auto handle =
+            GetTextureInfo(kepler_compute, via_header_index, entry, ShaderType::Compute);
+        image_view_indices.push_back(handle.image);
+    }
+}
+
+size_t RasterizerNull::CalculateVertexArraysSize() const {
+    const auto& regs = maxwell3d.regs;
+    size_t size = 0;
+    for (u32 index = 0; index < Maxwell::NumVertexArrays; ++index) {
+        if (!regs.vertex_array[index].IsEnabled()) {
+            continue;
+        }
+        const GPUVAddr start = regs.vertex_array[index].StartAddress();
+        const GPUVAddr end = regs.vertex_array_limit[index].LimitAddress();
+        ASSERT(end >= start);
+        size += end - start;
+    }
+    return size;
+}
+
+size_t RasterizerNull::CalculateIndexBufferSize() const {
+    return static_cast<size_t>(maxwell3d.regs.index_array.count) *
+           static_cast<size_t>(maxwell3d.regs.index_array.FormatSizeInBytes());
+}
+
+} // namespace Null
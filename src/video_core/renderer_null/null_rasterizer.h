@@ -0,0 +1,131 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+#include <boost/container/static_vector.hpp>
+
+#include "common/common_types.h"
+#include "video_core/engines/const_buffer_info.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/rasterizer_accelerated.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_null/null_buffer_cache.h"
+#include "video_core/renderer_null/null_fence_manager.h"
+#include "video_core/renderer_null/null_query_cache.h"
+#include "video_core/renderer_null/null_shader_cache.h"
+#include "video_core/renderer_null/null_texture_cache.h"
+
+namespace Core::Memory {
+class Memory;
+}
+
+namespace Tegra {
+class MemoryManager;
+}
+
+namespace Null {
+
+/**
+ * Rasterizer that runs the CPU side of the GPU emulation without a host GPU. Guest resources go
+ * through the texture, buffer, shader and query caches as they would on the hardware backends, but
+ * nothing is recorded for or submitted to a GPU. Intended to measure the CPU cost of GPU emulation.
+ */
+class RasterizerNull final : public VideoCore::RasterizerAccelerated {
+public:
+    explicit RasterizerNull(Tegra::GPU& gpu_, Core::Memory::Memory& cpu_memory_);
+    ~RasterizerNull() override;
+
+    void Draw(bool is_indexed, bool is_instanced) override;
+    void Clear() override;
+    void DispatchCompute(GPUVAddr code_addr) override;
+    void ResetCounter(VideoCore::QueryType type) override;
+    void Query(GPUVAddr gpu_addr, VideoCore::QueryType type, std::optional<u64> timestamp) override;
+    void FlushAll() override;
+    void FlushRegion(VAddr addr, u64 size) override;
+    bool MustFlushRegion(VAddr addr, u64 size) override;
+    void InvalidateRegion(VAddr addr, u64 size) override;
+    void OnCPUWrite(VAddr addr, u64 size) override;
+    void SyncGuestHost() override;
+    void UnmapMemory(VAddr addr, u64 size) override;
+    void SignalSemaphore(GPUVAddr addr, u32 value) override;
+    void SignalSyncPoint(u32 value) override;
+    void ReleaseFences() override;
+    void FlushAndInvalidateRegion(VAddr addr, u64 size) override;
+    void WaitForIdle() override;
+    void FragmentBarrier() override;
+    void TiledCacheBarrier() override;
+    void FlushCommands() override;
+    void TickFrame() override;
+    bool AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Surface& src,
+                               const Tegra::Engines::Fermi2D::Surface& dst,
+                               const Tegra::Engines::Fermi2D::Config& copy_config) override;
+    bool AccelerateDisplay(const Tegra::FramebufferConfig& config, VAddr framebuffer_addr,
+                           u32 pixel_stride) override;
+    void LoadDiskResources(u64 title_id, const std::atomic_bool& stop_loading,
+                           const VideoCore::DiskResourceLoadCallback& callback) override;
+
+private:
+    static constexpr size_t MAX_TEXTURES = 192;
+    static constexpr size_t MAX_IMAGES = 48;
+    static constexpr size_t MAX_IMAGE_VIEWS = MAX_TEXTURES + MAX_IMAGES;
+
+    /// Uploads the vertex arrays and the index buffer of the draw
+    void SetupVertexAndIndexBuffers(bool is_indexed);
+
+    /// Decodes the enabled graphics stages and uploads the resources they use
+    void SetupShaders();
+
+    /// Uploads the constant buffers used by a graphics stage
+    void SetupDrawConstBuffers(size_t stage_index, const Shader& shader);
+
+    /// Uploads the constant buffers used by a compute kernel
+    void SetupComputeConstBuffers(const Shader& kernel);
+
+    /// Uploads a constant buffer
+    void SetupConstBuffer(const Tegra::Engines::ConstBufferInfo& buffer,
+                          const VideoCommon::Shader::ConstBuffer& entry);
+
+    /// Uploads the global memory used by a graphics stage
+    void SetupDrawGlobalMemory(size_t stage_index, const Shader& shader);
+
+    /// Uploads the global memory used by a compute kernel
+    void SetupComputeGlobalMemory(const Shader& kernel);
+
+    /// Uploads a global memory region, its address and size are read from a constant buffer
+    void SetupGlobalMemory(GPUVAddr addr, bool is_written);
+
+    /// Collects the textures and images used by a graphics stage
+    void SetupDrawTextures(size_t stage_index, const Shader& shader);
+
+    /// Collects the textures and images used by a compute kernel
+    void SetupComputeTextures(const Shader& kernel);
+
+    size_t CalculateVertexArraysSize() const;
+
+    size_t CalculateIndexBufferSize() const;
+
+    Tegra::GPU& gpu;
+    Tegra::Engines::Maxwell3D& maxwell3d;
+    Tegra::Engines::KeplerCompute& kepler_compute;
+    Tegra::MemoryManager& gpu_memory;
+
+    StreamBuffer stream_buffer;
+    TextureCacheRuntime texture_cache_runtime;
+    TextureCache texture_cache;
+    ShaderCache shader_cache;
+    QueryCache query_cache;
+    BufferCache buffer_cache;
+    FenceManager fence_manager;
+
+    boost::container::static_vector<u32, MAX_IMAGE_VIEWS> image_view_indices;
+    std::array<ImageViewId, MAX_IMAGE_VIEWS> image_view_ids;
+};
+
+} // namespace Null
@@ -0,0 +1,100 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "video_core/engines/kepler_compute.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/memory_manager.h"
+#include "video_core/renderer_null/null_shader_cache.h"
+#include "video_core/shader/compiler_settings.h"
+#include "video_core/shader/ir_cache.h"
+#include "video_core/shader/memory_util.h"
+
+namespace Null {
+
+using Tegra::Engines::ShaderType;
+using VideoCommon::Shader::GetIRCache;
+using VideoCommon::Shader::GetShaderAddress;
+using VideoCommon::Shader::GetShaderCode;
+using VideoCommon::Shader::KERNEL_MAIN_OFFSET;
+using VideoCommon::Shader::ProgramCode;
+using VideoCommon::Shader::STAGE_MAIN_OFFSET;
+
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+namespace {
+
+// Decode as deep as the hardware backends do, so the cost of decoding is representative
+constexpr VideoCommon::Shader::CompilerSettings compiler_settings{
+    .depth = VideoCommon::Shader::CompileDepth::FullDecompile,
+    .disable_else_derivation = true,
+};
+
+} // Anonymous namespace
+
+Shader::Shader(Tegra::Engines::ConstBufferEngineInterface& engine_, ShaderType stage_,
+               ProgramCode code_, u32 main_offset_)
+    : program_code(std::move(code_)), registry(stage_, engine_),
+      shader_ir(GetIRCache().Get(program_code, main_offset_, compiler_settings, registry)) {}
+
+Shader::~Shader() = default;
+
+ShaderCache::ShaderCache(VideoCore::RasterizerInterface& rasterizer_,
+                         Tegra::Engines::Maxwell3D& maxwell3d_,
+                         Tegra::Engines::KeplerCompute& kepler_compute_,
+                         Tegra::MemoryManager& gpu_memory_)
+    : VideoCommon::ShaderCache<Shader>{rasterizer_}, maxwell3d{maxwell3d_},
+      kepler_compute{kepler_compute_}, gpu_memory{gpu_memory_} {}
+
+ShaderCache::~ShaderCache() {
+    // Decoded IR is shared by the whole process, don't keep it alive for the next title
+    GetIRCache().Clear();
+}
+
+Shader* ShaderCache::GetStageProgram(Maxwell::ShaderProgram program) {
+    const GPUVAddr gpu_addr{GetShaderAddress(maxwell3d, program)};
+    const std::optional<VAddr> cpu_addr{gpu_memory.GpuToCpuAddress(gpu_addr)};
+    if (Shader* const shader{cpu_addr ? TryGet(*cpu_addr) : null_shader.get()}) {
+        return shader;
+    }
+    const u8* const host_ptr{gpu_memory.GetPointer(gpu_addr)};
+    ProgramCode code{GetShaderCode(gpu_memory, gpu_addr, host_ptr, false)};
+    const std::size_t size_in_bytes = code.size() * sizeof(u64);
+
+    const std::size_t index = static_cast<std::size_t>(program);
+    const auto stage = static_cast<ShaderType>(index == 0 ? 0 : index - 1);
+    auto shader = std::make_unique<Shader>(maxwell3d, stage, std::move(code), STAGE_MAIN_OFFSET);
+    Shader* const result = shader.get();
+    if (cpu_addr) {
+        Register(std::move(shader), *cpu_addr, size_in_bytes);
+    } else {
+        null_shader = std::move(shader);
+    }
+    return result;
+}
+
+Shader* ShaderCache::GetComputeKernel(GPUVAddr code_addr) {
+    const std::optional<VAddr> cpu_addr{gpu_memory.GpuToCpuAddress(code_addr)};
+    if (Shader* const kernel{cpu_addr ? TryGet(*cpu_addr) : null_kernel.get()}) {
+        return kernel;
+    }
+    const u8* const host_ptr{gpu_memory.GetPointer(code_addr)};
+    ProgramCode code{GetShaderCode(gpu_memory, code_addr, host_ptr, true)};
+    const std::size_t size_in_bytes = code.size() * sizeof(u64);
+
+    auto kernel = std::make_unique<Shader>(kepler_compute, ShaderType::Compute, std::move(code),
+                                           KERNEL_MAIN_OFFSET);
+    Shader* const result = kernel.get();
+    if (cpu_addr) {
+        Register(std::move(kernel), *cpu_addr, size_in_bytes);
+    } else {
+        null_kernel = std::move(kernel);
+    }
+    return result;
+}
+
+} // namespace Null
@@ -0,0 +1,71 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+
+#include "common/common_types.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/shader_type.h"
+#include "video_core/shader/registry.h"
+#include "video_core/shader/shader_ir.h"
+#include "video_core/shader_cache.h"
+
+namespace Tegra {
+class MemoryManager;
+}
+
+namespace Tegra::Engines {
+class KeplerCompute;
+}
+
+namespace VideoCore {
+class RasterizerInterface;
+}
+
+namespace Null {
+
+/// Guest shader decoded to IR, the IR is used to find the resources of the shader.
+class Shader {
+public:
+    explicit Shader(Tegra::Engines::ConstBufferEngineInterface& engine_,
+                    Tegra::Engines::ShaderType stage_, VideoCommon::Shader::ProgramCode code_,
+                    u32 main_offset_);
+    ~Shader();
+
+    const VideoCommon::Shader::ShaderIR& GetIR() const {
+        return *shader_ir;
+    }
+
+private:
+    VideoCommon::Shader::ProgramCode program_code;
+    VideoCommon::Shader::Registry registry;
+    std::shared_ptr<const VideoCommon::Shader::ShaderIR> shader_ir;
+};
+
+class ShaderCache final : public VideoCommon::ShaderCache<Shader> {
+public:
+    explicit ShaderCache(VideoCore::RasterizerInterface& rasterizer_,
+                         Tegra::Engines::Maxwell3D& maxwell3d_,
+                         Tegra::Engines::KeplerCompute& kepler_compute_,
+                         Tegra::MemoryManager& gpu_memory_);
+    ~ShaderCache();
+
+    /// Gets the current specified shader stage program
+    Shader* GetStageProgram(Tegra::Engines::Maxwell3D::Regs::ShaderProgram program);
+
+    /// Gets a compute kernel in the passed address
+    Shader* GetComputeKernel(GPUVAddr code_addr);
+
+private:
+    Tegra::Engines::Maxwell3D& maxwell3d;
+    Tegra::Engines::KeplerCompute& kepler_compute;
+    Tegra::MemoryManager& gpu_memory;
+
+    std::unique_ptr<Shader> null_shader;
+    std::unique_ptr<Shader> null_kernel;
+};
+
+} // namespace Null
@@ -0,0 +1,49 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+
+#include "video_core/renderer_null/null_texture_cache.h"
+#include "video_core/texture_cache/texture_cache.h"
+
+namespace Null {
+
+TextureCacheRuntime::TextureCacheRuntime() = default;
+
+TextureCacheRuntime::~TextureCacheRuntime() = default;
+
+ImageBufferMap TextureCacheRuntime::MapUploadBuffer(size_t size) {
+    if (upload_buffer.size() < size) {
+        upload_buffer.resize(size);
+    }
+    return ImageBufferMap(std::span(upload_buffer.data(), size));
+}
+
+ImageBufferMap TextureCacheRuntime::MapDownloadBuffer(size_t size) {
+    if (download_buffer.size() < size) {
+        download_buffer.resize(size);
+    }
+    return ImageBufferMap(std::span(download_buffer.data(), size));
+}
+
+Image::Image(TextureCacheRuntime&, const VideoCommon::ImageInfo& info_, GPUVAddr gpu_addr_,
+             VAddr cpu_addr_)
+    : VideoCommon::ImageBase(info_, gpu_addr_, cpu_addr_) {}
+
+void Image::DownloadMemory(ImageBufferMap& map, size_t buffer_offset,
+                           std::span<const VideoCommon::BufferImageCopy> copies) {
+    const std::span<u8> span = map.Span().subspan(buffer_offset);
+    for (const VideoCommon::BufferImageCopy& copy : copies) {
+        std::ranges::fill(span.subspan(copy.buffer_offset, copy.buffer_size), u8{0});
+    }
+}
+
+ImageView::ImageView(TextureCacheRuntime&, const VideoCommon::ImageViewInfo& info,
+                     ImageId image_id_, Image& image)
+    : VideoCommon::ImageViewBase{info, image.info, image_id_} {}
+
+ImageView::ImageView(TextureCacheRuntime&, const VideoCommon::NullImageParams& params)
+    : VideoCommon::ImageViewBase{params} {}
+
+} // namespace Null
@@ -0,0 +1,43 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+
+#include "core/frontend/emu_window.h"
+#include "video_core/gpu.h"
+#include "video_core/renderer_null/null_rasterizer.h"
+#include "video_core/renderer_null/renderer_null.h"
+
+namespace Null {
+
+RendererNull::RendererNull(Core::Frontend::EmuWindow& emu_window_,
+                           Core::Memory::Memory& cpu_memory_, Tegra::GPU& gpu_,
+                           std::unique_ptr<Core::Frontend::GraphicsContext> context_)
+    : RendererBase{emu_window_, std::move(context_)}, cpu_memory{cpu_memory_}, gpu{gpu_} {}
+
+RendererNull::~RendererNull() = default;
+
+bool RendererNull::Init() {
+    rasterizer = std::make_unique<RasterizerNull>(gpu, cpu_memory);
+    return true;
+}
+
+void RendererNull::ShutDown() {}
+
+void RendererNull::SwapBuffers(const Tegra::FramebufferConfig* framebuffer) {
+    if (!framebuffer) {
+        return;
+    }
+    // Look up the presented image, so the texture cache sees the same lookups as on a GPU
+    const VAddr framebuffer_addr{framebuffer->address + framebuffer->offset};
+    rasterizer->AccelerateDisplay(*framebuffer, framebuffer_addr, framebuffer->stride);
+
+    ++m_current_frame;
+
+    rasterizer->TickFrame();
+
+    render_window.OnFrameDisplayed();
+}
+
+} // namespace Null
@@ -0,0 +1,44 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+
+#include "video_core/renderer_base.h"
+
+namespace Core::Frontend {
+class EmuWindow;
+class GraphicsContext;
+} // namespace Core::Frontend
+
+namespace Core::Memory {
+class Memory;
+}
+
+namespace Tegra {
+class GPU;
+struct FramebufferConfig;
+} // namespace Tegra
+
+namespace Null {
+
+/// Renderer without a host GPU, guest frames are processed but never presented.
+class RendererNull final : public VideoCore::RendererBase {
+public:
+    explicit RendererNull(Core::Frontend::EmuWindow& emu_window_,
+                          Core::Memory::Memory& cpu_memory_, Tegra::GPU& gpu_,
+                          std::unique_ptr<Core::Frontend::GraphicsContext> context_);
+    ~RendererNull() override;
+
+    bool Init() override;
+    void ShutDown() override;
+    void SwapBuffers(const Tegra::FramebufferConfig* framebuffer) override;
+
+private:
+    Core::Memory::Memory& cpu_memory;
+    Tegra::GPU& gpu;
+};
+
+} // namespace Null
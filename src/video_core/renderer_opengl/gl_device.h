@@ -84,6 +84,10 @@ public:
         return has_astc;
     }
 
+    bool HasS3TC() const {
+        return has_s3tc;
+    }
+
     bool HasVariableAoffi() const {
         return has_variable_aoffi;
     }
@@ -138,6 +142,7 @@ private:
     bool has_texture_shadow_lod{};
     bool has_vertex_buffer_unified_memory{};
     bool has_astc{};
+    bool has_s3tc{};
     bool has_variable_aoffi{};
     bool has_component_indexing_bug{};
     bool has_precise_bug{};
@@ -475,6 +475,7 @@ std::size_t RasterizerOpenGL::CalculateIndexBufferSize() const {
 void RasterizerOpenGL::LoadDiskResources(u64 title_id, const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
     shader_cache.LoadDiskCache(title_id, stop_loading, callback);
+    texture_cache.LoadDiskResources(title_id, stop_loading);
 }
 
 void RasterizerOpenGL::Clear() {
@@ -623,6 +624,7 @@ void RasterizerOpenGL::Draw(bool is_indexed, bool is_instanced) {
     // Signal the buffer cache that we are not going to upload more things.
     buffer_cache.Unmap();
     texture_cache.UpdateRenderTargets(false);
+    texture_cache.CommitAsyncDecodes();
     state_tracker.BindFramebuffer(texture_cache.GetFramebuffer()->Handle());
     program_manager.BindGraphicsPipeline();
 
@@ -682,6 +684,7 @@ void RasterizerOpenGL::DispatchCompute(GPUVAddr code_addr) {
 
     auto lock = texture_cache.AcquireLock();
     BindComputeTextures(kernel);
+    texture_cache.CommitAsyncDecodes();
 
     const size_t buffer_size = Tegra::Engines::KeplerCompute::NumConstBuffers *
                                (Maxwell::MaxConstBufferSize + device.GetUniformBufferAlignment());
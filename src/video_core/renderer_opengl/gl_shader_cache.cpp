@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <optional>
@@ -27,6 +29,7 @@
 #include "video_core/renderer_opengl/gl_shader_decompiler.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
 #include "video_core/renderer_opengl/gl_state_tracker.h"
+#include "video_core/shader/ir_cache.h"
 #include "video_core/shader/memory_util.h"
 #include "video_core/shader/registry.h"
 #include "video_core/shader/shader_ir.h"
@@ -36,6 +39,7 @@
 namespace OpenGL {
 
 using Tegra::Engines::ShaderType;
+using VideoCommon::Shader::GetIRCache;
 using VideoCommon::Shader::GetShaderAddress;
 using VideoCommon::Shader::GetShaderCode;
 using VideoCommon::Shader::GetUniqueIdentifier;
@@ -155,19 +159,25 @@ std::unordered_set<GLenum> GetSupportedFormats() {
     return supported_formats;
 }
 
-} // Anonymous namespace
-
-ProgramSharedPtr BuildShader(const Device& device, ShaderType shader_type, u64 unique_identifier,
-                             const ShaderIR& ir, const Registry& registry, bool hint_retrievable) {
+/// Decompiles a shader to GLSL or to assembly when assembly shaders are used, no context needed
+std::string DecompileProgram(const Device& device, ShaderType shader_type, u64 unique_identifier,
+                             const ShaderIR& ir, const Registry& registry) {
     const std::string shader_id = MakeShaderID(unique_identifier, shader_type);
     LOG_INFO(Render_OpenGL, "{}", shader_id);
 
+    if (device.UseAssemblyShaders()) {
+        return DecompileAssemblyShader(device, ir, registry, shader_type, shader_id);
+    }
+    return DecompileShader(device, ir, registry, shader_type, shader_id);
+}
+
+/// Builds a program from decompiled source, requires a context bound to the calling thread
+ProgramSharedPtr BuildProgram(const Device& device, ShaderType shader_type,
+                              const std::string& source, bool hint_retrievable) {
     auto program = std::make_shared<ProgramHandle>();
 
     if (device.UseAssemblyShaders()) {
-        const std::string arb =
-            DecompileAssemblyShader(device, ir, registry, shader_type, shader_id);
-
+        const std::string& arb = source;
         GLuint& arb_prog = program->assembly_program.handle;
 
 // Commented out functions signal OpenGL errors but are compatible with apitrace.
@@ -187,9 +197,8 @@ ProgramSharedPtr BuildShader(const Device& device, ShaderType shader_type, u64 u
             LOG_INFO(Render_OpenGL, "\n{}", arb);
         }
     } else {
-        const std::string glsl = DecompileShader(device, ir, registry, shader_type, shader_id);
         OGLShader shader;
-        shader.Create(glsl.c_str(), GetGLShaderType(shader_type));
+        shader.Create(source.c_str(), GetGLShaderType(shader_type));
 
         program->source_program.Create(true, hint_retrievable, shader.handle);
     }
@@ -197,6 +206,15 @@ ProgramSharedPtr BuildShader(const Device& device, ShaderType shader_type, u64 u
     return program;
 }
 
+} // Anonymous namespace
+
+ProgramSharedPtr BuildShader(const Device& device, ShaderType shader_type, u64 unique_identifier,
+                             const ShaderIR& ir, const Registry& registry, bool hint_retrievable) {
+    const std::string source =
+        DecompileProgram(device, shader_type, unique_identifier, ir, registry);
+    return BuildProgram(device, shader_type, source, hint_retrievable);
+}
+
 Shader::Shader(std::shared_ptr<Registry> registry_, ShaderEntries entries_,
                ProgramSharedPtr program_, bool is_built_)
     : registry{std::move(registry_)}, entries{std::move(entries_)}, program{std::move(program_)},
@@ -243,14 +261,14 @@ std::unique_ptr<Shader> Shader::CreateStageFromMemory(
 
     auto registry = std::make_shared<Registry>(shader_type, gpu.Maxwell3D());
     if (!async_shaders.IsShaderAsync(gpu) || !params.device.UseAsynchronousShaders()) {
-        const ShaderIR ir(code, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, *registry);
+        const auto ir = GetIRCache().Get(code, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, *registry);
         // TODO(Rodrigo): Handle VertexA shaders
         // std::optional<ShaderIR> ir_b;
         // if (!code_b.empty()) {
         //     ir_b.emplace(code_b, STAGE_MAIN_OFFSET);
         // }
         auto program =
-            BuildShader(params.device, shader_type, params.unique_identifier, ir, *registry);
+            BuildShader(params.device, shader_type, params.unique_identifier, *ir, *registry);
         ShaderDiskCacheEntry entry;
         entry.type = shader_type;
         entry.code = std::move(code);
@@ -266,12 +284,12 @@ std::unique_ptr<Shader> Shader::CreateStageFromMemory(
         gpu.ShaderNotify().MarkShaderComplete();
 
         return std::unique_ptr<Shader>(new Shader(std::move(registry),
-                                                  MakeEntries(params.device, ir, shader_type),
+                                                  MakeEntries(params.device, *ir, shader_type),
                                                   std::move(program), true));
     } else {
-        // Required for entries
-        const ShaderIR ir(code, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, *registry);
-        auto entries = MakeEntries(params.device, ir, shader_type);
+        // Required for entries, the worker reuses the decoded IR from the cache
+        const auto ir = GetIRCache().Get(code, STAGE_MAIN_OFFSET, COMPILER_SETTINGS, *registry);
+        auto entries = MakeEntries(params.device, *ir, shader_type);
 
         async_shaders.QueueOpenGLShader(params.device, shader_type, params.unique_identifier,
                                         std::move(code), std::move(code_b), STAGE_MAIN_OFFSET,
@@ -289,9 +307,9 @@ std::unique_ptr<Shader> Shader::CreateKernelFromMemory(const ShaderParameters& p
     gpu.ShaderNotify().MarkSharderBuilding();
 
     auto registry = std::make_shared<Registry>(ShaderType::Compute, params.engine);
-    const ShaderIR ir(code, KERNEL_MAIN_OFFSET, COMPILER_SETTINGS, *registry);
+    const auto ir = GetIRCache().Get(code, KERNEL_MAIN_OFFSET, COMPILER_SETTINGS, *registry);
     const u64 uid = params.unique_identifier;
-    auto program = BuildShader(params.device, ShaderType::Compute, uid, ir, *registry);
+    auto program = BuildShader(params.device, ShaderType::Compute, uid, *ir, *registry);
 
     ShaderDiskCacheEntry entry;
     entry.type = ShaderType::Compute;
@@ -307,7 +325,7 @@ std::unique_ptr<Shader> Shader::CreateKernelFromMemory(const ShaderParameters& p
     gpu.ShaderNotify().MarkShaderComplete();
 
     return std::unique_ptr<Shader>(new Shader(std::move(registry),
-                                              MakeEntries(params.device, ir, ShaderType::Compute),
+                                              MakeEntries(params.device, *ir, ShaderType::Compute),
                                               std::move(program)));
 }
 
@@ -325,7 +343,10 @@ ShaderCacheOpenGL::ShaderCacheOpenGL(RasterizerOpenGL& rasterizer_,
     : ShaderCache{rasterizer_}, emu_window{emu_window_}, gpu{gpu_}, gpu_memory{gpu_memory_},
       maxwell3d{maxwell3d_}, kepler_compute{kepler_compute_}, device{device_} {}
 
-ShaderCacheOpenGL::~ShaderCacheOpenGL() = default;
+ShaderCacheOpenGL::~ShaderCacheOpenGL() {
+    // Decoded IR is shared by the whole process, don't keep it alive for the next title
+    GetIRCache().Clear();
+}
 
 void ShaderCacheOpenGL::LoadDiskCache(u64 title_id, const std::atomic_bool& stop_loading,
                                       const VideoCore::DiskResourceLoadCallback& callback) {
@@ -351,74 +372,148 @@ void ShaderCacheOpenGL::LoadDiskCache(u64 title_id, const std::atomic_bool& stop
         callback(VideoCore::LoadCallbackStage::Build, 0, transferable->size());
     }
 
+    // Decompilation doesn't need a context, it runs on its own workers that take entries in order
+    // as they become free. Decompiled shaders are queued to the workers owning a shared context,
+    // which only compile and link programs.
+    struct DecompiledShader {
+        const ShaderDiskCacheEntry* entry;
+        const ShaderDiskCachePrecompiled* precompiled;
+        std::shared_ptr<Registry> registry;
+        ShaderEntries entries;
+        std::string source;
+    };
+    const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
+    // Bound the number of queued shaders, so decompiled sources don't pile up in memory when
+    // building programs is slower than decompiling them
+    const std::size_t max_queued_shaders = num_workers * 16;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::condition_variable queue_space_cv;
+    std::deque<DecompiledShader> decompiled_queue;
+    std::size_t num_decompiling = num_workers; // Decompile workers that have not finished yet
+
     std::mutex mutex;
-    std::size_t built_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
+    std::size_t built_shaders = 0; // It doesn't have to be atomic, it's used behind a mutex
     std::atomic_bool gl_cache_failed = false;
+    std::atomic_size_t next_entry = 0;
 
-    const auto find_precompiled = [&gl_cache](u64 id) {
-        return std::find_if(gl_cache.begin(), gl_cache.end(),
-                            [id](const auto& entry) { return entry.unique_identifier == id; });
+    std::unordered_map<u64, const ShaderDiskCachePrecompiled*> precompiled_entries;
+    for (const ShaderDiskCachePrecompiled& precompiled : gl_cache) {
+        precompiled_entries.emplace(precompiled.unique_identifier, &precompiled);
+    }
+    const auto find_precompiled = [&precompiled_entries](u64 id) {
+        const auto it = precompiled_entries.find(id);
+        return it != precompiled_entries.end() ? it->second : nullptr;
     };
 
-    const auto worker = [&](Core::Frontend::GraphicsContext* context, std::size_t begin,
-                            std::size_t end) {
-        const auto scope = context->Acquire();
-
-        for (std::size_t i = begin; i < end; ++i) {
+    const auto decompile_worker = [&] {
+        SCOPE_EXIT({
+            std::scoped_lock lock{queue_mutex};
+            --num_decompiling;
+            queue_cv.notify_all();
+        });
+        for (std::size_t i = next_entry++; i < transferable->size(); i = next_entry++) {
             if (stop_loading) {
                 return;
             }
             const auto& entry = (*transferable)[i];
-            const u64 uid = entry.unique_identifier;
-            const auto it = find_precompiled(uid);
-            const auto precompiled_entry = it != gl_cache.end() ? &*it : nullptr;
-
             const bool is_compute = entry.type == ShaderType::Compute;
             const u32 main_offset = is_compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
-            auto registry = MakeRegistry(entry);
-            const ShaderIR ir(entry.code, main_offset, COMPILER_SETTINGS, *registry);
+
+            DecompiledShader shader;
+            shader.entry = &entry;
+            shader.precompiled = find_precompiled(entry.unique_identifier);
+            shader.registry = MakeRegistry(entry);
+
+            const auto ir =
+                GetIRCache().Get(entry.code, main_offset, COMPILER_SETTINGS, *shader.registry);
+            shader.entries = MakeEntries(device, *ir, entry.type);
+            if (!shader.precompiled) {
+                shader.source = DecompileProgram(device, entry.type, entry.unique_identifier, *ir,
+                                                 *shader.registry);
+            }
+
+            std::unique_lock lock{queue_mutex};
+            queue_space_cv.wait(lock, [&] {
+                return stop_loading || decompiled_queue.size() < max_queued_shaders;
+            });
+            decompiled_queue.push_back(std::move(shader));
+            queue_cv.notify_one();
+        }
+    };
+
+    const auto build_worker = [&](Core::Frontend::GraphicsContext* context) {
+        const auto scope = context->Acquire();
+
+        while (true) {
+            DecompiledShader shader;
+            {
+                std::unique_lock lock{queue_mutex};
+                queue_cv.wait(lock, [&] {
+                    return stop_loading || !decompiled_queue.empty() || num_decompiling == 0;
+                });
+                if (stop_loading || decompiled_queue.empty()) {
+                    // Wake up decompile workers waiting for space, so they see the stop request
+                    queue_space_cv.notify_all();
+                    return;
+                }
+                shader = std::move(decompiled_queue.front());
+                decompiled_queue.pop_front();
+                queue_space_cv.notify_one();
+            }
+            const ShaderDiskCacheEntry& entry = *shader.entry;
 
             ProgramSharedPtr program;
-            if (precompiled_entry) {
+            if (shader.precompiled) {
                 // If the shader is precompiled, attempt to load it with
-                program = GeneratePrecompiledProgram(entry, *precompiled_entry, supported_formats);
+                program = GeneratePrecompiledProgram(entry, *shader.precompiled, supported_formats);
                 if (!program) {
                     gl_cache_failed = true;
                 }
             }
             if (!program) {
-                // Otherwise compile it from GLSL
-                program = BuildShader(device, entry.type, uid, ir, *registry, true);
+                // Otherwise compile it from GLSL, decompiling it here if it was precompiled
+                if (shader.source.empty()) {
+                    const bool is_compute = entry.type == ShaderType::Compute;
+                    const u32 main_offset = is_compute ? KERNEL_MAIN_OFFSET : STAGE_MAIN_OFFSET;
+                    const auto ir = GetIRCache().Get(entry.code, main_offset, COMPILER_SETTINGS,
+                                                     *shader.registry);
+                    shader.source = DecompileProgram(device, entry.type, entry.unique_identifier,
+                                                     *ir, *shader.registry);
+                }
+                program = BuildProgram(device, entry.type, shader.source, true);
             }
 
-            PrecompiledShader shader;
-            shader.program = std::move(program);
-            shader.registry = std::move(registry);
-            shader.entries = MakeEntries(device, ir, entry.type);
+            PrecompiledShader precompiled_shader;
+            precompiled_shader.program = std::move(program);
+            precompiled_shader.registry = std::move(shader.registry);
+            precompiled_shader.entries = std::move(shader.entries);
 
             std::scoped_lock lock{mutex};
             if (callback) {
                 callback(VideoCore::LoadCallbackStage::Build, ++built_shaders,
                          transferable->size());
             }
-            runtime_cache.emplace(entry.unique_identifier, std::move(shader));
+            runtime_cache.emplace(entry.unique_identifier, std::move(precompiled_shader));
         }
     };
 
-    const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
-    const std::size_t bucket_size{transferable->size() / num_workers};
+    std::vector<std::thread> decompile_threads(num_workers);
+    for (auto& thread : decompile_threads) {
+        thread = std::thread(decompile_worker);
+    }
     std::vector<std::unique_ptr<Core::Frontend::GraphicsContext>> contexts(num_workers);
-    std::vector<std::thread> threads(num_workers);
+    std::vector<std::thread> build_threads(num_workers);
     for (std::size_t i = 0; i < num_workers; ++i) {
-        const bool is_last_worker = i + 1 == num_workers;
-        const std::size_t start{bucket_size * i};
-        const std::size_t end{is_last_worker ? transferable->size() : start + bucket_size};
-
         // On some platforms the shared context has to be created from the GUI thread
         contexts[i] = emu_window.CreateSharedContext();
-        threads[i] = std::thread(worker, contexts[i].get(), start, end);
+        build_threads[i] = std::thread(build_worker, contexts[i].get());
+    }
+    for (auto& thread : decompile_threads) {
+        thread.join();
     }
-    for (auto& thread : threads) {
+    for (auto& thread : build_threads) {
         thread.join();
     }
 
@@ -442,8 +537,7 @@ void ShaderCacheOpenGL::LoadDiskCache(u64 title_id, const std::atomic_bool& stop
 
     for (std::size_t i = 0; i < transferable->size(); ++i) {
         const u64 id = (*transferable)[i].unique_identifier;
-        const auto it = find_precompiled(id);
-        if (it == gl_cache.end()) {
+        if (!find_precompiled(id)) {
             const GLuint program = runtime_cache.at(id).program->source_program.handle;
             disk_cache.SavePrecompiled(id, program);
             precompiled_cache_altered = true;
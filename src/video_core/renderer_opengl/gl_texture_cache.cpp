@@ -269,6 +269,13 @@ GLenum AttachmentType(PixelFormat format) {
         return true;
     }
     switch (format) {
+    case PixelFormat::BC1_RGBA_UNORM:
+    case PixelFormat::BC1_RGBA_SRGB:
+    case PixelFormat::BC2_UNORM:
+    case PixelFormat::BC2_SRGB:
+    case PixelFormat::BC3_UNORM:
+    case PixelFormat::BC3_SRGB:
+        return !device.HasS3TC() || type == ImageType::e3D;
     case PixelFormat::BC4_UNORM:
     case PixelFormat::BC5_UNORM:
         return type == ImageType::e3D;
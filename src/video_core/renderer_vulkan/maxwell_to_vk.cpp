@@ -10,6 +10,7 @@
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_vulkan/maxwell_to_vk.h"
 #include "video_core/surface.h"
+#include "video_core/texture_cache/decode_bc.h"
 #include "video_core/vulkan_common/vulkan_device.h"
 #include "video_core/vulkan_common/vulkan_wrapper.h"
 
@@ -231,11 +232,20 @@ FormatInfo SurfaceFormat(const Device& device, FormatType format_type, bool with
         return FormatInfo{VK_FORMAT_A8B8G8R8_UNORM_PACK32, true, true};
     }
 
-    // Use A8B8G8R8_UNORM on hardware that doesn't support ASTC natively
-    if (!device.IsOptimalAstcSupported() && VideoCore::Surface::IsPixelFormatASTC(pixel_format)) {
+    // Use A8B8G8R8_UNORM on hardware that doesn't support ASTC or BCn natively
+    const bool is_emulated_astc =
+        !device.IsOptimalAstcSupported() && VideoCore::Surface::IsPixelFormatASTC(pixel_format);
+    const bool is_emulated_bcn =
+        !device.IsOptimalBcnSupported() && VideoCommon::IsDecodableBCn(pixel_format);
+    if (is_emulated_astc || is_emulated_bcn) {
         const bool is_srgb = with_srgb && VideoCore::Surface::IsPixelFormatSRGB(pixel_format);
+        const bool is_snorm = pixel_format == PixelFormat::BC4_SNORM ||
+                              pixel_format == PixelFormat::BC5_SNORM;
         if (is_srgb) {
             tuple.format = VK_FORMAT_A8B8G8R8_SRGB_PACK32;
+        } else if (is_snorm) {
+            // Signed channels are decoded to signed texels
+            tuple.format = VK_FORMAT_A8B8G8R8_SNORM_PACK32;
         } else {
             tuple.format = VK_FORMAT_A8B8G8R8_UNORM_PACK32;
             tuple.usage |= Storage;
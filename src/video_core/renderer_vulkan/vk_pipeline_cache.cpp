@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "common/bit_cast.h"
@@ -21,10 +23,12 @@
 #include "video_core/renderer_vulkan/vk_descriptor_pool.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/renderer_vulkan/vk_pipeline_disk_cache.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/renderer_vulkan/vk_update_descriptor.h"
 #include "video_core/shader/compiler_settings.h"
+#include "video_core/shader/ir_cache.h"
 #include "video_core/shader/memory_util.h"
 #include "video_core/shader_cache.h"
 #include "video_core/shader_notify.h"
@@ -36,10 +40,12 @@ namespace Vulkan {
 MICROPROFILE_DECLARE(Vulkan_PipelineCache);
 
 using Tegra::Engines::ShaderType;
+using VideoCommon::Shader::GetIRCache;
 using VideoCommon::Shader::GetShaderAddress;
 using VideoCommon::Shader::GetShaderCode;
 using VideoCommon::Shader::KERNEL_MAIN_OFFSET;
 using VideoCommon::Shader::ProgramCode;
+using VideoCommon::Shader::Registry;
 using VideoCommon::Shader::STAGE_MAIN_OFFSET;
 
 namespace {
@@ -118,6 +124,107 @@ u32 FillDescriptorLayout(const ShaderEntries& entries,
     return binding;
 }
 
+Specialization MakeGraphicsSpecialization(const FixedPipelineState& fixed_state) {
+    Specialization specialization;
+    if (fixed_state.topology == Maxwell::PrimitiveTopology::Points) {
+        float point_size;
+        std::memcpy(&point_size, &fixed_state.point_size, sizeof(float));
+        specialization.point_size = point_size;
+        ASSERT(point_size != 0.0f);
+    }
+    for (std::size_t i = 0; i < Maxwell::NumVertexAttributes; ++i) {
+        const auto& attribute = fixed_state.attributes[i];
+        specialization.enabled_attributes[i] = attribute.enabled.Value() != 0;
+        specialization.attribute_types[i] = attribute.Type();
+    }
+    specialization.ndc_minus_one_to_one = fixed_state.ndc_minus_one_to_one;
+    specialization.early_fragment_tests = fixed_state.early_z;
+
+    // Alpha test
+    specialization.alpha_test_func =
+        FixedPipelineState::UnpackComparisonOp(fixed_state.alpha_test_func.Value());
+    specialization.alpha_test_ref = Common::BitCast<float>(fixed_state.alpha_test_ref);
+    return specialization;
+}
+
+Specialization MakeComputeSpecialization(u32 shared_memory_size,
+                                         const std::array<u32, 3>& workgroup_size) {
+    return Specialization{
+        .base_binding = 0,
+        .workgroup_size = workgroup_size,
+        .shared_memory_size = shared_memory_size,
+        .point_size = std::nullopt,
+        .enabled_attributes = {},
+        .attribute_types = {},
+        .ndc_minus_one_to_one = false,
+    };
+}
+
+std::unique_ptr<Registry> MakeRegistry(const ShaderDiskCacheEntry& entry) {
+    const VideoCore::GuestDriverProfile guest_profile{entry.texture_handler_size};
+    const VideoCommon::Shader::SerializedRegistryInfo info{guest_profile, entry.bound_buffer,
+                                                           entry.graphics_info, entry.compute_info};
+    auto registry = std::make_unique<Registry>(entry.type, info);
+    for (const auto& [address, value] : entry.keys) {
+        const auto [buffer, offset] = address;
+        registry->InsertKey(buffer, offset, value);
+    }
+    for (const auto& [offset, sampler] : entry.bound_samplers) {
+        registry->InsertBoundSampler(offset, sampler);
+    }
+    for (const auto& [key, sampler] : entry.separate_samplers) {
+        registry->InsertSeparateSampler(key.buffers, key.offsets, sampler);
+    }
+    for (const auto& [key, sampler] : entry.bindless_samplers) {
+        const auto [buffer, offset] = key;
+        registry->InsertBindlessSampler(buffer, offset, sampler);
+    }
+    return registry;
+}
+
+using DiskShaderMap = std::unordered_map<u64, const ShaderDiskCacheEntry*>;
+
+/// Builds the SPIR-V of a graphics pipeline from the guest code saved in the disk cache
+std::optional<PipelineSPIRV> BuildGraphicsSPIRV(const Device& device, const DiskShaderMap& shaders,
+                                                const GraphicsPipelineDiskCacheEntry& pipeline) {
+    Specialization specialization = MakeGraphicsSpecialization(pipeline.fixed_state);
+    PipelineSPIRV spirv;
+    for (std::size_t stage = 0; stage < Maxwell::MaxShaderStage; ++stage) {
+        const u64 unique_identifier = pipeline.unique_identifiers[stage];
+        if (unique_identifier == 0) {
+            continue;
+        }
+        const auto it = shaders.find(unique_identifier);
+        if (it == shaders.end()) {
+            return std::nullopt;
+        }
+        const ShaderDiskCacheEntry& entry = *it->second;
+        const auto registry = MakeRegistry(entry);
+        const auto ir =
+            GetIRCache().Get(entry.code, STAGE_MAIN_OFFSET, compiler_settings, *registry);
+        spirv[stage] = Decompile(device, *ir, entry.type, *registry, specialization);
+        specialization.base_binding += GenerateShaderEntries(*ir).NumBindings();
+    }
+    return spirv;
+}
+
+/// Builds the SPIR-V of a compute pipeline from the guest code saved in the disk cache
+std::optional<PipelineSPIRV> BuildComputeSPIRV(const Device& device, const DiskShaderMap& shaders,
+                                               const ComputePipelineDiskCacheEntry& pipeline) {
+    const auto it = shaders.find(pipeline.unique_identifier);
+    if (it == shaders.end()) {
+        return std::nullopt;
+    }
+    const ShaderDiskCacheEntry& entry = *it->second;
+    const auto registry = MakeRegistry(entry);
+    const auto ir = GetIRCache().Get(entry.code, KERNEL_MAIN_OFFSET, compiler_settings, *registry);
+    const Specialization specialization =
+        MakeComputeSpecialization(pipeline.shared_memory_size, pipeline.workgroup_size);
+    PipelineSPIRV spirv;
+    spirv[0] = Decompile(device, *ir, ShaderType::Compute, *registry, specialization);
+    return spirv;
+}
+
 } // Anonymous namespace
 
 std::size_t GraphicsPipelineCacheKey::Hash() const noexcept {
@@ -140,12 +247,36 @@ bool ComputePipelineCacheKey::operator==(const ComputePipelineCacheKey& rhs) con
 
 Shader::Shader(Tegra::Engines::ConstBufferEngineInterface& engine_, ShaderType stage_,
                GPUVAddr gpu_addr_, VAddr cpu_addr_, ProgramCode program_code_, u32 main_offset_)
-    : gpu_addr(gpu_addr_), program_code(std::move(program_code_)), registry(stage_, engine_),
-      shader_ir(program_code, main_offset_, compiler_settings, registry),
-      entries(GenerateShaderEntries(shader_ir)) {}
+    : gpu_addr(gpu_addr_), stage(stage_), program_code(std::move(program_code_)),
+      registry(stage_, engine_),
+      shader_ir(GetIRCache().Get(program_code, main_offset_, compiler_settings, registry)),
+      entries(GenerateShaderEntries(*shader_ir)),
+      unique_identifier(PipelineDiskCache::MakeUniqueIdentifier(stage, program_code, registry)) {}
 
 Shader::~Shader() = default;
 
+ShaderDiskCacheEntry Shader::MakeDiskCacheEntry() {
+    const auto& profile = registry.AccessGuestDriverProfile();
+    ShaderDiskCacheEntry entry;
+    entry.unique_identifier = unique_identifier;
+    entry.type = stage;
+    entry.code = program_code;
+    if (profile.IsTextureHandlerSizeKnown()) {
+        entry.texture_handler_size = profile.GetTextureHandlerSize();
+    }
+    entry.bound_buffer = registry.GetBoundBuffer();
+    if (stage == ShaderType::Compute) {
+        entry.compute_info = registry.GetComputeInfo();
+    } else {
+        entry.graphics_info = registry.GetGraphicsInfo();
+    }
+    entry.keys = registry.GetKeys();
+    entry.bound_samplers = registry.GetBoundSamplers();
+    entry.separate_samplers = registry.GetSeparateSamplers();
+    entry.bindless_samplers = registry.GetBindlessSamplers();
+    return entry;
+}
+
 VKPipelineCache::VKPipelineCache(RasterizerVulkan& rasterizer_, Tegra::GPU& gpu_,
                                  Tegra::Engines::Maxwell3D& maxwell3d_,
                                  Tegra::Engines::KeplerCompute& kepler_compute_,
@@ -154,10 +285,13 @@ VKPipelineCache::VKPipelineCache(RasterizerVulkan& rasterizer_, Tegra::GPU& gpu_
                                  VKUpdateDescriptorQueue& update_descriptor_queue_)
     : VideoCommon::ShaderCache<Shader>{rasterizer_}, gpu{gpu_}, maxwell3d{maxwell3d_},
       kepler_compute{kepler_compute_}, gpu_memory{gpu_memory_}, device{device_},
-      scheduler{scheduler_}, descriptor_pool{descriptor_pool_}, update_descriptor_queue{
-                                                                    update_descriptor_queue_} {}
+      scheduler{scheduler_}, descriptor_pool{descriptor_pool_},
+      update_descriptor_queue{update_descriptor_queue_}, disk_cache{device_} {}
 
-VKPipelineCache::~VKPipelineCache() = default;
+VKPipelineCache::~VKPipelineCache() {
+    // Decoded IR is shared by the whole process, don't keep it alive for the next title
+    GetIRCache().Clear();
+}
 
 std::array<Shader*, Maxwell::MaxShaderProgram> VKPipelineCache::GetShaders() {
     std::array<Shader*, Maxwell::MaxShaderProgram> shaders{};
@@ -187,6 +321,9 @@ std::array<Shader*, Maxwell::MaxShaderProgram> VKPipelineCache::GetShaders() {
             auto shader = std::make_unique<Shader>(maxwell3d, stage, gpu_addr, *cpu_addr,
                                                    std::move(code), stage_offset);
             result = shader.get();
+            if (disk_cache.IsEnabled()) {
+                disk_cache.SaveShader(shader->MakeDiskCacheEntry());
+            }
 
             if (cpu_addr) {
                 Register(std::move(shader), *cpu_addr, size_in_bytes);
@@ -265,6 +402,9 @@ VKComputePipeline& VKPipelineCache::GetComputePipeline(const ComputePipelineCach
         auto shader_info = std::make_unique<Shader>(kepler_compute, ShaderType::Compute, gpu_addr,
                                                     *cpu_addr, std::move(code), KERNEL_MAIN_OFFSET);
         shader = shader_info.get();
+        if (disk_cache.IsEnabled()) {
+            disk_cache.SaveShader(shader->MakeDiskCacheEntry());
+        }
 
         if (cpu_addr) {
             Register(std::move(shader_info), *cpu_addr, size_in_bytes);
@@ -273,18 +413,23 @@ VKComputePipeline& VKPipelineCache::GetComputePipeline(const ComputePipelineCach
         }
     }
 
-    const Specialization specialization{
-        .base_binding = 0,
-        .workgroup_size = key.workgroup_size,
+    const ComputePipelineDiskCacheEntry disk_entry{
+        .unique_identifier = shader->GetUniqueIdentifier(),
         .shared_memory_size = key.shared_memory_size,
-        .point_size = std::nullopt,
-        .enabled_attributes = {},
-        .attribute_types = {},
-        .ndc_minus_one_to_one = false,
+        .workgroup_size = key.workgroup_size,
     };
-    const SPIRVShader spirv_shader{Decompile(device, shader->GetIR(), ShaderType::Compute,
-                                             shader->GetRegistry(), specialization),
-                                   shader->GetEntries()};
+    SPIRVShader spirv_shader;
+    spirv_shader.entries = shader->GetEntries();
+    if (const auto it = precompiled_pipelines.find(disk_entry.Hash());
+        it != precompiled_pipelines.end()) {
+        spirv_shader.code = it->second[0];
+    } else {
+        const Specialization specialization =
+            MakeComputeSpecialization(key.shared_memory_size, key.workgroup_size);
+        spirv_shader.code = Decompile(device, shader->GetIR(), ShaderType::Compute,
+                                      shader->GetRegistry(), specialization);
+        disk_cache.SaveComputePipeline(disk_entry, spirv_shader.code);
+    }
     entry = std::make_unique<VKComputePipeline>(device, scheduler, descriptor_pool,
                                                 update_descriptor_queue, spirv_shader);
     return *entry;
@@ -296,6 +441,88 @@ void VKPipelineCache::EmplacePipeline(std::unique_ptr<VKGraphicsPipeline> pipeli
     graphics_cache.at(pipeline->GetCacheKey()) = std::move(pipeline);
 }
 
+void VKPipelineCache::LoadDiskCache(u64 title_id, const std::atomic_bool& stop_loading,
+                                    const VideoCore::DiskResourceLoadCallback& callback) {
+    disk_cache.BindTitleID(title_id);
+    const std::optional transferable = disk_cache.LoadTransferable();
+    if (!transferable) {
+        return;
+    }
+    const auto precompiled = disk_cache.LoadPrecompiled();
+
+    DiskShaderMap shaders;
+    for (const ShaderDiskCacheEntry& entry : transferable->shaders) {
+        shaders.insert_or_assign(entry.unique_identifier, &entry);
+    }
+
+    // Graphics pipelines come first, followed by compute pipelines
+    const std::size_t num_graphics = transferable->graphics_pipelines.size();
+    const std::size_t num_pipelines = num_graphics + transferable->compute_pipelines.size();
+
+    // Inform the frontend about shader build initialization
+    if (callback) {
+        callback(VideoCore::LoadCallbackStage::Build, 0, num_pipelines);
+    }
+
+    std::mutex mutex;
+    std::size_t built_pipelines = 0; // It doesn't have to be atomic, it's used behind a mutex
+    std::size_t rebuilt_pipelines = 0;
+
+    const auto worker = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (stop_loading) {
+                return;
+            }
+            const bool is_graphics = i < num_graphics;
+            const u64 hash = is_graphics
+                                 ? transferable->graphics_pipelines[i].Hash()
+                                 : transferable->compute_pipelines[i - num_graphics].Hash();
+
+            std::optional<PipelineSPIRV> spirv;
+            if (const auto it = precompiled.find(hash); it != precompiled.end()) {
+                spirv = PipelineDiskCache::DecompressSPIRV(it->second);
+            }
+            const bool is_rebuilt = !spirv;
+            if (is_rebuilt) {
+                // SPIR-V was not cached for this build or device, decompile it from guest code
+                spirv = is_graphics
+                            ? BuildGraphicsSPIRV(device, shaders,
+                                                 transferable->graphics_pipelines[i])
+                            : BuildComputeSPIRV(device, shaders,
+                                                transferable->compute_pipelines[i - num_graphics]);
+            }
+
+            std::scoped_lock lock{mutex};
+            if (callback) {
+                callback(VideoCore::LoadCallbackStage::Build, ++built_pipelines, num_pipelines);
+            }
+            if (!spirv) {
+                continue;
+            }
+            if (is_rebuilt) {
+                ++rebuilt_pipelines;
+                disk_cache.SavePrecompiled(hash, *spirv);
+            }
+            precompiled_pipelines.insert_or_assign(hash, std::move(*spirv));
+        }
+    };
+
+    const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
+    const std::size_t bucket_size{num_pipelines / num_workers};
+    std::vector<std::thread> threads(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        const bool is_last_worker = i + 1 == num_workers;
+        const std::size_t start{bucket_size * i};
+        const std::size_t end{is_last_worker ? num_pipelines : start + bucket_size};
+        threads[i] = std::thread(worker, start, end);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    LOG_INFO(Render_Vulkan, "Loaded {} pipelines from the disk cache, {} were decompiled",
+             precompiled_pipelines.size(), rebuilt_pipelines);
+}
+
 void VKPipelineCache::OnShaderRemoval(Shader* shader) {
     bool finished = false;
     const auto Finish = [&] {
@@ -332,44 +559,43 @@ void VKPipelineCache::OnShaderRemoval(Shader* shader) {
 
 std::pair<SPIRVProgram, std::vector<VkDescriptorSetLayoutBinding>>
 VKPipelineCache::DecompileShaders(const FixedPipelineState& fixed_state) {
-    Specialization specialization;
-    if (fixed_state.topology == Maxwell::PrimitiveTopology::Points) {
-        float point_size;
-        std::memcpy(&point_size, &fixed_state.point_size, sizeof(float));
-        specialization.point_size = point_size;
-        ASSERT(point_size != 0.0f);
-    }
-    for (std::size_t i = 0; i < Maxwell::NumVertexAttributes; ++i) {
-        const auto& attribute = fixed_state.attributes[i];
-        specialization.enabled_attributes[i] = attribute.enabled.Value() != 0;
-        specialization.attribute_types[i] = attribute.Type();
-    }
-    specialization.ndc_minus_one_to_one = fixed_state.ndc_minus_one_to_one;
-    specialization.early_fragment_tests = fixed_state.early_z;
-
-    // Alpha test
-    specialization.alpha_test_func =
-        FixedPipelineState::UnpackComparisonOp(fixed_state.alpha_test_func.Value());
-    specialization.alpha_test_ref = Common::BitCast<float>(fixed_state.alpha_test_ref);
-
-    SPIRVProgram program;
-    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    Specialization specialization = MakeGraphicsSpecialization(fixed_state);
 
+    std::array<Shader*, Maxwell::MaxShaderStage> shaders{};
+    GraphicsPipelineDiskCacheEntry disk_entry{};
     for (std::size_t index = 1; index < Maxwell::MaxShaderProgram; ++index) {
-        const auto program_enum = static_cast<Maxwell::ShaderProgram>(index);
         // Skip stages that are not enabled
         if (!maxwell3d.regs.IsShaderConfigEnabled(index)) {
             continue;
         }
+        const auto program_enum = static_cast<Maxwell::ShaderProgram>(index);
         const GPUVAddr gpu_addr = GetShaderAddress(maxwell3d, program_enum);
         const std::optional<VAddr> cpu_addr = gpu_memory.GpuToCpuAddress(gpu_addr);
         Shader* const shader = cpu_addr ? TryGet(*cpu_addr) : null_shader.get();
 
-        const std::size_t stage = index == 0 ? 0 : index - 1; // Stage indices are 0 - 5
+        const std::size_t stage = index - 1; // Stage indices are 0 - 5
+        shaders[stage] = shader;
+        disk_entry.unique_identifiers[stage] = shader->GetUniqueIdentifier();
+    }
+    std::memcpy(&disk_entry.fixed_state, &fixed_state, fixed_state.Size());
+    const auto precompiled = precompiled_pipelines.find(disk_entry.Hash());
+    const bool is_precompiled = precompiled != precompiled_pipelines.end();
+
+    SPIRVProgram program;
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+
+    for (std::size_t stage = 0; stage < Maxwell::MaxShaderStage; ++stage) {
+        Shader* const shader = shaders[stage];
+        if (!shader) {
+            continue;
+        }
+        const auto program_enum = static_cast<Maxwell::ShaderProgram>(stage + 1);
         const ShaderType program_type = GetShaderType(program_enum);
         const auto& entries = shader->GetEntries();
         program[stage] = {
-            Decompile(device, shader->GetIR(), program_type, shader->GetRegistry(), specialization),
+            is_precompiled ? precompiled->second[stage]
+                           : Decompile(device, shader->GetIR(), program_type,
+                                       shader->GetRegistry(), specialization),
             entries,
         };
 
@@ -378,6 +604,15 @@ VKPipelineCache::DecompileShaders(const FixedPipelineState& fixed_state) {
             FillDescriptorLayout(entries, bindings, program_enum, specialization.base_binding);
         ASSERT(old_binding + entries.NumBindings() == specialization.base_binding);
     }
+    if (!is_precompiled && disk_cache.IsEnabled()) {
+        PipelineSPIRV spirv;
+        for (std::size_t stage = 0; stage < Maxwell::MaxShaderStage; ++stage) {
+            if (program[stage]) {
+                spirv[stage] = program[stage]->code;
+            }
+        }
+        disk_cache.SaveGraphicsPipeline(disk_entry, spirv);
+    }
     return {std::move(program), std::move(bindings)};
 }
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <type_traits>
@@ -19,7 +20,9 @@
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_vulkan/fixed_pipeline_state.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
+#include "video_core/renderer_vulkan/vk_pipeline_disk_cache.h"
 #include "video_core/renderer_vulkan/vk_shader_decompiler.h"
+#include "video_core/rasterizer_interface.h"
 #include "video_core/shader/async_shaders.h"
 #include "video_core/shader/memory_util.h"
 #include "video_core/shader/registry.h"
@@ -92,12 +95,16 @@ public:
         return gpu_addr;
     }
 
-    VideoCommon::Shader::ShaderIR& GetIR() {
-        return shader_ir;
+    /// Returns the identifier of the shader code and the registry keys it was decoded with
+    u64 GetUniqueIdentifier() const {
+        return unique_identifier;
     }
 
+    /// Returns a description of the shader to be saved in the pipeline disk cache
+    ShaderDiskCacheEntry MakeDiskCacheEntry();
+
     const VideoCommon::Shader::ShaderIR& GetIR() const {
-        return shader_ir;
+        return *shader_ir;
     }
 
     const VideoCommon::Shader::Registry& GetRegistry() const {
@@ -110,10 +117,12 @@ public:
 
 private:
     GPUVAddr gpu_addr{};
+    Tegra::Engines::ShaderType stage;
     VideoCommon::Shader::ProgramCode program_code;
     VideoCommon::Shader::Registry registry;
-    VideoCommon::Shader::ShaderIR shader_ir;
+    std::shared_ptr<const VideoCommon::Shader::ShaderIR> shader_ir;
     ShaderEntries entries;
+    u64 unique_identifier{};
 };
 
 class VKPipelineCache final : public VideoCommon::ShaderCache<Shader> {
@@ -136,6 +145,10 @@ public:
 
     void EmplacePipeline(std::unique_ptr<VKGraphicsPipeline> pipeline);
 
+    /// Loads the pipeline disk cache of a title, building the SPIR-V that is not cached
+    void LoadDiskCache(u64 title_id, const std::atomic_bool& stop_loading,
+                       const VideoCore::DiskResourceLoadCallback& callback);
+
 protected:
     void OnShaderRemoval(Shader* shader) final;
 
@@ -153,6 +166,9 @@ private:
     VKDescriptorPool& descriptor_pool;
     VKUpdateDescriptorQueue& update_descriptor_queue;
 
+    PipelineDiskCache disk_cache;
+    std::unordered_map<u64, PipelineSPIRV> precompiled_pipelines;
+
     std::unique_ptr<Shader> null_shader;
     std::unique_ptr<Shader> null_kernel;
 
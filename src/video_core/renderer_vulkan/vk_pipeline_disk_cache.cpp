@@ -0,0 +1,636 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+#include <fmt/format.h>
+
+#include "common/cityhash.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/thread_worker.h"
+#include "common/zstd_compression.h"
+#include "core/settings.h"
+#include "video_core/renderer_vulkan/vk_pipeline_disk_cache.h"
+#include "video_core/vulkan_common/vulkan_device.h"
+
+namespace Vulkan {
+
+using Tegra::Engines::SamplerDescriptor;
+using Tegra::Engines::ShaderType;
+using VideoCommon::Shader::Registry;
+using VideoCommon::Shader::SeparateSamplerKey;
+
+namespace {
+
+constexpr u32 TRANSFERABLE_MAGIC = 0x544b5659; // "YVKT"
+constexpr u32 PRECOMPILED_MAGIC = 0x504b5659;  // "YVKP"
+
+// Version of the transferable file, increment when its layout changes
+constexpr u32 TRANSFERABLE_VERSION = 1;
+
+// Version of the precompiled file, increment when its layout changes
+constexpr u32 PRECOMPILED_VERSION = 1;
+
+enum class RecordType : u32 {
+    Shader,
+    GraphicsPipeline,
+    ComputePipeline,
+};
+
+struct TransferableHeader {
+    u32 magic;
+    u32 version;
+};
+static_assert(std::is_trivially_copyable_v<TransferableHeader>);
+
+struct PrecompiledHeader {
+    u32 magic;
+    u32 version;
+    u64 build_hash;
+    u64 device_hash;
+};
+static_assert(std::is_trivially_copyable_v<PrecompiledHeader>);
+
+struct PrecompiledEntryHeader {
+    u64 hash;
+    u32 compressed_size;
+    u32 decompressed_size;
+};
+static_assert(std::is_trivially_copyable_v<PrecompiledEntryHeader>);
+
+struct ConstBufferKey {
+    u32 cbuf = 0;
+    u32 offset = 0;
+    u32 value = 0;
+};
+
+struct BoundSamplerEntry {
+    u32 offset = 0;
+    SamplerDescriptor sampler;
+};
+
+struct SeparateSamplerEntry {
+    u32 cbuf1 = 0;
+    u32 cbuf2 = 0;
+    u32 offset1 = 0;
+    u32 offset2 = 0;
+    SamplerDescriptor sampler;
+};
+
+struct BindlessSamplerEntry {
+    u32 cbuf = 0;
+    u32 offset = 0;
+    SamplerDescriptor sampler;
+};
+
+u64 GetBuildHash() {
+    return Common::CityHash64(Common::g_shader_cache_version,
+                              std::strlen(Common::g_shader_cache_version));
+}
+
+u64 GetDeviceHash(const Device& device) {
+    const std::string_view model_name = device.GetModelName();
+    const u64 seed = (u64{device.GetDriverVersion()} << 32) | u64{device.GetDriverID()};
+    return Common::CityHash64WithSeed(model_name.data(), model_name.size(), seed);
+}
+
+/// Appends registry keys to a list of words, sorted so the result doesn't depend on map order
+template <typename Map, typename Func>
+void AppendSorted(std::vector<u32>& words, const Map& map, Func&& to_words) {
+    std::vector<decltype(to_words(*map.begin()))> flat;
+    flat.reserve(map.size());
+    for (const auto& pair : map) {
+        flat.push_back(to_words(pair));
+    }
+    std::sort(flat.begin(), flat.end());
+    words.push_back(static_cast<u32>(flat.size()));
+    for (const auto& entry : flat) {
+        words.insert(words.end(), entry.begin(), entry.end());
+    }
+}
+
+} // Anonymous namespace
+
+ShaderDiskCacheEntry::ShaderDiskCacheEntry() = default;
+
+ShaderDiskCacheEntry::~ShaderDiskCacheEntry() = default;
+
+bool ShaderDiskCacheEntry::Load(Common::FS::IOFile& file) {
+    u32 type_value;
+    u32 code_size;
+    u8 is_texture_handler_size_known;
+    u32 texture_handler_size_value;
+    if (file.ReadArray(&unique_identifier, 1) != 1 || file.ReadArray(&type_value, 1) != 1 ||
+        file.ReadArray(&code_size, 1) != 1) {
+        return false;
+    }
+    type = static_cast<ShaderType>(type_value);
+    code.resize(code_size);
+    if (file.ReadArray(code.data(), code.size()) != code.size()) {
+        return false;
+    }
+
+    u32 num_keys;
+    u32 num_bound_samplers;
+    u32 num_separate_samplers;
+    u32 num_bindless_samplers;
+    if (file.ReadArray(&is_texture_handler_size_known, 1) != 1 ||
+        file.ReadArray(&texture_handler_size_value, 1) != 1 ||
+        file.ReadArray(&bound_buffer, 1) != 1 || file.ReadArray(&graphics_info, 1) != 1 ||
+        file.ReadArray(&compute_info, 1) != 1 || file.ReadArray(&num_keys, 1) != 1 ||
+        file.ReadArray(&num_bound_samplers, 1) != 1 ||
+        file.ReadArray(&num_separate_samplers, 1) != 1 ||
+        file.ReadArray(&num_bindless_samplers, 1) != 1) {
+        return false;
+    }
+    if (is_texture_handler_size_known) {
+        texture_handler_size = texture_handler_size_value;
+    }
+
+    std::vector<ConstBufferKey> flat_keys(num_keys);
+    std::vector<BoundSamplerEntry> flat_bound_samplers(num_bound_samplers);
+    std::vector<SeparateSamplerEntry> flat_separate_samplers(num_separate_samplers);
+    std::vector<BindlessSamplerEntry> flat_bindless_samplers(num_bindless_samplers);
+    if (file.ReadArray(flat_keys.data(), flat_keys.size()) != flat_keys.size() ||
+        file.ReadArray(flat_bound_samplers.data(), flat_bound_samplers.size()) !=
+            flat_bound_samplers.size() ||
+        file.ReadArray(flat_separate_samplers.data(), flat_separate_samplers.size()) !=
+            flat_separate_samplers.size() ||
+        file.ReadArray(flat_bindless_samplers.data(), flat_bindless_samplers.size()) !=
+            flat_bindless_samplers.size()) {
+        return false;
+    }
+    for (const auto& entry : flat_keys) {
+        keys.insert({{entry.cbuf, entry.offset}, entry.value});
+    }
+    for (const auto& entry : flat_bound_samplers) {
+        bound_samplers.emplace(entry.offset, entry.sampler);
+    }
+    for (const auto& entry : flat_separate_samplers) {
+        SeparateSamplerKey key;
+        key.buffers = {entry.cbuf1, entry.cbuf2};
+        key.offsets = {entry.offset1, entry.offset2};
+        separate_samplers.emplace(key, entry.sampler);
+    }
+    for (const auto& entry : flat_bindless_samplers) {
+        bindless_samplers.insert({{entry.cbuf, entry.offset}, entry.sampler});
+    }
+    return true;
+}
+
+bool ShaderDiskCacheEntry::Save(Common::FS::IOFile& file) const {
+    if (file.WriteObject(unique_identifier) != 1 ||
+        file.WriteObject(static_cast<u32>(type)) != 1 ||
+        file.WriteObject(static_cast<u32>(code.size())) != 1 ||
+        file.WriteArray(code.data(), code.size()) != code.size()) {
+        return false;
+    }
+    if (file.WriteObject(static_cast<u8>(texture_handler_size.has_value())) != 1 ||
+        file.WriteObject(texture_handler_size.value_or(0)) != 1 ||
+        file.WriteObject(bound_buffer) != 1 || file.WriteObject(graphics_info) != 1 ||
+        file.WriteObject(compute_info) != 1 ||
+        file.WriteObject(static_cast<u32>(keys.size())) != 1 ||
+        file.WriteObject(static_cast<u32>(bound_samplers.size())) != 1 ||
+        file.WriteObject(static_cast<u32>(separate_samplers.size())) != 1 ||
+        file.WriteObject(static_cast<u32>(bindless_samplers.size())) != 1) {
+        return false;
+    }
+
+    std::vector<ConstBufferKey> flat_keys;
+    flat_keys.reserve(keys.size());
+    for (const auto& [address, value] : keys) {
+        flat_keys.push_back(ConstBufferKey{address.first, address.second, value});
+    }
+
+    std::vector<BoundSamplerEntry> flat_bound_samplers;
+    flat_bound_samplers.reserve(bound_samplers.size());
+    for (const auto& [address, sampler] : bound_samplers) {
+        flat_bound_samplers.push_back(BoundSamplerEntry{address, sampler});
+    }
+
+    std::vector<SeparateSamplerEntry> flat_separate_samplers;
+    flat_separate_samplers.reserve(separate_samplers.size());
+    for (const auto& [key, sampler] : separate_samplers) {
+        SeparateSamplerEntry entry;
+        std::tie(entry.cbuf1, entry.cbuf2) = key.buffers;
+        std::tie(entry.offset1, entry.offset2) = key.offsets;
+        entry.sampler = sampler;
+        flat_separate_samplers.push_back(entry);
+    }
+
+    std::vector<BindlessSamplerEntry> flat_bindless_samplers;
+    flat_bindless_samplers.reserve(bindless_samplers.size());
+    for (const auto& [address, sampler] : bindless_samplers) {
+        flat_bindless_samplers.push_back(
+            BindlessSamplerEntry{address.first, address.second, sampler});
+    }
+
+    return file.WriteArray(flat_keys.data(), flat_keys.size()) == flat_keys.size() &&
+           file.WriteArray(flat_bound_samplers.data(), flat_bound_samplers.size()) ==
+               flat_bound_samplers.size() &&
+           file.WriteArray(flat_separate_samplers.data(), flat_separate_samplers.size()) ==
+               flat_separate_samplers.size() &&
+           file.WriteArray(flat_bindless_samplers.data(), flat_bindless_samplers.size()) ==
+               flat_bindless_samplers.size();
+}
+
+u64 GraphicsPipelineDiskCacheEntry::Hash() const noexcept {
+    const u64 seed = Common::CityHash64(reinterpret_cast<const char*>(unique_identifiers.data()),
+                                        sizeof(unique_identifiers));
+    return Common::CityHash64WithSeed(reinterpret_cast<const char*>(&fixed_state),
+                                      fixed_state.Size(), seed);
+}
+
+u64 ComputePipelineDiskCacheEntry::Hash() const noexcept {
+    return Common::CityHash64(reinterpret_cast<const char*>(this), sizeof *this);
+}
+
+PipelineDiskCache::PipelineDiskCache(const Device& device) : device_hash{GetDeviceHash(device)} {}
+
+PipelineDiskCache::~PipelineDiskCache() = default;
+
+void PipelineDiskCache::BindTitleID(u64 title_id_) {
+    title_id = title_id_;
+    stored_transferable.clear();
+    stored_precompiled.clear();
+    is_usable = false;
+}
+
+std::optional<PipelineDiskCacheTransferable> PipelineDiskCache::LoadTransferable() {
+    // Skip games without title id
+    if (!Settings::values.use_disk_shader_cache.GetValue() || title_id == 0) {
+        return std::nullopt;
+    }
+    if (!writer) {
+        writer = std::make_unique<Common::ThreadWorker>(1, "yuzu:PipelineDiskCache");
+    }
+
+    Common::FS::IOFile file(GetTransferablePath(), "rb");
+    if (!file.IsOpen()) {
+        LOG_INFO(Render_Vulkan, "No transferable pipeline cache found");
+        is_usable = true;
+        return std::nullopt;
+    }
+    TransferableHeader header{};
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != TRANSFERABLE_MAGIC || header.version != TRANSFERABLE_VERSION) {
+        LOG_INFO(Render_Vulkan, "Transferable pipeline cache is invalid or old, removing");
+        file.Close();
+        InvalidateTransferable();
+        is_usable = true;
+        return std::nullopt;
+    }
+
+    PipelineDiskCacheTransferable transferable;
+    const u64 file_size = file.GetSize();
+    while (file.Tell() < file_size) {
+        RecordType type{};
+        bool is_valid = file.ReadBytes(&type, sizeof(type)) == sizeof(type);
+        if (is_valid) {
+            switch (type) {
+            case RecordType::Shader: {
+                ShaderDiskCacheEntry& entry = transferable.shaders.emplace_back();
+                is_valid = entry.Load(file);
+                stored_transferable.insert(entry.unique_identifier);
+                break;
+            }
+            case RecordType::GraphicsPipeline: {
+                auto& entry = transferable.graphics_pipelines.emplace_back();
+                is_valid = file.ReadBytes(&entry, sizeof(entry)) == sizeof(entry);
+                stored_transferable.insert(entry.Hash());
+                break;
+            }
+            case RecordType::ComputePipeline: {
+                auto& entry = transferable.compute_pipelines.emplace_back();
+                is_valid = file.ReadBytes(&entry, sizeof(entry)) == sizeof(entry);
+                stored_transferable.insert(entry.Hash());
+                break;
+            }
+            default:
+                is_valid = false;
+                break;
+            }
+        }
+        if (!is_valid) {
+            LOG_ERROR(Render_Vulkan, "Failed to load transferable pipeline cache entry, removing");
+            file.Close();
+            InvalidateTransferable();
+            is_usable = true;
+            return std::nullopt;
+        }
+    }
+    LOG_INFO(Render_Vulkan, "Loaded {} shaders and {} pipelines from the transferable cache",
+             transferable.shaders.size(),
+             transferable.graphics_pipelines.size() + transferable.compute_pipelines.size());
+    is_usable = true;
+    return {std::move(transferable)};
+}
+
+std::unordered_map<u64, PipelineDiskCachePrecompiled> PipelineDiskCache::LoadPrecompiled() {
+    if (!is_usable) {
+        return {};
+    }
+    Common::FS::IOFile file(GetPrecompiledPath(), "rb");
+    if (!file.IsOpen()) {
+        LOG_INFO(Render_Vulkan, "No precompiled pipeline cache found");
+        return {};
+    }
+    PrecompiledHeader header{};
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != PRECOMPILED_MAGIC || header.version != PRECOMPILED_VERSION ||
+        header.build_hash != GetBuildHash() || header.device_hash != device_hash) {
+        LOG_INFO(Render_Vulkan, "Precompiled pipeline cache is from another build or device, "
+                                "removing");
+        file.Close();
+        InvalidatePrecompiled();
+        return {};
+    }
+    std::unordered_map<u64, PipelineDiskCachePrecompiled> entries;
+    const u64 file_size = file.GetSize();
+    while (file.Tell() < file_size) {
+        PrecompiledEntryHeader entry{};
+        if (file.ReadBytes(&entry, sizeof(entry)) != sizeof(entry) ||
+            file.Tell() + entry.compressed_size > file_size) {
+            LOG_ERROR(Render_Vulkan, "Failed to load precompiled pipeline cache, removing");
+            file.Close();
+            InvalidatePrecompiled();
+            return {};
+        }
+        PipelineDiskCachePrecompiled precompiled;
+        precompiled.compressed.resize(entry.compressed_size);
+        precompiled.decompressed_size = entry.decompressed_size;
+        if (file.ReadBytes(precompiled.compressed.data(), precompiled.compressed.size()) !=
+            precompiled.compressed.size()) {
+            LOG_ERROR(Render_Vulkan, "Failed to load precompiled pipeline cache, removing");
+            file.Close();
+            InvalidatePrecompiled();
+            return {};
+        }
+        entries.insert_or_assign(entry.hash, std::move(precompiled));
+        stored_precompiled.insert(entry.hash);
+    }
+    LOG_INFO(Render_Vulkan, "Loaded {} pipelines from the precompiled cache", entries.size());
+    return entries;
+}
+
+std::optional<PipelineSPIRV> PipelineDiskCache::DecompressSPIRV(
+    const PipelineDiskCachePrecompiled& entry) {
+    const std::vector<u8> data = Common::Compression::DecompressDataZSTD(entry.compressed);
+    if (data.size() != entry.decompressed_size) {
+        return std::nullopt;
+    }
+    // The payload is the word count of each stage followed by the code of all stages
+    std::array<u32, Maxwell::MaxShaderStage> sizes;
+    if (data.size() < sizeof(sizes)) {
+        return std::nullopt;
+    }
+    std::memcpy(sizes.data(), data.data(), sizeof(sizes));
+    std::size_t offset = sizeof(sizes);
+    PipelineSPIRV spirv;
+    for (std::size_t stage = 0; stage < Maxwell::MaxShaderStage; ++stage) {
+        const std::size_t size_bytes = std::size_t{sizes[stage]} * sizeof(u32);
+        if (offset + size_bytes > data.size()) {
+            return std::nullopt;
+        }
+        if (size_bytes == 0) {
+            continue;
+        }
+        spirv[stage].resize(sizes[stage]);
+        std::memcpy(spirv[stage].data(), data.data() + offset, size_bytes);
+        offset += size_bytes;
+    }
+    return spirv;
+}
+
+u64 PipelineDiskCache::MakeUniqueIdentifier(ShaderType type, const std::vector<u64>& code,
+                                            Registry& registry) {
+    const auto& profile = registry.AccessGuestDriverProfile();
+    std::vector<u32> words{
+        static_cast<u32>(type),
+        profile.IsTextureHandlerSizeKnown() ? profile.GetTextureHandlerSize() : 0,
+        registry.GetBoundBuffer(),
+    };
+    if (type == ShaderType::Compute) {
+        const auto& info = registry.GetComputeInfo();
+        words.insert(words.end(), info.workgroup_size.begin(), info.workgroup_size.end());
+        words.push_back(info.shared_memory_size_in_words);
+        words.push_back(info.local_memory_size_in_words);
+    } else {
+        // Transform feedback state only matters to the decompiler when it's enabled
+        const auto& info = registry.GetGraphicsInfo();
+        words.push_back(static_cast<u32>(info.primitive_topology));
+        words.push_back(static_cast<u32>(info.tessellation_primitive));
+        words.push_back(static_cast<u32>(info.tessellation_spacing));
+        words.push_back(info.tessellation_clockwise ? 1 : 0);
+        words.push_back(info.tfb_enabled ? 1 : 0);
+        if (info.tfb_enabled) {
+            for (std::size_t i = 0; i < info.tfb_layouts.size(); ++i) {
+                const auto& layout = info.tfb_layouts[i];
+                words.insert(words.end(), {layout.stream, layout.varying_count, layout.stride});
+                words.insert(words.end(), info.tfb_varying_locs[i].begin(),
+                             info.tfb_varying_locs[i].end());
+            }
+        }
+    }
+    AppendSorted(words, registry.GetKeys(), [](const auto& pair) {
+        return std::array{pair.first.first, pair.first.second, pair.second};
+    });
+    AppendSorted(words, registry.GetBoundSamplers(), [](const auto& pair) {
+        return std::array{pair.first, pair.second.raw};
+    });
+    AppendSorted(words, registry.GetSeparateSamplers(), [](const auto& pair) {
+        const SeparateSamplerKey& key = pair.first;
+        return std::array{key.buffers.first, key.buffers.second, key.offsets.first,
+                          key.offsets.second, pair.second.raw};
+    });
+    AppendSorted(words, registry.GetBindlessSamplers(), [](const auto& pair) {
+        return std::array{pair.first.first, pair.first.second, pair.second.raw};
+    });
+    const u64 seed = Common::CityHash64(reinterpret_cast<const char*>(words.data()),
+                                        words.size() * sizeof(u32));
+    return Common::CityHash64WithSeed(reinterpret_cast<const char*>(code.data()),
+                                      code.size() * sizeof(u64), seed);
+}
+
+void PipelineDiskCache::SaveShader(const ShaderDiskCacheEntry& entry) {
+    if (!is_usable || !MarkTransferable(entry.unique_identifier)) {
+        return;
+    }
+    QueueTransferable([entry](Common::FS::IOFile& file) {
+        return file.WriteObject(RecordType::Shader) == 1 && entry.Save(file);
+    });
+}
+
+void PipelineDiskCache::SaveGraphicsPipeline(const GraphicsPipelineDiskCacheEntry& entry,
+                                             const PipelineSPIRV& spirv) {
+    if (!is_usable) {
+        return;
+    }
+    const u64 hash = entry.Hash();
+    if (MarkTransferable(hash)) {
+        QueueTransferable([entry](Common::FS::IOFile& file) {
+            return file.WriteObject(RecordType::GraphicsPipeline) == 1 &&
+                   file.WriteObject(entry) == 1;
+        });
+    }
+    SavePrecompiled(hash, spirv);
+}
+
+void PipelineDiskCache::SaveComputePipeline(const ComputePipelineDiskCacheEntry& entry,
+                                            const std::vector<u32>& spirv) {
+    if (!is_usable) {
+        return;
+    }
+    const u64 hash = entry.Hash();
+    if (MarkTransferable(hash)) {
+        QueueTransferable([entry](Common::FS::IOFile& file) {
+            return file.WriteObject(RecordType::ComputePipeline) == 1 &&
+                   file.WriteObject(entry) == 1;
+        });
+    }
+    PipelineSPIRV program;
+    program[0] = spirv;
+    SavePrecompiled(hash, program);
+}
+
+void PipelineDiskCache::SavePrecompiled(u64 hash, const PipelineSPIRV& spirv) {
+    {
+        std::scoped_lock lock{mutex};
+        if (!is_usable || !stored_precompiled.insert(hash).second) {
+            return;
+        }
+    }
+    // Compression and file IO happen in the worker, which runs entries in submission order.
+    writer->QueueWork([this, hash, spirv, path = GetPrecompiledPath()] {
+        if (!EnsureDirectories()) {
+            return;
+        }
+        std::array<u32, Maxwell::MaxShaderStage> sizes;
+        std::size_t size_bytes = sizeof(sizes);
+        for (std::size_t stage = 0; stage < Maxwell::MaxShaderStage; ++stage) {
+            sizes[stage] = static_cast<u32>(spirv[stage].size());
+            size_bytes += spirv[stage].size() * sizeof(u32);
+        }
+        std::vector<u8> data(size_bytes);
+        std::memcpy(data.data(), sizes.data(), sizeof(sizes));
+        std::size_t offset = sizeof(sizes);
+        for (const std::vector<u32>& code : spirv) {
+            if (code.empty()) {
+                continue;
+            }
+            std::memcpy(data.data() + offset, code.data(), code.size() * sizeof(u32));
+            offset += code.size() * sizeof(u32);
+        }
+        const std::vector<u8> compressed =
+            Common::Compression::CompressDataZSTDDefault(data.data(), data.size());
+
+        const bool existed = Common::FS::Exists(path);
+        Common::FS::IOFile file(path, "ab");
+        if (!file.IsOpen()) {
+            LOG_ERROR(Render_Vulkan, "Failed to open precompiled pipeline cache in path={}", path);
+            return;
+        }
+        if (!existed || file.GetSize() == 0) {
+            const PrecompiledHeader header{
+                .magic = PRECOMPILED_MAGIC,
+                .version = PRECOMPILED_VERSION,
+                .build_hash = GetBuildHash(),
+                .device_hash = device_hash,
+            };
+            if (file.WriteObject(header) != 1) {
+                LOG_ERROR(Render_Vulkan, "Failed to write precompiled pipeline cache header");
+                return;
+            }
+        }
+        const PrecompiledEntryHeader header{
+            .hash = hash,
+            .compressed_size = static_cast<u32>(compressed.size()),
+            .decompressed_size = static_cast<u32>(data.size()),
+        };
+        if (file.WriteObject(header) != 1 ||
+            file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            LOG_ERROR(Render_Vulkan, "Failed to write precompiled pipeline={:016X}", hash);
+        }
+    });
+}
+
+bool PipelineDiskCache::MarkTransferable(u64 key) {
+    std::scoped_lock lock{mutex};
+    return stored_transferable.insert(key).second;
+}
+
+template <typename Func>
+void PipelineDiskCache::QueueTransferable(Func&& func) {
+    writer->QueueWork([this, func = std::forward<Func>(func), path = GetTransferablePath()] {
+        if (!EnsureDirectories()) {
+            return;
+        }
+        const bool existed = Common::FS::Exists(path);
+        Common::FS::IOFile file(path, "ab");
+        if (!file.IsOpen()) {
+            LOG_ERROR(Render_Vulkan, "Failed to open transferable pipeline cache in path={}", path);
+            return;
+        }
+        if (!existed || file.GetSize() == 0) {
+            const TransferableHeader header{
+                .magic = TRANSFERABLE_MAGIC,
+                .version = TRANSFERABLE_VERSION,
+            };
+            if (file.WriteObject(header) != 1) {
+                LOG_ERROR(Render_Vulkan, "Failed to write transferable pipeline cache header");
+                return;
+            }
+        }
+        if (!func(file)) {
+            LOG_ERROR(Render_Vulkan, "Failed to write transferable pipeline cache entry");
+        }
+    });
+}
+
+void PipelineDiskCache::InvalidateTransferable() {
+    if (!Common::FS::Delete(GetTransferablePath())) {
+        LOG_ERROR(Render_Vulkan, "Failed to invalidate transferable file={}",
+                  GetTransferablePath());
+    }
+    InvalidatePrecompiled();
+}
+
+void PipelineDiskCache::InvalidatePrecompiled() {
+    if (Common::FS::Exists(GetPrecompiledPath()) && !Common::FS::Delete(GetPrecompiledPath())) {
+        LOG_ERROR(Render_Vulkan, "Failed to invalidate precompiled file={}", GetPrecompiledPath());
+    }
+}
+
+bool PipelineDiskCache::EnsureDirectories() const {
+    const auto CreateDir = [](const std::string& dir) {
+        if (!Common::FS::CreateDir(dir)) {
+            LOG_ERROR(Render_Vulkan, "Failed to create directory={}", dir);
+            return false;
+        }
+        return true;
+    };
+    return CreateDir(Common::FS::GetUserPath(Common::FS::UserPath::ShaderDir)) &&
+           CreateDir(GetBaseDir());
+}
+
+std::string PipelineDiskCache::GetTransferablePath() const {
+    return Common::FS::SanitizePath(GetBaseDir() + DIR_SEP_CHR +
+                                    fmt::format("{:016X}", title_id) + ".bin");
+}
+
+std::string PipelineDiskCache::GetPrecompiledPath() const {
+    return Common::FS::SanitizePath(GetBaseDir() + DIR_SEP_CHR +
+                                    fmt::format("{:016X}", title_id) + ".spv.bin");
+}
+
+std::string PipelineDiskCache::GetBaseDir() const {
+    return Common::FS::GetUserPath(Common::FS::UserPath::ShaderDir) + DIR_SEP "vulkan";
+}
+
+} // namespace Vulkan
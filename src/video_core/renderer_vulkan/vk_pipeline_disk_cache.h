@@ -0,0 +1,180 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/shader_type.h"
+#include "video_core/renderer_vulkan/fixed_pipeline_state.h"
+#include "video_core/shader/registry.h"
+
+namespace Common {
+class ThreadWorker;
+}
+
+namespace Common::FS {
+class IOFile;
+}
+
+namespace Vulkan {
+
+class Device;
+
+using Maxwell = Tegra::Engines::Maxwell3D::Regs;
+
+/// SPIR-V code of each stage in a pipeline, compute pipelines only use the first stage
+using PipelineSPIRV = std::array<std::vector<u32>, Maxwell::MaxShaderStage>;
+
+/// Describes a guest shader and the registry keys it was decoded with
+struct ShaderDiskCacheEntry {
+    ShaderDiskCacheEntry();
+    ~ShaderDiskCacheEntry();
+
+    bool Load(Common::FS::IOFile& file);
+
+    bool Save(Common::FS::IOFile& file) const;
+
+    u64 unique_identifier = 0;
+    Tegra::Engines::ShaderType type{};
+    std::vector<u64> code;
+    std::optional<u32> texture_handler_size;
+    u32 bound_buffer = 0;
+    VideoCommon::Shader::GraphicsInfo graphics_info;
+    VideoCommon::Shader::ComputeInfo compute_info;
+    VideoCommon::Shader::KeyMap keys;
+    VideoCommon::Shader::BoundSamplerMap bound_samplers;
+    VideoCommon::Shader::SeparateSamplerMap separate_samplers;
+    VideoCommon::Shader::BindlessSamplerMap bindless_samplers;
+};
+
+/// Describes a graphics pipeline by the shaders of its stages and its fixed state
+struct GraphicsPipelineDiskCacheEntry {
+    /// Returns the key of the pipeline SPIR-V in the precompiled cache
+    u64 Hash() const noexcept;
+
+    /// Unique identifiers of the shaders of each stage, zero when the stage is disabled
+    std::array<u64, Maxwell::MaxShaderStage> unique_identifiers;
+
+    /// Fixed state of the pipeline, the bytes past FixedPipelineState::Size() are zero
+    FixedPipelineState fixed_state;
+};
+static_assert(std::is_trivially_copyable_v<GraphicsPipelineDiskCacheEntry>);
+
+/// Describes a compute pipeline by its shader and the specialization of its launch
+struct ComputePipelineDiskCacheEntry {
+    /// Returns the key of the pipeline SPIR-V in the precompiled cache
+    u64 Hash() const noexcept;
+
+    u64 unique_identifier;
+    u32 shared_memory_size;
+    std::array<u32, 3> workgroup_size;
+};
+static_assert(std::has_unique_object_representations_v<ComputePipelineDiskCacheEntry>);
+
+/// Contents of the transferable pipeline cache of a title
+struct PipelineDiskCacheTransferable {
+    std::vector<ShaderDiskCacheEntry> shaders;
+    std::vector<GraphicsPipelineDiskCacheEntry> graphics_pipelines;
+    std::vector<ComputePipelineDiskCacheEntry> compute_pipelines;
+};
+
+/// Compressed SPIR-V of a pipeline in the precompiled cache
+struct PipelineDiskCachePrecompiled {
+    std::vector<u8> compressed;
+    u32 decompressed_size = 0;
+};
+
+/**
+ * Per-title disk cache of Vulkan pipelines, split in two files like the OpenGL shader disk cache.
+ * The transferable file holds guest shader code with the registry keys it was decoded with, and
+ * the shaders and fixed state of the pipelines the guest used. It does not depend on the host.
+ * The precompiled file holds the zstd compressed SPIR-V of those pipelines, and is invalidated
+ * when the emulator or the host device changes. New entries are appended from a worker thread.
+ */
+class PipelineDiskCache {
+public:
+    explicit PipelineDiskCache(const Device& device);
+    ~PipelineDiskCache();
+
+    /// Binds a title ID for all future operations.
+    void BindTitleID(u64 title_id);
+
+    /// Returns true when the cache can be used for the current title
+    bool IsEnabled() const noexcept {
+        return is_usable;
+    }
+
+    /// Loads the transferable file. If it has an old version or on failure, it deletes the file.
+    std::optional<PipelineDiskCacheTransferable> LoadTransferable();
+
+    /// Loads the precompiled file, indexed by pipeline hash. Invalidates it on failure.
+    std::unordered_map<u64, PipelineDiskCachePrecompiled> LoadPrecompiled();
+
+    /// Decompresses the SPIR-V of a precompiled pipeline. Returns empty when it's corrupted.
+    static std::optional<PipelineSPIRV> DecompressSPIRV(const PipelineDiskCachePrecompiled& entry);
+
+    /// Returns the identifier of a shader from its code and the registry keys it was decoded with
+    static u64 MakeUniqueIdentifier(Tegra::Engines::ShaderType type, const std::vector<u64>& code,
+                                    VideoCommon::Shader::Registry& registry);
+
+    /// Saves a shader to the transferable file. Checks for collisions.
+    void SaveShader(const ShaderDiskCacheEntry& entry);
+
+    /// Saves a graphics pipeline to the transferable file and its SPIR-V to the precompiled file.
+    void SaveGraphicsPipeline(const GraphicsPipelineDiskCacheEntry& entry,
+                              const PipelineSPIRV& spirv);
+
+    /// Saves a compute pipeline to the transferable file and its SPIR-V to the precompiled file.
+    void SaveComputePipeline(const ComputePipelineDiskCacheEntry& entry,
+                             const std::vector<u32>& spirv);
+
+    /// Saves the SPIR-V of a pipeline to the precompiled file. Checks for collisions.
+    void SavePrecompiled(u64 hash, const PipelineSPIRV& spirv);
+
+private:
+    /// Returns true when the shader or pipeline has not been saved before
+    bool MarkTransferable(u64 key);
+
+    /// Queues a transferable record on the writer
+    template <typename Func>
+    void QueueTransferable(Func&& func);
+
+    /// Removes the transferable and precompiled files.
+    void InvalidateTransferable();
+
+    /// Removes the precompiled file.
+    void InvalidatePrecompiled();
+
+    /// Create shader cache directories. Returns true on success.
+    bool EnsureDirectories() const;
+
+    /// Gets current game's transferable file path
+    std::string GetTransferablePath() const;
+
+    /// Gets current game's precompiled file path
+    std::string GetPrecompiledPath() const;
+
+    /// Get user's Vulkan shader cache directory path
+    std::string GetBaseDir() const;
+
+    std::unique_ptr<Common::ThreadWorker> writer;
+    std::mutex mutex;
+    std::unordered_set<u64> stored_transferable;
+    std::unordered_set<u64> stored_precompiled;
+    u64 device_hash = 0;
+    u64 title_id = 0;
+    bool is_usable = false;
+};
+
+} // namespace Vulkan
@@ -466,6 +466,8 @@ void RasterizerVulkan::Draw(bool is_indexed, bool is_instanced) {
 
     buffer_cache.Unmap();
 
+    texture_cache.CommitAsyncDecodes();
+
     const Framebuffer* const framebuffer = texture_cache.GetFramebuffer();
     key.renderpass = framebuffer->RenderPass();
 
@@ -605,6 +607,7 @@ void RasterizerVulkan::DispatchCompute(GPUVAddr code_addr) {
 
     const std::span indices_span(image_view_indices.data(), image_view_indices.size());
     texture_cache.FillComputeImageViews(indices_span, image_view_ids);
+    texture_cache.CommitAsyncDecodes();
 
     buffer_cache.Map(CalculateComputeStreamBufferSize());
 
@@ -809,6 +812,12 @@ bool RasterizerVulkan::AccelerateDisplay(const Tegra::FramebufferConfig& config,
     return true;
 }
 
+void RasterizerVulkan::LoadDiskResources(u64 title_id, const std::atomic_bool& stop_loading,
+                                         const VideoCore::DiskResourceLoadCallback& callback) {
+    pipeline_cache.LoadDiskCache(title_id, stop_loading, callback);
+    texture_cache.LoadDiskResources(title_id, stop_loading);
+}
+
 void RasterizerVulkan::FlushWork() {
     static constexpr u32 DRAWS_TO_DISPATCH = 4096;
 
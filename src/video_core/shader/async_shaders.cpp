@@ -10,6 +10,7 @@
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_opengl/gl_shader_cache.h"
 #include "video_core/shader/async_shaders.h"
+#include "video_core/shader/ir_cache.h"
 
 namespace VideoCommon::Shader {
 
@@ -197,10 +198,11 @@ void AsyncShaders::ShaderCompilerThread(Core::Frontend::GraphicsContext* context
         lock.unlock();
 
         if (work.backend == Backend::OpenGL || work.backend == Backend::GLASM) {
-            const ShaderIR ir(work.code, work.main_offset, work.compiler_settings, *work.registry);
+            const auto ir = GetIRCache().Get(work.code, work.main_offset, work.compiler_settings,
+                                             *work.registry);
             const auto scope = context->Acquire();
             auto program =
-                OpenGL::BuildShader(*work.device, work.shader_type, work.uid, ir, *work.registry);
+                OpenGL::BuildShader(*work.device, work.shader_type, work.uid, *ir, *work.registry);
             Result result{};
             result.backend = work.backend;
             result.cpu_address = work.cpu_address;
@@ -0,0 +1,124 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "common/cityhash.h"
+#include "video_core/shader/ir_cache.h"
+#include "video_core/shader/registry.h"
+#include "video_core/shader/shader_ir.h"
+
+namespace VideoCommon::Shader {
+
+namespace {
+
+// Number of decoded shaders kept alive by the cache, the oldest ones are evicted first
+constexpr std::size_t MAX_ENTRIES = 1024;
+
+bool operator==(const CompilerSettings& lhs, const CompilerSettings& rhs) {
+    return lhs.depth == rhs.depth && lhs.disable_else_derivation == rhs.disable_else_derivation;
+}
+
+} // Anonymous namespace
+
+/// Decoded IR with the code and the registry it references, so it stays valid on its own.
+/// The registry is a copy of the one used to request the decode, it keeps the obtained keys.
+struct IRCache::Entry {
+    explicit Entry(u64 hash_, const ProgramCode& code_, u32 main_offset_,
+                   CompilerSettings settings_, const Registry& registry_)
+        : hash{hash_}, code{code_}, main_offset{main_offset_}, settings{settings_},
+          registry{registry_},
+          texture_handler_size{registry.AccessGuestDriverProfile().GetTextureHandlerSize()},
+          ir{code, main_offset, settings, registry} {}
+
+    const u64 hash;
+    const ProgramCode code;
+    const u32 main_offset;
+    const CompilerSettings settings;
+    Registry registry;
+    const u32 texture_handler_size;
+    const ShaderIR ir;
+};
+
+IRCache::IRCache() = default;
+
+IRCache::~IRCache() = default;
+
+std::shared_ptr<const ShaderIR> IRCache::Get(const ProgramCode& code, u32 main_offset,
+                                             CompilerSettings settings, Registry& registry) {
+    const u64 hash = Common::CityHash64WithSeed(reinterpret_cast<const char*>(code.data()),
+                                                code.size() * sizeof(u64), main_offset);
+    std::shared_ptr<const Entry> entry = Find(hash, code, main_offset, settings, registry);
+    if (!entry) {
+        // Decode outside of the lock, other threads can keep looking up shaders in the meantime
+        entry = std::make_shared<const Entry>(hash, code, main_offset, settings, registry);
+        Insert(entry);
+    }
+    registry.InsertKeys(entry->registry);
+
+    const ShaderIR* const ir = &entry->ir;
+    return std::shared_ptr<const ShaderIR>(std::move(entry), ir);
+}
+
+void IRCache::Clear() {
+    std::scoped_lock lock{mutex};
+    entries.clear();
+    insertion_order.clear();
+}
+
+std::shared_ptr<const IRCache::Entry> IRCache::Find(u64 hash, const ProgramCode& code,
+                                                    u32 main_offset, CompilerSettings settings,
+                                                    const Registry& registry) const {
+    const u32 texture_handler_size = registry.AccessGuestDriverProfile().GetTextureHandlerSize();
+
+    std::scoped_lock lock{mutex};
+    const auto it = entries.find(hash);
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    for (const std::shared_ptr<const Entry>& entry : it->second) {
+        if (entry->main_offset == main_offset && entry->settings == settings &&
+            entry->texture_handler_size == texture_handler_size && entry->code == code &&
+            registry.IsCompatible(entry->registry)) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+void IRCache::Insert(std::shared_ptr<const Entry> entry) {
+    std::scoped_lock lock{mutex};
+    auto& bucket = entries[entry->hash];
+    const bool is_duplicate = std::ranges::any_of(bucket, [&entry](const auto& other) {
+        return other->main_offset == entry->main_offset && other->settings == entry->settings &&
+               other->texture_handler_size == entry->texture_handler_size &&
+               other->code == entry->code && other->registry.HasEqualKeys(entry->registry);
+    });
+    if (is_duplicate) {
+        return;
+    }
+    bucket.push_back(entry);
+    insertion_order.push_back(std::move(entry));
+
+    while (insertion_order.size() > MAX_ENTRIES) {
+        const std::shared_ptr<const Entry> evicted = std::move(insertion_order.front());
+        insertion_order.pop_front();
+
+        auto& evicted_bucket = entries[evicted->hash];
+        std::erase(evicted_bucket, evicted);
+        if (evicted_bucket.empty()) {
+            entries.erase(evicted->hash);
+        }
+    }
+}
+
+IRCache& GetIRCache() {
+    static IRCache ir_cache;
+    return ir_cache;
+}
+
+} // namespace VideoCommon::Shader
@@ -0,0 +1,58 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/shader/compiler_settings.h"
+#include "video_core/shader/shader_ir.h"
+
+namespace VideoCommon::Shader {
+
+class Registry;
+
+/**
+ * Thread-safe cache of decoded shader IR shared by the backends, their disk cache loaders and the
+ * asynchronous shader workers. Decoded IR is reused when the guest code, entry point, compiler
+ * settings and stage match, and every key and sampler the cached IR was decoded with has the same
+ * value for the requesting registry. The keys of the cached IR are registered in the requesting
+ * registry, so it ends up with the same keys it would have obtained decoding the code itself.
+ */
+class IRCache {
+public:
+    explicit IRCache();
+    ~IRCache();
+
+    /// Returns the IR of the code, decoding it when no compatible IR is cached.
+    std::shared_ptr<const ShaderIR> Get(const ProgramCode& code, u32 main_offset,
+                                        CompilerSettings settings, Registry& registry);
+
+    /// Removes every cached IR, IR in use is kept alive by its users.
+    void Clear();
+
+private:
+    struct Entry;
+
+    /// Returns the cached entry compatible with the registry, null when there's none.
+    std::shared_ptr<const Entry> Find(u64 hash, const ProgramCode& code, u32 main_offset,
+                                      CompilerSettings settings, const Registry& registry) const;
+
+    /// Caches an entry, unless an equivalent one was cached from another thread in the meantime.
+    void Insert(std::shared_ptr<const Entry> entry);
+
+    mutable std::mutex mutex;
+    std::unordered_map<u64, std::vector<std::shared_ptr<const Entry>>> entries;
+    std::deque<std::shared_ptr<const Entry>> insertion_order;
+};
+
+/// Returns the IR cache shared by every shader cache in the process
+IRCache& GetIRCache();
+
+} // namespace VideoCommon::Shader
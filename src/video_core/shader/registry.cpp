@@ -136,6 +136,14 @@ void Registry::InsertBoundSampler(u32 offset, SamplerDescriptor sampler) {
     bound_samplers.insert_or_assign(offset, sampler);
 }
 
+void Registry::InsertSeparateSampler(std::pair<u32, u32> buffers, std::pair<u32, u32> offsets,
+                                     SamplerDescriptor sampler) {
+    SeparateSamplerKey key;
+    key.buffers = buffers;
+    key.offsets = offsets;
+    separate_samplers.insert_or_assign(key, sampler);
+}
+
 void Registry::InsertBindlessSampler(u32 buffer, u32 offset, SamplerDescriptor sampler) {
     bindless_samplers.insert_or_assign({buffer, offset}, sampler);
 }
@@ -168,6 +176,67 @@ bool Registry::HasEqualKeys(const Registry& rhs) const {
            std::tie(rhs.keys, rhs.bound_samplers, rhs.bindless_samplers);
 }
 
+bool Registry::IsCompatible(const Registry& rhs) const {
+    if (stage != rhs.stage || bound_buffer != rhs.bound_buffer) {
+        return false;
+    }
+    // Looks up a registered value, falling back to the engine when it's available
+    const auto matches = [this](const auto& map, const auto& key, const auto& value,
+                                const auto& read) {
+        if (const auto iter = map.find(key); iter != map.end()) {
+            return iter->second == value;
+        }
+        return engine && read() == value;
+    };
+    return std::all_of(rhs.keys.begin(), rhs.keys.end(),
+                       [&](const auto& pair) {
+                           const std::pair<u32, u32> key = pair.first;
+                           return matches(keys, key, pair.second, [&] {
+                               return engine->AccessConstBuffer32(stage, key.first, key.second);
+                           });
+                       }) &&
+           std::all_of(rhs.bound_samplers.begin(), rhs.bound_samplers.end(),
+                       [&](const auto& sampler) {
+                           const u32 offset = sampler.first;
+                           return matches(bound_samplers, offset, sampler.second, [&] {
+                               return engine->AccessBoundSampler(stage, offset);
+                           });
+                       }) &&
+           std::all_of(rhs.separate_samplers.begin(), rhs.separate_samplers.end(),
+                       [&](const auto& sampler) {
+                           const SeparateSamplerKey& key = sampler.first;
+                           return matches(separate_samplers, key, sampler.second, [&] {
+                               const u32 handle_1 = engine->AccessConstBuffer32(
+                                   stage, key.buffers.first, key.offsets.first);
+                               const u32 handle_2 = engine->AccessConstBuffer32(
+                                   stage, key.buffers.second, key.offsets.second);
+                               return engine->AccessSampler(handle_1 | handle_2);
+                           });
+                       }) &&
+           std::all_of(rhs.bindless_samplers.begin(), rhs.bindless_samplers.end(),
+                       [&](const auto& sampler) {
+                           const std::pair<u32, u32> key = sampler.first;
+                           return matches(bindless_samplers, key, sampler.second, [&] {
+                               return engine->AccessBindlessSampler(stage, key.first, key.second);
+                           });
+                       });
+}
+
+void Registry::InsertKeys(const Registry& rhs) {
+    for (const auto& [key, value] : rhs.keys) {
+        keys.insert_or_assign(key, value);
+    }
+    for (const auto& [key, value] : rhs.bound_samplers) {
+        bound_samplers.insert_or_assign(key, value);
+    }
+    for (const auto& [key, value] : rhs.separate_samplers) {
+        separate_samplers.insert_or_assign(key, value);
+    }
+    for (const auto& [key, value] : rhs.bindless_samplers) {
+        bindless_samplers.insert_or_assign(key, value);
+    }
+}
+
 const GraphicsInfo& Registry::GetGraphicsInfo() const {
     ASSERT(stage != Tegra::Engines::ShaderType::Compute);
     return graphics_info;
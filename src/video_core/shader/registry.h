@@ -115,6 +115,10 @@ public:
     /// Inserts a bound sampler key.
     void InsertBoundSampler(u32 offset, Tegra::Engines::SamplerDescriptor sampler);
 
+    /// Inserts a separate sampler key.
+    void InsertSeparateSampler(std::pair<u32, u32> buffers, std::pair<u32, u32> offsets,
+                               Tegra::Engines::SamplerDescriptor sampler);
+
     /// Inserts a bindless sampler key.
     void InsertBindlessSampler(u32 buffer, u32 offset, Tegra::Engines::SamplerDescriptor sampler);
 
@@ -125,6 +129,13 @@ public:
     /// Returns true if the keys are equal to the other ones in the registry.
     bool HasEqualKeys(const Registry& rhs) const;
 
+    /// Returns true if every key and sampler registered in rhs has the same value here. Values
+    /// that are not registered yet are read from the engine without registering them.
+    bool IsCompatible(const Registry& rhs) const;
+
+    /// Registers the keys and samplers of rhs, replacing the ones already registered.
+    void InsertKeys(const Registry& rhs);
+
     /// Returns graphics information from this shader
     const GraphicsInfo& GetGraphicsInfo() const;
 
@@ -141,6 +152,11 @@ public:
         return bound_samplers;
     }
 
+    /// Gets separate samplers database.
+    const SeparateSamplerMap& GetSeparateSamplers() const {
+        return separate_samplers;
+    }
+
     /// Gets bindless samplers database.
     const BindlessSamplerMap& GetBindlessSamplers() const {
         return bindless_samplers;
@@ -156,6 +172,11 @@ public:
         return engine ? engine->AccessGuestDriverProfile() : stored_guest_driver_profile;
     }
 
+    /// Obtains access to the guest driver's profile.
+    const VideoCore::GuestDriverProfile& AccessGuestDriverProfile() const {
+        return engine ? engine->AccessGuestDriverProfile() : stored_guest_driver_profile;
+    }
+
 private:
     const Tegra::Engines::ShaderType stage;
     VideoCore::GuestDriverProfile stored_guest_driver_profile;
@@ -0,0 +1,92 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/thread_worker.h"
+#include "video_core/memory_manager.h"
+#include "video_core/texture_cache/async_decode.h"
+#include "video_core/texture_cache/image_base.h"
+#include "video_core/texture_cache/image_disk_cache.h"
+#include "video_core/texture_cache/util.h"
+#include "video_core/textures/workers.h"
+
+namespace VideoCommon {
+
+std::vector<BufferImageCopy> DecodeImageContents(Tegra::MemoryManager& gpu_memory,
+                                                 ImageDiskCache& disk_cache, GPUVAddr gpu_addr,
+                                                 const ImageInfo& info, bool is_converted,
+                                                 std::span<u8> output) {
+    if (!is_converted) {
+        return UnswizzleImage(gpu_memory, gpu_addr, info, output);
+    }
+    std::vector<u8> unswizzled_data(CalculateUnswizzledSizeBytes(info));
+    auto copies = UnswizzleImage(gpu_memory, gpu_addr, info, unswizzled_data);
+    if (!disk_cache.IsEnabled()) {
+        ConvertImage(unswizzled_data, info, output, copies);
+        return copies;
+    }
+    const u64 key = ImageDiskCache::MakeKey(info, unswizzled_data);
+    if (disk_cache.Load(key, info, output)) {
+        ConvertImageCopies(info, copies);
+    } else {
+        ConvertImage(unswizzled_data, info, output, copies);
+        disk_cache.Store(key, info, output.first(CalculateConvertedSizeBytes(info)));
+    }
+    return copies;
+}
+
+AsyncDecode::AsyncDecode(Tegra::MemoryManager& gpu_memory_, ImageDiskCache& disk_cache_,
+                         const ImageBase& image)
+    : gpu_memory{gpu_memory_}, disk_cache{disk_cache_}, info{image.info},
+      gpu_addr{image.gpu_addr}, is_converted{True(image.flags & ImageFlagBits::Converted)} {}
+
+AsyncDecode::~AsyncDecode() = default;
+
+std::shared_ptr<AsyncDecode> AsyncDecode::Queue(Tegra::MemoryManager& gpu_memory,
+                                                ImageDiskCache& disk_cache,
+                                                const ImageBase& image) {
+    auto decode = std::make_shared<AsyncDecode>(gpu_memory, disk_cache, image);
+    Tegra::Texture::GetThreadWorkers().QueueWork([decode] {
+        if (decode->TryStart()) {
+            decode->Run();
+        }
+    });
+    return decode;
+}
+
+void AsyncDecode::Wait() {
+    if (TryStart()) {
+        Run();
+        return;
+    }
+    std::unique_lock lock{mutex};
+    complete_condition.wait(lock, [this] {
+        const State current = state.load(std::memory_order_acquire);
+        return current == State::Complete || current == State::Cancelled;
+    });
+}
+
+void AsyncDecode::Cancel() {
+    State expected = State::Queued;
+    if (state.compare_exchange_strong(expected, State::Cancelled, std::memory_order_acq_rel)) {
+        return;
+    }
+    Wait();
+}
+
+bool AsyncDecode::TryStart() noexcept {
+    State expected = State::Queued;
+    return state.compare_exchange_strong(expected, State::Running, std::memory_order_acq_rel);
+}
+
+void AsyncDecode::Run() {
+    data.resize(is_converted ? CalculateConvertedSizeBytes(info)
+                             : CalculateUnswizzledSizeBytes(info));
+    copies = DecodeImageContents(gpu_memory, disk_cache, gpu_addr, info, is_converted, data);
+
+    std::scoped_lock lock{mutex};
+    state.store(State::Complete, std::memory_order_release);
+    complete_condition.notify_all();
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,103 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/texture_cache/image_info.h"
+#include "video_core/texture_cache/types.h"
+
+namespace Tegra {
+class MemoryManager;
+}
+
+namespace VideoCommon {
+
+class ImageDiskCache;
+struct ImageBase;
+
+/**
+ * Reads the guest contents of an image and writes its unswizzled or converted contents to output.
+ * Converted contents are looked up in and stored to the disk cache when it is enabled.
+ * Returns the copies describing the layout of the output.
+ */
+[[nodiscard]] std::vector<BufferImageCopy> DecodeImageContents(
+    Tegra::MemoryManager& gpu_memory, ImageDiskCache& disk_cache, GPUVAddr gpu_addr,
+    const ImageInfo& info, bool is_converted, std::span<u8> output);
+
+/**
+ * Decodes the contents of an image into staging memory on the transcoding workers.
+ * The texture cache records the upload from the staging memory on the GPU thread once the decode
+ * is complete. Decodes that have not been picked up by a worker when they are waited on run in the
+ * waiting thread instead.
+ */
+class AsyncDecode {
+public:
+    explicit AsyncDecode(Tegra::MemoryManager& gpu_memory, ImageDiskCache& disk_cache,
+                         const ImageBase& image);
+    ~AsyncDecode();
+
+    /// Queue the decode of an image on the transcoding workers
+    [[nodiscard]] static std::shared_ptr<AsyncDecode> Queue(Tegra::MemoryManager& gpu_memory,
+                                                            ImageDiskCache& disk_cache,
+                                                            const ImageBase& image);
+
+    /// Return true when the decoded contents are ready
+    [[nodiscard]] bool IsComplete() const noexcept {
+        return state.load(std::memory_order_acquire) == State::Complete;
+    }
+
+    /// Wait for the decode to finish, running it in the calling thread if it has not started
+    void Wait();
+
+    /// Drop the decode if it has not started, otherwise wait for it to finish
+    void Cancel();
+
+    /// Return the decoded contents, only valid once the decode is complete
+    [[nodiscard]] std::span<const u8> Data() const noexcept {
+        return data;
+    }
+
+    /// Return the layout of the decoded contents, only valid once the decode is complete
+    [[nodiscard]] std::span<const BufferImageCopy> Copies() const noexcept {
+        return copies;
+    }
+
+private:
+    enum class State : u32 {
+        Queued,
+        Running,
+        Complete,
+        Cancelled,
+    };
+
+    /// Take ownership of the decode, returns false when another thread already did
+    [[nodiscard]] bool TryStart() noexcept;
+
+    /// Decode the contents and wake up any waiting thread
+    void Run();
+
+    Tegra::MemoryManager& gpu_memory;
+    ImageDiskCache& disk_cache;
+
+    ImageInfo info;
+    GPUVAddr gpu_addr;
+    bool is_converted;
+
+    std::vector<u8> data;
+    std::vector<BufferImageCopy> copies;
+
+    std::atomic<State> state{State::Queued};
+    std::mutex mutex;
+    std::condition_variable complete_condition;
+};
+
+} // namespace VideoCommon
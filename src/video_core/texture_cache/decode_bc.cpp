@@ -0,0 +1,843 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <span>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "common/div_ceil.h"
+#include "video_core/surface.h"
+#include "video_core/texture_cache/decode_bc.h"
+#include "video_core/texture_cache/formatter.h"
+#include "video_core/texture_cache/types.h"
+#include "video_core/textures/workers.h"
+
+namespace VideoCommon {
+
+namespace {
+
+using VideoCore::Surface::PixelFormat;
+
+constexpr u32 BLOCK_SIZE = 4;
+constexpr u32 TEXELS_PER_BLOCK = BLOCK_SIZE * BLOCK_SIZE;
+
+/// Minimum number of blocks decoded by a single task, small images are decoded by the caller
+constexpr u32 MIN_BLOCKS_PER_TASK = 256;
+
+/// Decoded block, texels are stored in A8B8G8R8 order
+using Texels = std::array<u32, TEXELS_PER_BLOCK>;
+
+[[nodiscard]] constexpr u32 PackRGBA(u32 red, u32 green, u32 blue, u32 alpha) {
+    return red | (green << 8) | (blue << 16) | (alpha << 24);
+}
+
+/// Reads bit fields from a 128-bit block, starting from the least significant bit
+class BlockBitReader {
+public:
+    explicit BlockBitReader(const u8* block) {
+        std::memcpy(words.data(), block, sizeof(words));
+    }
+
+    [[nodiscard]] u32 Read(u32 count) {
+        const u32 index = offset / 64;
+        const u32 shift = offset % 64;
+        u64 value = words[index] >> shift;
+        if (shift + count > 64 && index == 0) {
+            value |= words[1] << (64 - shift);
+        }
+        offset += count;
+        return static_cast<u32>(value & ((1ULL << count) - 1));
+    }
+
+    void Skip(u32 count) {
+        offset += count;
+    }
+
+private:
+    std::array<u64, 2> words{};
+    u32 offset = 0;
+};
+
+// https://www.khronos.org/registry/OpenGL/extensions/ARB/ARB_texture_compression_rgtc.txt
+// Signed values are stored in two's complement, as read by A8B8G8R8_SNORM.
+template <bool is_signed>
+void DecodeChannelBlock(const u8* block, std::array<u8, TEXELS_PER_BLOCK>& values) {
+    u64 bits;
+    std::memcpy(&bits, block, sizeof(bits));
+    const auto endpoint = [bits](u32 shift) -> s32 {
+        const u32 value = (bits >> shift) & 0xff;
+        if constexpr (is_signed) {
+            // -128 is decoded as -1.0, the same as -127
+            return std::max<s32>(static_cast<s8>(value), -127);
+        } else {
+            return static_cast<s32>(value);
+        }
+    };
+    constexpr s32 min_value = is_signed ? -127 : 0;
+    constexpr s32 max_value = is_signed ? 127 : 0xff;
+    const s32 value0 = endpoint(0);
+    const s32 value1 = endpoint(8);
+    std::array<s32, 8> palette{value0, value1};
+    if (value0 > value1) {
+        for (s32 i = 1; i < 7; ++i) {
+            palette[i + 1] = ((7 - i) * value0 + i * value1) / 7;
+        }
+    } else {
+        for (s32 i = 1; i < 5; ++i) {
+            palette[i + 1] = ((5 - i) * value0 + i * value1) / 5;
+        }
+        palette[6] = min_value;
+        palette[7] = max_value;
+    }
+    for (u32 texel = 0; texel < TEXELS_PER_BLOCK; ++texel) {
+        const u32 code = (bits >> (16 + 3 * texel)) & 7;
+        values[texel] = static_cast<u8>(palette[code]);
+    }
+}
+
+// https://www.khronos.org/registry/OpenGL/extensions/EXT/EXT_texture_compression_s3tc.txt
+void DecodeColorBlock(const u8* block, bool has_punchthrough_alpha, Texels& texels) {
+    u16 color0;
+    u16 color1;
+    u32 indices;
+    std::memcpy(&color0, block + 0, sizeof(color0));
+    std::memcpy(&color1, block + 2, sizeof(color1));
+    std::memcpy(&indices, block + 4, sizeof(indices));
+
+    const auto expand = [](u32 color) {
+        const u32 red = (color >> 11) & 0x1f;
+        const u32 green = (color >> 5) & 0x3f;
+        const u32 blue = color & 0x1f;
+        return std::array<u32, 3>{
+            (red << 3) | (red >> 2),
+            (green << 2) | (green >> 4),
+            (blue << 3) | (blue >> 2),
+        };
+    };
+    const std::array<u32, 3> rgb0 = expand(color0);
+    const std::array<u32, 3> rgb1 = expand(color1);
+    std::array<u32, 4> palette{
+        PackRGBA(rgb0[0], rgb0[1], rgb0[2], 0xff),
+        PackRGBA(rgb1[0], rgb1[1], rgb1[2], 0xff),
+    };
+    if (color0 > color1 || !has_punchthrough_alpha) {
+        palette[2] = PackRGBA((2 * rgb0[0] + rgb1[0]) / 3, (2 * rgb0[1] + rgb1[1]) / 3,
+                              (2 * rgb0[2] + rgb1[2]) / 3, 0xff);
+        palette[3] = PackRGBA((rgb0[0] + 2 * rgb1[0]) / 3, (rgb0[1] + 2 * rgb1[1]) / 3,
+                              (rgb0[2] + 2 * rgb1[2]) / 3, 0xff);
+    } else {
+        palette[2] = PackRGBA((rgb0[0] + rgb1[0]) / 2, (rgb0[1] + rgb1[1]) / 2,
+                              (rgb0[2] + rgb1[2]) / 2, 0xff);
+        palette[3] = 0;
+    }
+    for (u32 texel = 0; texel < TEXELS_PER_BLOCK; ++texel) {
+        texels[texel] = palette[(indices >> (2 * texel)) & 3];
+    }
+}
+
+void ReplaceAlpha(const std::array<u8, TEXELS_PER_BLOCK>& alpha, Texels& texels) {
+    for (u32 texel = 0; texel < TEXELS_PER_BLOCK; ++texel) {
+        texels[texel] = (texels[texel] & 0x00ffffff) | (u32{alpha[texel]} << 24);
+    }
+}
+
+void DecodeBC1(const u8* block, Texels& texels) {
+    DecodeColorBlock(block, true, texels);
+}
+
+void DecodeBC2(const u8* block, Texels& texels) {
+    u64 bits;
+    std::memcpy(&bits, block, sizeof(bits));
+    std::array<u8, TEXELS_PER_BLOCK> alpha;
+    for (u32 texel = 0; texel < TEXELS_PER_BLOCK; ++texel) {
+        alpha[texel] = static_cast<u8>(((bits >> (4 * texel)) & 0xf) * 0x11);
+    }
+    DecodeColorBlock(block + 8, false, texels);
+    ReplaceAlpha(alpha, texels);
+}
+
+void DecodeBC3(const u8* block, Texels& texels) {
+    std::array<u8, TEXELS_PER_BLOCK> alpha;
+    DecodeChannelBlock<false>(block, alpha);
+    DecodeColorBlock(block + 8, false, texels);
+    ReplaceAlpha(alpha, texels);
+}
+
+/// Alpha of one in the unsigned or signed normalized texel format
+template <bool is_signed>
+constexpr u32 OPAQUE_ALPHA = is_signed ? 0x7f : 0xff;
+
+template <bool is_signed>
+void DecodeBC4(const u8* block, Texels& texels) {
+    std::array<u8, TEXELS_PER_BLOCK> red;
+    DecodeChannelBlock<is_signed>(block, red);
+    for (u32 texel = 0; texel < TEXELS_PER_BLOCK; ++texel) {
+        texels[texel] = PackRGBA(red[texel], 0, 0, OPAQUE_ALPHA<is_signed>);
+    }
+}
+
+template <bool is_signed>
+void DecodeBC5(const u8* block, Texels& texels) {
+    std::array<u8, TEXELS_PER_BLOCK> red;
+    std::array<u8, TEXELS_PER_BLOCK> green;
+    DecodeChannelBlock<is_signed>(block, red);
+    DecodeChannelBlock<is_signed>(block + 8, green);
+    for (u32 texel = 0; texel < TEXELS_PER_BLOCK; ++texel) {
+        texels[texel] = PackRGBA(red[texel], green[texel], 0, OPAQUE_ALPHA<is_signed>);
+    }
+}
+
+// Tables shared by BC6H and BC7
+// https://www.khronos.org/registry/OpenGL/extensions/ARB/ARB_texture_compression_bptc.txt
+
+/// Subset of each texel for two subset partitions, one bit per texel
+constexpr std::array<u16, 64> PARTITIONS_2{
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80,
+    0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000, 0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310,
+    0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c, 0xaaaa,
+    0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc,
+    0x6996, 0xc33c, 0x9966, 0x0660, 0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6,
+    0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+};
+
+/// Subset of each texel for three subset partitions, two bits per texel
+constexpr std::array<u32, 64> PARTITIONS_3{
+    0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0,
+    0x5a5a5050, 0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4,
+    0xa9a59450, 0x2a0a4250, 0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454,
+    0x6a6a4040, 0xa4a45000, 0x1a1a0500, 0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400,
+    0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200, 0xa9a58000, 0x5090a0a8, 0xa8a09050,
+    0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50, 0x500aa550, 0xaaaa4444,
+    0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600, 0xaa444444,
+    0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+    0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44,
+    0x2a4a5254,
+};
+
+/// Anchor texel of the second subset in two subset partitions
+constexpr std::array<u8, 64> ANCHORS_2_OF_2{
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2,  8,  2,  2,  8,
+    8,  15, 2,  8,  2,  2,  8,  8,  2,  2,  15, 15, 6,  8,  2,  8,  15, 15, 2,  8,  2,  2,
+    2,  15, 15, 6,  6,  2,  6,  8,  15, 15, 2,  2,  15, 15, 15, 15, 15, 2,  2,  15,
+};
+
+/// Anchor texel of the second subset in three subset partitions
+constexpr std::array<u8, 64> ANCHORS_2_OF_3{
+    3,  3,  15, 15, 8,  3,  15, 15, 8,  8,  6,  6,  6,  5,  3, 3,  3,  3,  8,  15, 3,  3,
+    6,  10, 5,  8,  8,  6,  8,  5,  15, 15, 8,  15, 3,  5,  6, 10, 8,  15, 15, 3,  15, 5,
+    15, 15, 15, 15, 3,  15, 5,  5,  5,  8,  5,  10, 5,  10, 8, 13, 15, 12, 3,  3,
+};
+
+/// Anchor texel of the third subset in three subset partitions
+constexpr std::array<u8, 64> ANCHORS_3_OF_3{
+    15, 8,  8,  3,  15, 15, 3,  8,  15, 15, 15, 15, 15, 15, 15, 8,  15, 8,  15, 3,  15, 8,
+    15, 8,  3,  15, 6,  10, 15, 15, 10, 8,  15, 3,  15, 10, 10, 8,  9,  10, 6,  15, 8,  15,
+    3,  6,  6,  8,  15, 3,  15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3,  15, 15, 8,
+};
+
+constexpr std::array<u32, 4> WEIGHTS_2{0, 21, 43, 64};
+constexpr std::array<u32, 8> WEIGHTS_3{0, 9, 18, 27, 37, 46, 55, 64};
+constexpr std::array<u32, 16> WEIGHTS_4{0,  4,  9,  13, 17, 21, 26, 30,
+                                        34, 38, 43, 47, 51, 55, 60, 64};
+
+[[nodiscard]] constexpr u32 Weight(u32 index_bits, u32 index) {
+    switch (index_bits) {
+    case 2:
+        return WEIGHTS_2[index];
+    case 3:
+        return WEIGHTS_3[index];
+    default:
+        return WEIGHTS_4[index];
+    }
+}
+
+[[nodiscard]] constexpr u32 Subset(u32 num_subsets, u32 partition, u32 texel) {
+    switch (num_subsets) {
+    case 2:
+        return (PARTITIONS_2[partition] >> texel) & 1;
+    case 3:
+        return (PARTITIONS_3[partition] >> (2 * texel)) & 3;
+    default:
+        return 0;
+    }
+}
+
+[[nodiscard]] constexpr bool IsAnchor(u32 num_subsets, u32 partition, u32 texel) {
+    switch (num_subsets) {
+    case 2:
+        return texel == 0 || texel == ANCHORS_2_OF_2[partition];
+    case 3:
+        return texel == 0 || texel == ANCHORS_2_OF_3[partition] ||
+               texel == ANCHORS_3_OF_3[partition];
+    default:
+        return texel == 0;
+    }
+}
+
+/// Reads the index of every texel, anchor texels have an implicit zero high bit
+void ReadIndices(BlockBitReader& reader, u32 num_subsets, u32 partition, u32 index_bits,
+                 std::array<u8, TEXELS_PER_BLOCK>& indices) {
+    for (u32 texel = 0; texel < TEXELS_PER_BLOCK; ++texel) {
+        const bool is_anchor = IsAnchor(num_subsets, partition, texel);
+        indices[texel] = static_cast<u8>(reader.Read(is_anchor ? index_bits - 1 : index_bits));
+    }
+}
+
+struct BC7Mode {
+    u8 num_subsets;
+    u8 partition_bits;
+    u8 rotation_bits;
+    u8 index_selection_bits;
+    u8 color_bits;
+    u8 alpha_bits;
+    u8 endpoint_pbits;
+    u8 shared_pbits;
+    u8 index_bits;
+    u8 secondary_index_bits;
+};
+
+constexpr std::array<BC7Mode, 8> BC7_MODES{{
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+    {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+    {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+    {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+    {1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+    {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+    {1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+    {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+}};
+
+void DecodeBC7(const u8* block, Texels& texels) {
+    if (block[0] == 0) {
+        // Reserved mode, decodes to transparent black
+        texels.fill(0);
+        return;
+    }
+    const u32 mode_index = static_cast<u32>(std::countr_zero(block[0]));
+    const BC7Mode& mode = BC7_MODES[mode_index];
+
+    BlockBitReader reader(block);
+    reader.Skip(mode_index + 1);
+    const u32 partition = reader.Read(mode.partition_bits);
+    const u32 rotation = reader.Read(mode.rotation_bits);
+    const u32 index_selection = reader.Read(mode.index_selection_bits);
+
+    const u32 num_endpoints = mode.num_subsets * 2U;
+    std::array<std::array<u32, 4>, 6> endpoints{};
+    for (u32 component = 0; component < 3; ++component) {
+        for (u32 endpoint = 0; endpoint < num_endpoints; ++endpoint) {
+            endpoints[endpoint][component] = reader.Read(mode.color_bits);
+        }
+    }
+    if (mode.alpha_bits != 0) {
+        for (u32 endpoint = 0; endpoint < num_endpoints; ++endpoint) {
+            endpoints[endpoint][3] = reader.Read(mode.alpha_bits);
+        }
+    }
+    const u32 has_pbits = mode.endpoint_pbits + mode.shared_pbits;
+    if (has_pbits != 0) {
+        std::array<u32, 6> pbits{};
+        if (mode.endpoint_pbits != 0) {
+            for (u32 endpoint = 0; endpoint < num_endpoints; ++endpoint) {
+                pbits[endpoint] = reader.Read(1);
+            }
+        } else {
+            for (u32 subset = 0; subset < mode.num_subsets; ++subset) {
+                const u32 pbit = reader.Read(1);
+                pbits[subset * 2 + 0] = pbit;
+                pbits[subset * 2 + 1] = pbit;
+            }
+        }
+        for (u32 endpoint = 0; endpoint < num_endpoints; ++endpoint) {
+            for (u32& component : endpoints[endpoint]) {
+                component = (component << 1) | pbits[endpoint];
+            }
+        }
+    }
+    const auto expand = [](u32 value, u32 bits) {
+        value <<= 8 - bits;
+        return value | (value >> bits);
+    };
+    const u32 color_bits = mode.color_bits + has_pbits;
+    const u32 alpha_bits = mode.alpha_bits + has_pbits;
+    for (u32 endpoint = 0; endpoint < num_endpoints; ++endpoint) {
+        for (u32 component = 0; component < 3; ++component) {
+            endpoints[endpoint][component] = expand(endpoints[endpoint][component], color_bits);
+        }
+        endpoints[endpoint][3] =
+            mode.alpha_bits != 0 ? expand(endpoints[endpoint][3], alpha_bits) : 0xff;
+    }
+
+    std::array<u8, TEXELS_PER_BLOCK> color_indices;
+    ReadIndices(reader, mode.num_subsets, partition, mode.index_bits, color_indices);
+    std::array<u8, TEXELS_PER_BLOCK> alpha_indices = color_indices;
+    u32 color_index_bits = mode.index_bits;
+    u32 alpha_index_bits = mode.index_bits;
+    if (mode.secondary_index_bits != 0) {
+        ReadIndices(reader, 1, 0, mode.secondary_index_bits, alpha_indices);
+        alpha_index_bits = mode.secondary_index_bits;
+        if (index_selection != 0) {
+            std::swap(color_indices, alpha_indices);
+            std::swap(color_index_bits, alpha_index_bits);
+        }
+    }
+
+    for (u32 texel = 0; texel < TEXELS_PER_BLOCK; ++texel) {
+        const u32 subset = Subset(mode.num_subsets, partition, texel);
+        const std::array<u32, 4>& low = endpoints[subset * 2 + 0];
+        const std::array<u32, 4>& high = endpoints[subset * 2 + 1];
+        const u32 color_weight = Weight(color_index_bits, color_indices[texel]);
+        const u32 alpha_weight = Weight(alpha_index_bits, alpha_indices[texel]);
+        std::array<u32, 4> color;
+        for (u32 component = 0; component < 4; ++component) {
+            const u32 weight = component == 3 ? alpha_weight : color_weight;
+            color[component] =
+                ((64 - weight) * low[component] + weight * high[component] + 32) >> 6;
+        }
+        if (rotation != 0) {
+            std::swap(color[3], color[rotation - 1]);
+        }
+        texels[texel] = PackRGBA(color[0], color[1], color[2], color[3]);
+    }
+}
+
+enum class BC6HField : u8 {
+    D,
+    RW,
+    RX,
+    RY,
+    RZ,
+    GW,
+    GX,
+    GY,
+    GZ,
+    BW,
+    BX,
+    BY,
+    BZ,
+};
+
+/// Bits [first:last] of a BC6H field, the bit stream stores them starting from bit "last"
+struct BC6HBits {
+    BC6HField field;
+    u8 first;
+    u8 last;
+};
+
+struct BC6HMode {
+    u8 mode_bits;
+    u8 num_regions;
+    bool transformed;
+    u8 endpoint_bits;
+    std::array<u8, 3> delta_bits;
+    std::span<const BC6HBits> layout;
+};
+
+namespace BC6HLayouts {
+constexpr BC6HField D = BC6HField::D;
+constexpr BC6HField RW = BC6HField::RW;
+constexpr BC6HField RX = BC6HField::RX;
+constexpr BC6HField RY = BC6HField::RY;
+constexpr BC6HField RZ = BC6HField::RZ;
+constexpr BC6HField GW = BC6HField::GW;
+constexpr BC6HField GX = BC6HField::GX;
+constexpr BC6HField GY = BC6HField::GY;
+constexpr BC6HField GZ = BC6HField::GZ;
+constexpr BC6HField BW = BC6HField::BW;
+constexpr BC6HField BX = BC6HField::BX;
+constexpr BC6HField BY = BC6HField::BY;
+constexpr BC6HField BZ = BC6HField::BZ;
+
+// Bit layouts of each mode after the mode bits
+constexpr std::array<BC6HBits, 20> MODE_1{{
+    {GY, 4, 4}, {BY, 4, 4}, {BZ, 4, 4}, {RW, 9, 0}, {GW, 9, 0}, {BW, 9, 0}, {RX, 4, 0},
+    {GZ, 4, 4}, {GY, 3, 0}, {GX, 4, 0}, {BZ, 0, 0}, {GZ, 3, 0}, {BX, 4, 0}, {BZ, 1, 1},
+    {BY, 3, 0}, {RY, 4, 0}, {BZ, 2, 2}, {RZ, 4, 0}, {BZ, 3, 3}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 24> MODE_2{{
+    {GY, 5, 5}, {GZ, 4, 4}, {GZ, 5, 5}, {RW, 6, 0}, {BZ, 0, 0}, {BZ, 1, 1},
+    {BY, 4, 4}, {GW, 6, 0}, {BY, 5, 5}, {BZ, 2, 2}, {GY, 4, 4}, {BW, 6, 0},
+    {BZ, 3, 3}, {BZ, 5, 5}, {BZ, 4, 4}, {RX, 5, 0}, {GY, 3, 0}, {GX, 5, 0},
+    {GZ, 3, 0}, {BX, 5, 0}, {BY, 3, 0}, {RY, 5, 0}, {RZ, 5, 0}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 19> MODE_3{{
+    {RW, 9, 0},   {GW, 9, 0}, {BW, 9, 0}, {RX, 4, 0}, {RW, 10, 10}, {GY, 3, 0}, {GX, 3, 0},
+    {GW, 10, 10}, {BZ, 0, 0}, {GZ, 3, 0}, {BX, 3, 0}, {BW, 10, 10}, {BZ, 1, 1}, {BY, 3, 0},
+    {RY, 4, 0},   {BZ, 2, 2}, {RZ, 4, 0}, {BZ, 3, 3}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 21> MODE_4{{
+    {RW, 9, 0}, {GW, 9, 0},   {BW, 9, 0}, {RX, 3, 0}, {RW, 10, 10}, {GZ, 4, 4}, {GY, 3, 0},
+    {GX, 4, 0}, {GW, 10, 10}, {GZ, 3, 0}, {BX, 3, 0}, {BW, 10, 10}, {BZ, 1, 1}, {BY, 3, 0},
+    {RY, 3, 0}, {BZ, 0, 0},   {BZ, 2, 2}, {RZ, 3, 0}, {GY, 4, 4},   {BZ, 3, 3}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 21> MODE_5{{
+    {RW, 9, 0}, {GW, 9, 0},   {BW, 9, 0}, {RX, 3, 0}, {RW, 10, 10}, {BY, 4, 4}, {GY, 3, 0},
+    {GX, 3, 0}, {GW, 10, 10}, {BZ, 0, 0}, {GZ, 3, 0}, {BX, 4, 0},   {BW, 10, 10}, {BY, 3, 0},
+    {RY, 3, 0}, {BZ, 1, 1},   {BZ, 2, 2}, {RZ, 3, 0}, {BZ, 4, 4},   {BZ, 3, 3}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 20> MODE_6{{
+    {RW, 8, 0}, {BY, 4, 4}, {GW, 8, 0}, {GY, 4, 4}, {BW, 8, 0}, {BZ, 4, 4}, {RX, 4, 0},
+    {GZ, 4, 4}, {GY, 3, 0}, {GX, 4, 0}, {BZ, 0, 0}, {GZ, 3, 0}, {BX, 4, 0}, {BZ, 1, 1},
+    {BY, 3, 0}, {RY, 4, 0}, {BZ, 2, 2}, {RZ, 4, 0}, {BZ, 3, 3}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 20> MODE_7{{
+    {RW, 7, 0}, {GZ, 4, 4}, {BY, 4, 4}, {GW, 7, 0}, {BZ, 2, 2}, {GY, 4, 4}, {BW, 7, 0},
+    {BZ, 3, 3}, {BZ, 4, 4}, {RX, 5, 0}, {GY, 3, 0}, {GX, 4, 0}, {BZ, 0, 0}, {GZ, 3, 0},
+    {BX, 4, 0}, {BZ, 1, 1}, {BY, 3, 0}, {RY, 5, 0}, {RZ, 5, 0}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 22> MODE_8{{
+    {RW, 7, 0}, {BZ, 0, 0}, {BY, 4, 4}, {GW, 7, 0}, {GY, 5, 5}, {GY, 4, 4},
+    {BW, 7, 0}, {GZ, 5, 5}, {BZ, 4, 4}, {RX, 4, 0}, {GZ, 4, 4}, {GY, 3, 0},
+    {GX, 5, 0}, {GZ, 3, 0}, {BX, 4, 0}, {BZ, 1, 1}, {BY, 3, 0}, {RY, 4, 0},
+    {BZ, 2, 2}, {RZ, 4, 0}, {BZ, 3, 3}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 22> MODE_9{{
+    {RW, 7, 0}, {BZ, 1, 1}, {BY, 4, 4}, {GW, 7, 0}, {BY, 5, 5}, {GY, 4, 4},
+    {BW, 7, 0}, {BZ, 5, 5}, {BZ, 4, 4}, {RX, 4, 0}, {GZ, 4, 4}, {GY, 3, 0},
+    {GX, 4, 0}, {BZ, 0, 0}, {GZ, 3, 0}, {BX, 5, 0}, {BY, 3, 0}, {RY, 4, 0},
+    {BZ, 2, 2}, {RZ, 4, 0}, {BZ, 3, 3}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 24> MODE_10{{
+    {RW, 5, 0}, {GZ, 4, 4}, {BZ, 0, 0}, {BZ, 1, 1}, {BY, 4, 4}, {GW, 5, 0},
+    {GY, 5, 5}, {BY, 5, 5}, {BZ, 2, 2}, {GY, 4, 4}, {BW, 5, 0}, {GZ, 5, 5},
+    {BZ, 3, 3}, {BZ, 5, 5}, {BZ, 4, 4}, {RX, 5, 0}, {GY, 3, 0}, {GX, 5, 0},
+    {GZ, 3, 0}, {BX, 5, 0}, {BY, 3, 0}, {RY, 5, 0}, {RZ, 5, 0}, {D, 4, 0},
+}};
+constexpr std::array<BC6HBits, 6> MODE_11{{
+    {RW, 9, 0},
+    {GW, 9, 0},
+    {BW, 9, 0},
+    {RX, 9, 0},
+    {GX, 9, 0},
+    {BX, 9, 0},
+}};
+constexpr std::array<BC6HBits, 9> MODE_12{{
+    {RW, 9, 0},
+    {GW, 9, 0},
+    {BW, 9, 0},
+    {RX, 8, 0},
+    {RW, 10, 10},
+    {GX, 8, 0},
+    {GW, 10, 10},
+    {BX, 8, 0},
+    {BW, 10, 10},
+}};
+constexpr std::array<BC6HBits, 9> MODE_13{{
+    {RW, 9, 0},
+    {GW, 9, 0},
+    {BW, 9, 0},
+    {RX, 7, 0},
+    {RW, 10, 11},
+    {GX, 7, 0},
+    {GW, 10, 11},
+    {BX, 7, 0},
+    {BW, 10, 11},
+}};
+constexpr std::array<BC6HBits, 9> MODE_14{{
+    {RW, 9, 0},
+    {GW, 9, 0},
+    {BW, 9, 0},
+    {RX, 3, 0},
+    {RW, 10, 15},
+    {GX, 3, 0},
+    {GW, 10, 15},
+    {BX, 3, 0},
+    {BW, 10, 15},
+}};
+} // namespace BC6HLayouts
+
+constexpr std::array<BC6HMode, 14> BC6H_MODES{{
+    {2, 2, true, 10, {5, 5, 5}, BC6HLayouts::MODE_1},
+    {2, 2, true, 7, {6, 6, 6}, BC6HLayouts::MODE_2},
+    {5, 2, true, 11, {5, 4, 4}, BC6HLayouts::MODE_3},
+    {5, 2, true, 11, {4, 5, 4}, BC6HLayouts::MODE_4},
+    {5, 2, true, 11, {4, 4, 5}, BC6HLayouts::MODE_5},
+    {5, 2, true, 9, {5, 5, 5}, BC6HLayouts::MODE_6},
+    {5, 2, true, 8, {6, 5, 5}, BC6HLayouts::MODE_7},
+    {5, 2, true, 8, {5, 6, 5}, BC6HLayouts::MODE_8},
+    {5, 2, true, 8, {5, 5, 6}, BC6HLayouts::MODE_9},
+    {5, 2, false, 6, {6, 6, 6}, BC6HLayouts::MODE_10},
+    {5, 1, false, 10, {10, 10, 10}, BC6HLayouts::MODE_11},
+    {5, 1, true, 11, {9, 9, 9}, BC6HLayouts::MODE_12},
+    {5, 1, true, 12, {8, 8, 8}, BC6HLayouts::MODE_13},
+    {5, 1, true, 16, {4, 4, 4}, BC6HLayouts::MODE_14},
+}};
+
+/// Returns the BC6H mode selected by the first bits of a block, or nullptr if it is reserved
+[[nodiscard]] const BC6HMode* FindBC6HMode(u32 bits) {
+    switch (bits & 3) {
+    case 0:
+        return &BC6H_MODES[0];
+    case 1:
+        return &BC6H_MODES[1];
+    default:
+        break;
+    }
+    switch (bits & 0x1f) {
+    case 0x02:
+        return &BC6H_MODES[2];
+    case 0x06:
+        return &BC6H_MODES[3];
+    case 0x0a:
+        return &BC6H_MODES[4];
+    case 0x0e:
+        return &BC6H_MODES[5];
+    case 0x12:
+        return &BC6H_MODES[6];
+    case 0x16:
+        return &BC6H_MODES[7];
+    case 0x1a:
+        return &BC6H_MODES[8];
+    case 0x1e:
+        return &BC6H_MODES[9];
+    case 0x03:
+        return &BC6H_MODES[10];
+    case 0x07:
+        return &BC6H_MODES[11];
+    case 0x0b:
+        return &BC6H_MODES[12];
+    case 0x0f:
+        return &BC6H_MODES[13];
+    default:
+        return nullptr;
+    }
+}
+
+[[nodiscard]] constexpr s32 SignExtend(s32 value, u32 bits) {
+    const u32 shift = 32 - bits;
+    return static_cast<s32>(static_cast<u32>(value) << shift) >> shift;
+}
+
+[[nodiscard]] constexpr s32 Unquantize(s32 value, u32 bits, bool is_signed) {
+    if (!is_signed) {
+        if (bits >= 15 || value == 0) {
+            return value;
+        }
+        if (value == (1 << bits) - 1) {
+            return 0xffff;
+        }
+        return ((value << 16) + 0x8000) >> bits;
+    }
+    if (bits >= 16) {
+        return value;
+    }
+    const bool negative = value < 0;
+    const s32 magnitude = negative ? -value : value;
+    s32 result;
+    if (magnitude == 0) {
+        result = 0;
+    } else if (magnitude >= (1 << (bits - 1)) - 1) {
+        result = 0x7fff;
+    } else {
+        result = ((magnitude << 15) + 0x4000) >> (bits - 1);
+    }
+    return negative ? -result : result;
+}
+
+/// Converts an interpolated BC6H value to an 8-bit normalized component, clamping to [0, 1]
+[[nodiscard]] u32 FinishUnquantize(s32 value, bool is_signed) {
+    u32 half;
+    if (is_signed) {
+        if (value < 0) {
+            // Negative values are clamped to zero
+            return 0;
+        }
+        half = static_cast<u32>((value * 31) >> 5);
+    } else {
+        half = static_cast<u32>((value * 31) >> 6);
+    }
+    const u32 exponent = (half >> 10) & 0x1f;
+    const u32 mantissa = half & 0x3ff;
+    if (exponent >= 15) {
+        // Values equal or greater than one, including infinity
+        return 0xff;
+    }
+    const float number = exponent == 0
+                             ? std::ldexp(static_cast<float>(mantissa), -24)
+                             : std::ldexp(static_cast<float>(mantissa | 0x400),
+                                          static_cast<int>(exponent) - 25);
+    return static_cast<u32>(number * 255.0f + 0.5f);
+}
+
+void DecodeBC6H(const u8* block, bool is_signed, Texels& texels) {
+    u32 mode_bits;
+    std::memcpy(&mode_bits, block, sizeof(mode_bits));
+    const BC6HMode* const mode = FindBC6HMode(mode_bits);
+    if (!mode) {
+        // Reserved modes decode to opaque black
+        texels.fill(PackRGBA(0, 0, 0, 0xff));
+        return;
+    }
+    BlockBitReader reader(block);
+    reader.Skip(mode->mode_bits);
+
+    // Endpoints are indexed by region and then by component
+    std::array<std::array<s32, 3>, 4> endpoints{};
+    u32 partition = 0;
+    for (const BC6HBits& bits : mode->layout) {
+        u32 value = 0;
+        if (bits.first >= bits.last) {
+            value = reader.Read(bits.first - bits.last + 1) << bits.last;
+        } else {
+            for (u32 bit = bits.last + 1; bit-- > bits.first;) {
+                value |= reader.Read(1) << bit;
+            }
+        }
+        if (bits.field == BC6HField::D) {
+            partition |= value;
+            continue;
+        }
+        const u32 field_index = static_cast<u32>(bits.field) - static_cast<u32>(BC6HField::RW);
+        endpoints[field_index % 4][field_index / 4] |= static_cast<s32>(value);
+    }
+    const u32 num_endpoints = mode->num_regions * 2U;
+    const u32 endpoint_bits = mode->endpoint_bits;
+    for (u32 component = 0; component < 3; ++component) {
+        if (is_signed) {
+            endpoints[0][component] = SignExtend(endpoints[0][component], endpoint_bits);
+        }
+        if (is_signed || mode->transformed) {
+            for (u32 endpoint = 1; endpoint < num_endpoints; ++endpoint) {
+                endpoints[endpoint][component] =
+                    SignExtend(endpoints[endpoint][component], mode->delta_bits[component]);
+            }
+        }
+        if (mode->transformed) {
+            const s32 mask = static_cast<s32>((1U << endpoint_bits) - 1);
+            for (u32 endpoint = 1; endpoint < num_endpoints; ++endpoint) {
+                s32& value = endpoints[endpoint][component];
+                value = (endpoints[0][component] + value) & mask;
+                if (is_signed) {
+                    value = SignExtend(value, endpoint_bits);
+                }
+            }
+        }
+        for (u32 endpoint = 0; endpoint < num_endpoints; ++endpoint) {
+            s32& value = endpoints[endpoint][component];
+            value = Unquantize(value, endpoint_bits, is_signed);
+        }
+    }
+
+    const u32 index_bits = mode->num_regions == 1 ? 4 : 3;
+    std::array<u8, TEXELS_PER_BLOCK> indices;
+    ReadIndices(reader, mode->num_regions, partition, index_bits, indices);
+    for (u32 texel = 0; texel < TEXELS_PER_BLOCK; ++texel) {
+        const u32 region = Subset(mode->num_regions, partition, texel);
+        const std::array<s32, 3>& low = endpoints[region * 2 + 0];
+        const std::array<s32, 3>& high = endpoints[region * 2 + 1];
+        const s32 weight = static_cast<s32>(Weight(index_bits, indices[texel]));
+        std::array<u32, 3> color;
+        for (u32 component = 0; component < 3; ++component) {
+            const s32 value = ((64 - weight) * low[component] + weight * high[component] + 32) >> 6;
+            color[component] = FinishUnquantize(value, is_signed);
+        }
+        texels[texel] = PackRGBA(color[0], color[1], color[2], 0xff);
+    }
+}
+
+void DecodeBC6HUnsigned(const u8* block, Texels& texels) {
+    DecodeBC6H(block, false, texels);
+}
+
+void DecodeBC6HSigned(const u8* block, Texels& texels) {
+    DecodeBC6H(block, true, texels);
+}
+
+template <u32 BLOCK_BYTES, void (*DecodeBlock)(const u8*, Texels&)>
+void DecompressBlocks(std::span<const u8> input, Extent3D extent, std::span<u8> output) {
+    const u32 blocks_x = Common::DivCeil(extent.width, BLOCK_SIZE);
+    const u32 blocks_y = Common::DivCeil(extent.height, BLOCK_SIZE);
+    const u32 rows_per_task = std::max(MIN_BLOCKS_PER_TASK / blocks_x, 1U);
+    const u32 num_rows = blocks_y * extent.depth;
+    const u32 num_tasks = Common::DivCeil(num_rows, rows_per_task);
+    ASSERT(input.size() >= size_t{num_rows} * blocks_x * BLOCK_BYTES);
+    ASSERT(output.size() >= size_t{extent.width} * extent.height * extent.depth * 4);
+
+    Tegra::Texture::ParallelFor(num_tasks, [&](u32 task) {
+        const u32 first_row = task * rows_per_task;
+        const u32 last_row = std::min(first_row + rows_per_task, num_rows);
+        Texels texels;
+        for (u32 row = first_row; row < last_row; ++row) {
+            const u32 slice = row / blocks_y;
+            const u32 y = (row % blocks_y) * BLOCK_SIZE;
+            const u32 height = std::min(BLOCK_SIZE, extent.height - y);
+            const size_t slice_offset = size_t{slice} * extent.width * extent.height;
+            const u8* block = input.data() + size_t{row} * blocks_x * BLOCK_BYTES;
+            for (u32 x = 0; x < extent.width; x += BLOCK_SIZE, block += BLOCK_BYTES) {
+                DecodeBlock(block, texels);
+
+                const u32 width = std::min(BLOCK_SIZE, extent.width - x);
+                for (u32 line = 0; line < height; ++line) {
+                    const size_t offset = slice_offset + size_t{y + line} * extent.width + x;
+                    std::memcpy(output.data() + offset * 4, &texels[line * BLOCK_SIZE],
+                                width * sizeof(u32));
+                }
+            }
+        }
+    });
+}
+
+} // Anonymous namespace
+
+bool IsDecodableBCn(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::BC1_RGBA_UNORM:
+    case PixelFormat::BC1_RGBA_SRGB:
+    case PixelFormat::BC2_UNORM:
+    case PixelFormat::BC2_SRGB:
+    case PixelFormat::BC3_UNORM:
+    case PixelFormat::BC3_SRGB:
+    case PixelFormat::BC4_UNORM:
+    case PixelFormat::BC4_SNORM:
+    case PixelFormat::BC5_UNORM:
+    case PixelFormat::BC5_SNORM:
+    case PixelFormat::BC6H_UFLOAT:
+    case PixelFormat::BC6H_SFLOAT:
+    case PixelFormat::BC7_UNORM:
+    case PixelFormat::BC7_SRGB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void DecompressBCn(std::span<const u8> input, Extent3D extent, PixelFormat format,
+                   std::span<u8> output) {
+    switch (format) {
+    case PixelFormat::BC1_RGBA_UNORM:
+    case PixelFormat::BC1_RGBA_SRGB:
+        return DecompressBlocks<8, DecodeBC1>(input, extent, output);
+    case PixelFormat::BC2_UNORM:
+    case PixelFormat::BC2_SRGB:
+        return DecompressBlocks<16, DecodeBC2>(input, extent, output);
+    case PixelFormat::BC3_UNORM:
+    case PixelFormat::BC3_SRGB:
+        return DecompressBlocks<16, DecodeBC3>(input, extent, output);
+    case PixelFormat::BC4_UNORM:
+        return DecompressBlocks<8, DecodeBC4<false>>(input, extent, output);
+    case PixelFormat::BC4_SNORM:
+        return DecompressBlocks<8, DecodeBC4<true>>(input, extent, output);
+    case PixelFormat::BC5_UNORM:
+        return DecompressBlocks<16, DecodeBC5<false>>(input, extent, output);
+    case PixelFormat::BC5_SNORM:
+        return DecompressBlocks<16, DecodeBC5<true>>(input, extent, output);
+    case PixelFormat::BC6H_UFLOAT:
+        return DecompressBlocks<16, DecodeBC6HUnsigned>(input, extent, output);
+    case PixelFormat::BC6H_SFLOAT:
+        return DecompressBlocks<16, DecodeBC6HSigned>(input, extent, output);
+    case PixelFormat::BC7_UNORM:
+    case PixelFormat::BC7_SRGB:
+        return DecompressBlocks<16, DecodeBC7>(input, extent, output);
+    default:
+        UNIMPLEMENTED_MSG("Unimplemented BCn format={}", format);
+        break;
+    }
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,31 @@
+// Copyright 2020 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+
+#include "common/common_types.h"
+#include "video_core/surface.h"
+#include "video_core/texture_cache/types.h"
+
+namespace VideoCommon {
+
+/// Returns true when DecompressBCn can decode the given pixel format
+[[nodiscard]] bool IsDecodableBCn(VideoCore::Surface::PixelFormat format);
+
+/**
+ * Decompresses a BC1, BC2, BC3, BC4, BC5, BC6H or BC7 image into A8B8G8R8 texels.
+ * Rows of blocks are decoded in parallel. BC6H texels are clamped to the [0, 1] range.
+ * BC4 and BC5 SNORM images are decoded into signed normalized texels.
+ *
+ * @param input  Compressed blocks, tightly packed
+ * @param extent Size of the image in texels, it does not have to be a multiple of the block size
+ * @param format Pixel format of the compressed image
+ * @param output Output buffer, 4 bytes per texel
+ */
+void DecompressBCn(std::span<const u8> input, Extent3D extent,
+                   VideoCore::Surface::PixelFormat format, std::span<u8> output);
+
+} // namespace VideoCommon
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -25,9 +26,11 @@ enum class ImageFlagBits : u32 {
     Strong = 1 << 5,      ///< Exists in the image table, the dimensions are can be trusted
     Registered = 1 << 6,  ///< True when the image is registered
     Picked = 1 << 7,      ///< Temporary flag to mark the image as picked
+    Hashed = 1 << 8,      ///< Guest contents have been hashed on upload
 };
 DECLARE_ENUM_FLAG_OPERATORS(ImageFlagBits)
 
+class AsyncDecode;
 struct ImageViewInfo;
 
 struct AliasedImage {
@@ -63,6 +66,14 @@ struct ImageBase {
     u64 modification_tick = 0;
     u64 frame_tick = 0;
 
+    /// Hash of the guest data last uploaded to the image, valid when the image is flagged as Hashed
+    u64 guest_hash = 0;
+    /// Modification tick of the image when guest_hash was computed
+    u64 guest_hash_tick = 0;
+
+    /// Contents being decoded in a worker thread, they are uploaded once the decode is complete
+    std::shared_ptr<AsyncDecode> async_decode;
+
     std::array<u32, MAX_MIP_LEVELS> mip_level_offsets{};
 
     std::vector<ImageViewInfo> image_view_infos;
@@ -0,0 +1,254 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/cityhash.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/thread_worker.h"
+#include "common/zstd_compression.h"
+#include "core/settings.h"
+#include "video_core/texture_cache/image_disk_cache.h"
+#include "video_core/texture_cache/image_info.h"
+#include "video_core/texture_cache/util.h"
+
+namespace VideoCommon {
+
+namespace {
+
+constexpr u32 PACK_MAGIC = 0x43545a59; // "YZTC"
+
+// Version of the pack file, increment when the converted output of any format changes
+constexpr u32 PACK_VERSION = 1;
+
+struct PackHeader {
+    u32 magic;
+    u32 version;
+};
+static_assert(std::is_trivially_copyable_v<PackHeader>);
+
+struct EntryHeader {
+    u64 key;
+    u32 compressed_size;
+    u32 converted_size;
+};
+static_assert(std::is_trivially_copyable_v<EntryHeader>);
+
+/// Properties of an image that determine the layout of its converted contents
+struct ImageKey {
+    PixelFormat format;
+    Extent3D size;
+    SubresourceExtent resources;
+};
+static_assert(std::has_unique_object_representations_v<ImageKey>);
+
+} // Anonymous namespace
+
+ImageDiskCache::ImageDiskCache() = default;
+
+ImageDiskCache::~ImageDiskCache() = default;
+
+void ImageDiskCache::BindTitleID(u64 title_id_) {
+    std::scoped_lock lock{mutex};
+    title_id = title_id_;
+    entries.clear();
+    stored_keys.clear();
+    pack_file.Close();
+    is_usable = false;
+
+    // Skip games without title id
+    if (!Settings::values.use_disk_texture_cache.GetValue() || title_id == 0) {
+        return;
+    }
+    if (!LoadIndex()) {
+        LOG_INFO(HW_GPU, "Texture disk cache is invalid, removing");
+        entries.clear();
+        pack_file.Close();
+        Invalidate();
+    }
+    if (!writer) {
+        writer = std::make_unique<Common::ThreadWorker>(1, "yuzu:TextureDiskCache");
+    }
+    is_usable = true;
+}
+
+u64 ImageDiskCache::MakeKey(const ImageInfo& info, std::span<const u8> guest_data) {
+    const ImageKey image_key{
+        .format = info.format,
+        .size = info.size,
+        .resources = info.resources,
+    };
+    const u64 seed = Common::CityHash64(reinterpret_cast<const char*>(&image_key), sizeof(image_key));
+    return Common::CityHash64WithSeed(reinterpret_cast<const char*>(guest_data.data()),
+                                      guest_data.size_bytes(), seed);
+}
+
+bool ImageDiskCache::Load(u64 key, const ImageInfo& info, std::span<u8> output) {
+    std::vector<u8> compressed;
+    u32 converted_size = 0;
+    {
+        std::scoped_lock lock{mutex};
+        const auto it = entries.find(key);
+        if (it == entries.end()) {
+            return false;
+        }
+        const Entry& entry = it->second;
+        if (entry.converted_size != CalculateConvertedSizeBytes(info) ||
+            entry.converted_size > output.size_bytes()) {
+            return false;
+        }
+        converted_size = entry.converted_size;
+        compressed.resize(entry.compressed_size);
+        if (!pack_file.Seek(static_cast<s64>(entry.offset), SEEK_SET) ||
+            pack_file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            LOG_ERROR(HW_GPU, "Failed to read texture disk cache entry={:016X}", key);
+            entries.erase(it);
+            return false;
+        }
+    }
+    // Decompress outside of the lock, so other threads can read entries in the meantime
+    const std::vector<u8> converted = Common::Compression::DecompressDataZSTD(compressed);
+    if (converted.size() != converted_size) {
+        LOG_ERROR(HW_GPU, "Texture disk cache entry={:016X} is corrupted", key);
+        std::scoped_lock lock{mutex};
+        entries.erase(key);
+        return false;
+    }
+    std::memcpy(output.data(), converted.data(), converted.size());
+    return true;
+}
+
+void ImageDiskCache::Store(u64 key, const ImageInfo& info, std::span<const u8> converted_data) {
+    std::scoped_lock lock{mutex};
+    if (!is_usable || entries.contains(key) || !stored_keys.insert(key).second) {
+        return;
+    }
+    // Compression and file IO happen in the worker, which runs entries in submission order.
+    // Entries that are still queued when the emulation stops are dropped and regenerated later.
+    // The work only uses what it captures, so it can outlive the title it was queued for.
+    writer->QueueWork([key, path = GetPackPath(),
+                       data = std::vector<u8>(converted_data.begin(), converted_data.end())] {
+        if (!EnsureDirectories()) {
+            return;
+        }
+        const bool existed = Common::FS::Exists(path);
+        Common::FS::IOFile file(path, "ab");
+        if (!file.IsOpen()) {
+            LOG_ERROR(HW_GPU, "Failed to open texture disk cache in path={}", path);
+            return;
+        }
+        if (!existed || file.GetSize() == 0) {
+            const PackHeader header{.magic = PACK_MAGIC, .version = PACK_VERSION};
+            if (file.WriteObject(header) != 1) {
+                LOG_ERROR(HW_GPU, "Failed to write texture disk cache header in path={}", path);
+                return;
+            }
+        }
+        const std::vector<u8> compressed =
+            Common::Compression::CompressDataZSTDDefault(data.data(), data.size());
+        const EntryHeader header{
+            .key = key,
+            .compressed_size = static_cast<u32>(compressed.size()),
+            .converted_size = static_cast<u32>(data.size()),
+        };
+        if (file.WriteObject(header) != 1 ||
+            file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            LOG_ERROR(HW_GPU, "Failed to write texture disk cache entry={:016X}", key);
+        }
+    });
+}
+
+bool ImageDiskCache::LoadIndex() {
+    const std::string path = GetPackPath();
+    if (!Common::FS::Exists(path)) {
+        LOG_INFO(HW_GPU, "No texture disk cache found");
+        return true;
+    }
+    if (!pack_file.Open(path, "rb")) {
+        return false;
+    }
+    PackHeader header{};
+    if (pack_file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != PACK_MAGIC) {
+        return false;
+    }
+    if (header.version != PACK_VERSION) {
+        LOG_INFO(HW_GPU, "Texture disk cache is from another version of the emulator");
+        return false;
+    }
+    const u64 file_size = pack_file.GetSize();
+    u64 valid_size = pack_file.Tell();
+    while (valid_size < file_size) {
+        EntryHeader entry{};
+        if (pack_file.ReadBytes(&entry, sizeof(entry)) != sizeof(entry)) {
+            break;
+        }
+        const u64 offset = pack_file.Tell();
+        if (offset + entry.compressed_size > file_size) {
+            break;
+        }
+        entries.insert_or_assign(entry.key, Entry{
+                                                .offset = offset,
+                                                .compressed_size = entry.compressed_size,
+                                                .converted_size = entry.converted_size,
+                                            });
+        valid_size = offset + entry.compressed_size;
+        if (!pack_file.Seek(static_cast<s64>(valid_size), SEEK_SET)) {
+            return false;
+        }
+    }
+    if (valid_size < file_size) {
+        // The last entry was cut short, likely by the emulator stopping while it was written.
+        // Keep the complete entries and drop the partial one, so new entries are appended after
+        // the last complete entry.
+        LOG_WARNING(HW_GPU, "Texture disk cache has a truncated entry at offset={}, dropping it",
+                    valid_size);
+        pack_file.Close();
+        Common::FS::IOFile file(path, "r+b");
+        if (!file.IsOpen() || !file.Resize(valid_size)) {
+            return false;
+        }
+        file.Close();
+        if (!pack_file.Open(path, "rb")) {
+            return false;
+        }
+    }
+    LOG_INFO(HW_GPU, "Loaded {} entries from the texture disk cache", entries.size());
+    return true;
+}
+
+void ImageDiskCache::Invalidate() {
+    if (!Common::FS::Delete(GetPackPath())) {
+        LOG_ERROR(HW_GPU, "Failed to invalidate texture disk cache file={}", GetPackPath());
+    }
+}
+
+bool ImageDiskCache::EnsureDirectories() {
+    const auto CreateDir = [](const std::string& dir) {
+        if (!Common::FS::CreateDir(dir)) {
+            LOG_ERROR(HW_GPU, "Failed to create directory={}", dir);
+            return false;
+        }
+        return true;
+    };
+    return CreateDir(Common::FS::GetUserPath(Common::FS::UserPath::CacheDir)) &&
+           CreateDir(GetBaseDir());
+}
+
+std::string ImageDiskCache::GetPackPath() const {
+    return Common::FS::SanitizePath(GetBaseDir() + DIR_SEP_CHR +
+                                    fmt::format("{:016X}", title_id) + ".bin");
+}
+
+std::string ImageDiskCache::GetBaseDir() {
+    return Common::FS::GetUserPath(Common::FS::UserPath::CacheDir) + DIR_SEP "texture";
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,86 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Common {
+class ThreadWorker;
+}
+
+namespace VideoCommon {
+
+struct ImageInfo;
+
+/**
+ * Content addressed cache of converted (software decoded) image contents.
+ * Entries are keyed by the guest contents of an image and the properties that determine its
+ * converted layout, and are stored zstd compressed in a per-title pack file. Only the index of the
+ * pack is loaded on boot, payloads are read on demand. New entries are compressed and appended
+ * from a worker thread. Load and Store can be called from multiple threads.
+ */
+class ImageDiskCache {
+public:
+    explicit ImageDiskCache();
+    ~ImageDiskCache();
+
+    /// Binds a title ID and loads the index of its pack file
+    void BindTitleID(u64 title_id);
+
+    /// Returns true when the cache can be used for the current title
+    [[nodiscard]] bool IsEnabled() const noexcept {
+        return is_usable;
+    }
+
+    /// Returns the key of an image from its unswizzled guest contents
+    [[nodiscard]] static u64 MakeKey(const ImageInfo& info, std::span<const u8> guest_data);
+
+    /// Reads the converted contents of an image into output, returns true on success
+    [[nodiscard]] bool Load(u64 key, const ImageInfo& info, std::span<u8> output);
+
+    /// Queues the converted contents of an image to be stored
+    void Store(u64 key, const ImageInfo& info, std::span<const u8> converted_data);
+
+private:
+    struct Entry {
+        u64 offset;
+        u32 compressed_size;
+        u32 converted_size;
+    };
+
+    /// Loads the index of the pack file. Returns false on failure
+    bool LoadIndex();
+
+    /// Removes the pack file of the current title
+    void Invalidate();
+
+    /// Create texture cache directories. Returns true on success.
+    static bool EnsureDirectories();
+
+    /// Gets current game's pack file path
+    std::string GetPackPath() const;
+
+    /// Get user's texture cache directory path
+    static std::string GetBaseDir();
+
+    std::unique_ptr<Common::ThreadWorker> writer;
+    std::mutex mutex;
+    Common::FS::IOFile pack_file;
+    std::unordered_map<u64, Entry> entries;
+    std::unordered_set<u64> stored_keys;
+    u64 title_id = 0;
+    std::atomic_bool is_usable = false;
+};
+
+} // namespace VideoCommon
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <bit>
 #include <memory>
 #include <mutex>
@@ -19,9 +20,11 @@
 #include <boost/container/small_vector.hpp>
 
 #include "common/alignment.h"
+#include "common/cityhash.h"
 #include "common/common_funcs.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "core/settings.h"
 #include "video_core/compatible_formats.h"
 #include "video_core/delayed_destruction_ring.h"
 #include "video_core/dirty_flags.h"
@@ -31,9 +34,11 @@
 #include "video_core/memory_manager.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/surface.h"
+#include "video_core/texture_cache/async_decode.h"
 #include "video_core/texture_cache/descriptor_table.h"
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/texture_cache/formatter.h"
+#include "video_core/texture_cache/image_disk_cache.h"
 #include "video_core/texture_cache/image_base.h"
 #include "video_core/texture_cache/image_info.h"
 #include "video_core/texture_cache/image_view_base.h"
@@ -58,6 +63,12 @@ using VideoCore::Surface::PixelFormatFromDepthFormat;
 using VideoCore::Surface::PixelFormatFromRenderTargetFormat;
 using VideoCore::Surface::SurfaceType;
 
+/// Results of comparing the guest data of CPU modified images against their last upload
+struct ContentHashStats {
+    u64 hits = 0;   ///< Uploads skipped because the guest data didn't change
+    u64 misses = 0; ///< Uploads of hashed images whose guest data changed
+};
+
 template <class P>
 class TextureCache {
     /// Address shift for caching images into a hash table
@@ -70,6 +81,12 @@ class TextureCache {
     /// True when some copies have to be emulated
     static constexpr bool HAS_EMULATED_COPIES = P::HAS_EMULATED_COPIES;
 
+    /// Images used in this number of most recent frames are never evicted
+    static constexpr u64 FRAMES_TO_KEEP = 4;
+
+    /// Images with less decoded bytes than this are not worth sending to a worker thread
+    static constexpr u32 MIN_ASYNC_DECODE_SIZE = 64 * 1024;
+
     /// Image view ID for null descriptors
     static constexpr ImageViewId NULL_IMAGE_VIEW_ID{0};
     /// Sampler ID for bugged sampler ids
@@ -99,10 +116,14 @@ class TextureCache {
 public:
     explicit TextureCache(Runtime&, VideoCore::RasterizerInterface&, Tegra::Engines::Maxwell3D&,
                           Tegra::Engines::KeplerCompute&, Tegra::MemoryManager&);
+    ~TextureCache();
 
     /// Notify the cache that a new frame has been queued
     void TickFrame();
 
+    /// Load the disk cache of converted images for the given title
+    void LoadDiskResources(u64 title_id, const std::atomic_bool& stop_loading);
+
     /// Return an unique mutually exclusive lock for the cache
     [[nodiscard]] std::unique_lock<std::mutex> AcquireLock();
 
@@ -176,9 +197,16 @@ public:
     /// Pop asynchronous downloads
     void PopAsyncFlushes();
 
+    /// Upload the contents of images decoded in worker threads, this has to be called before draws
+    /// Decodes still in flight are waited for, unless texture placeholders are enabled
+    void CommitAsyncDecodes();
+
     /// Return true when a CPU region is modified from the GPU
     [[nodiscard]] bool IsRegionGpuModified(VAddr addr, size_t size);
 
+    /// Return the counters of the content hash checks done before uploading images
+    [[nodiscard]] ContentHashStats GetContentHashStats() const noexcept;
+
 private:
     /// Iterate over all page indices in a range
     template <typename Func>
@@ -209,7 +237,32 @@ private:
     FramebufferId GetFramebufferId(const RenderTargets& key);
 
     /// Refresh the contents (pixel data) of an image
-    void RefreshContents(Image& image);
+    /// When allow_async is true, the contents may be decoded in a worker thread and uploaded later
+    void RefreshContents(Image& image, ImageId image_id, bool allow_async = false);
+
+    /// Queue the decode of the contents of an image in a worker thread
+    void QueueAsyncDecode(Image& image, ImageId image_id);
+
+    /// Wait for the asynchronous decode of an image, if any, and upload its contents
+    void WaitAsyncDecode(ImageId image_id);
+
+    /// Upload the contents of a finished asynchronous decode
+    void UploadAsyncDecode(Image& image, ImageId image_id);
+
+    /// Drop the asynchronous decode of an image, if any
+    void CancelAsyncDecode(Image& image, ImageId image_id);
+
+    /// Hash the guest data of an image and return true when it matches its last upload
+    [[nodiscard]] bool IsGuestDataUnchanged(Image& image);
+
+    /// Download the contents of images and write them to guest memory, waiting for the GPU once
+    void DownloadImages(std::span<const ImageId> image_ids);
+
+    /// Evict least recently used images until the cache fits in the configured memory budget
+    void RunGarbageCollector();
+
+    /// Return the estimated host memory used by an image
+    [[nodiscard]] static u64 HostMemoryUsage(const ImageBase& image) noexcept;
 
     /// Upload data from guest to an image
     template <typename MapBuffer>
@@ -291,6 +344,9 @@ private:
     /// Prepare an image to be used
     void PrepareImage(ImageId image_id, bool is_modification, bool invalidate);
 
+    /// Prepare an image to be sampled, its contents may be uploaded asynchronously
+    void PrepareSampledImage(ImageId image_id);
+
     /// Prepare an image view to be used
     void PrepareImageView(ImageViewId image_view_id, bool is_modification, bool invalidate);
 
@@ -352,6 +408,15 @@ private:
 
     std::unordered_map<GPUVAddr, ImageAllocId> image_allocs_table;
 
+    ImageDiskCache disk_cache;
+
+    std::vector<u8> hash_scratch;
+    ContentHashStats content_hash_stats;
+
+    std::vector<ImageId> async_decode_ids;
+
+    u64 total_used_memory = 0;
+
     u64 modification_tick = 0;
     u64 frame_tick = 0;
 };
@@ -376,15 +441,37 @@ TextureCache<P>::TextureCache(Runtime& runtime_, VideoCore::RasterizerInterface&
     void(slot_samplers.insert(runtime, sampler_descriptor));
 }
 
+template <class P>
+TextureCache<P>::~TextureCache() {
+    // Workers must not touch guest memory or the disk cache once the cache is gone
+    for (const ImageId image_id : async_decode_ids) {
+        slot_images[image_id].async_decode->Cancel();
+    }
+    const ContentHashStats stats = GetContentHashStats();
+    if (stats.hits != 0 || stats.misses != 0) {
+        LOG_INFO(HW_GPU, "Texture content hash: {} uploads skipped, {} uploads changed",
+                 stats.hits, stats.misses);
+    }
+}
+
 template <class P>
 void TextureCache<P>::TickFrame() {
     // Tick sentenced resources in this order to ensure they are destroyed in the right order
     sentenced_images.Tick();
     sentenced_framebuffers.Tick();
     sentenced_image_view.Tick();
+    RunGarbageCollector();
     ++frame_tick;
 }
 
+template <class P>
+void TextureCache<P>::LoadDiskResources(u64 title_id, const std::atomic_bool& stop_loading) {
+    if (stop_loading) {
+        return;
+    }
+    disk_cache.BindTitleID(title_id);
+}
+
 template <class P>
 std::unique_lock<std::mutex> TextureCache<P>::AcquireLock() {
     return std::unique_lock{mutex};
@@ -537,8 +624,15 @@ ImageViewId TextureCache<P>::VisitImageView(DescriptorTable<TICEntry>& table,
     if (is_new) {
         image_view_id = FindImageView(descriptor);
     }
-    if (image_view_id != NULL_IMAGE_VIEW_ID) {
-        PrepareImageView(image_view_id, false, false);
+    if (image_view_id == NULL_IMAGE_VIEW_ID) {
+        return image_view_id;
+    }
+    const ImageId image_id = slot_image_views[image_view_id].image_id;
+    PrepareSampledImage(image_id);
+    const bool use_placeholders = Settings::values.use_texture_placeholders.GetValue();
+    if (use_placeholders && slot_images[image_id].async_decode) {
+        // Sample a null image until the contents are decoded, without caching it
+        return NULL_IMAGE_VIEW_ID;
     }
     return image_view_id;
 }
@@ -597,13 +691,9 @@ void TextureCache<P>::DownloadMemory(VAddr cpu_addr, size_t size) {
         return slot_images[lhs].modification_tick < slot_images[rhs].modification_tick;
     });
     for (const ImageId image_id : images) {
-        Image& image = slot_images[image_id];
-        auto map = runtime.MapDownloadBuffer(image.unswizzled_size_bytes);
-        const auto copies = FullDownloadCopies(image.info);
-        image.DownloadMemory(map, 0, copies);
-        runtime.Finish();
-        SwizzleImage(gpu_memory, image.gpu_addr, image.info, copies, map.Span());
+        WaitAsyncDecode(image_id);
     }
+    DownloadImages(images);
 }
 
 template <class P>
@@ -748,36 +838,30 @@ void TextureCache<P>::PopAsyncFlushes() {
     if (committed_downloads.empty()) {
         return;
     }
-    const std::span<const ImageId> download_ids = committed_downloads.front();
-    if (download_ids.empty()) {
-        committed_downloads.pop();
+    DownloadImages(committed_downloads.front());
+    committed_downloads.pop();
+}
+
+template <class P>
+void TextureCache<P>::CommitAsyncDecodes() {
+    if (async_decode_ids.empty()) {
         return;
     }
-    size_t total_size_bytes = 0;
-    for (const ImageId image_id : download_ids) {
-        total_size_bytes += slot_images[image_id].unswizzled_size_bytes;
-    }
-    auto download_map = runtime.MapDownloadBuffer(total_size_bytes);
-    size_t buffer_offset = 0;
-    for (const ImageId image_id : download_ids) {
+    const bool use_placeholders = Settings::values.use_texture_placeholders.GetValue();
+    std::erase_if(async_decode_ids, [this, use_placeholders](ImageId image_id) {
         Image& image = slot_images[image_id];
-        const auto copies = FullDownloadCopies(image.info);
-        image.DownloadMemory(download_map, buffer_offset, copies);
-        buffer_offset += image.unswizzled_size_bytes;
-    }
-    // Wait for downloads to finish
-    runtime.Finish();
+        if (use_placeholders && !image.async_decode->IsComplete()) {
+            return false;
+        }
+        image.async_decode->Wait();
+        UploadAsyncDecode(image, image_id);
+        return true;
+    });
+}
 
-    buffer_offset = 0;
-    const std::span<u8> download_span = download_map.Span();
-    for (const ImageId image_id : download_ids) {
-        const ImageBase& image = slot_images[image_id];
-        const auto copies = FullDownloadCopies(image.info);
-        const std::span<u8> image_download_span = download_span.subspan(buffer_offset);
-        SwizzleImage(gpu_memory, image.gpu_addr, image.info, copies, image_download_span);
-        buffer_offset += image.unswizzled_size_bytes;
-    }
-    committed_downloads.pop();
+template <class P>
+ContentHashStats TextureCache<P>::GetContentHashStats() const noexcept {
+    return content_hash_stats;
 }
 
 template <class P>
@@ -794,11 +878,13 @@ bool TextureCache<P>::IsRegionGpuModified(VAddr addr, size_t size) {
 }
 
 template <class P>
-void TextureCache<P>::RefreshContents(Image& image) {
+void TextureCache<P>::RefreshContents(Image& image, ImageId image_id, bool allow_async) {
     if (False(image.flags & ImageFlagBits::CpuModified)) {
         // Only upload modified images
         return;
     }
+    // The guest data changed again, a decode in flight would upload stale contents
+    CancelAsyncDecode(image, image_id);
     image.flags &= ~ImageFlagBits::CpuModified;
     TrackImage(image);
 
@@ -806,11 +892,84 @@ void TextureCache<P>::RefreshContents(Image& image) {
         LOG_WARNING(HW_GPU, "MSAA image uploads are not implemented");
         return;
     }
+    if (Settings::values.use_texture_content_hash.GetValue()) {
+        if (IsGuestDataUnchanged(image)) {
+            return;
+        }
+    } else {
+        // Uploads done without hashing would leave a stale hash behind
+        image.flags &= ~ImageFlagBits::Hashed;
+    }
+    if (allow_async && Settings::values.use_asynchronous_texture_decode.GetValue() &&
+        False(image.flags & ImageFlagBits::AcceleratedUpload) &&
+        image.info.type != ImageType::Buffer && MapSizeBytes(image) >= MIN_ASYNC_DECODE_SIZE) {
+        QueueAsyncDecode(image, image_id);
+        return;
+    }
     auto map = runtime.MapUploadBuffer(MapSizeBytes(image));
     UploadImageContents(image, map, 0);
     runtime.InsertUploadMemoryBarrier();
 }
 
+template <class P>
+void TextureCache<P>::QueueAsyncDecode(Image& image, ImageId image_id) {
+    image.async_decode = AsyncDecode::Queue(gpu_memory, disk_cache, image);
+    async_decode_ids.push_back(image_id);
+}
+
+template <class P>
+void TextureCache<P>::WaitAsyncDecode(ImageId image_id) {
+    Image& image = slot_images[image_id];
+    if (!image.async_decode) {
+        return;
+    }
+    image.async_decode->Wait();
+    UploadAsyncDecode(image, image_id);
+    std::erase(async_decode_ids, image_id);
+}
+
+template <class P>
+void TextureCache<P>::UploadAsyncDecode(Image& image, ImageId image_id) {
+    const std::span<const u8> data = image.async_decode->Data();
+    auto map = runtime.MapUploadBuffer(data.size());
+    std::memcpy(map.Span().data(), data.data(), data.size());
+    image.UploadMemory(map, 0, image.async_decode->Copies());
+    runtime.InsertUploadMemoryBarrier();
+    image.async_decode.reset();
+}
+
+template <class P>
+void TextureCache<P>::CancelAsyncDecode(Image& image, ImageId image_id) {
+    if (!image.async_decode) {
+        return;
+    }
+    image.async_decode->Cancel();
+    image.async_decode.reset();
+    std::erase(async_decode_ids, image_id);
+}
+
+template <class P>
+bool TextureCache<P>::IsGuestDataUnchanged(Image& image) {
+    // The hash is only meaningful while the host image still holds the data it was computed from,
+    // any modification from the GPU or from aliased images bumps the modification tick
+    const bool has_hash = True(image.flags & ImageFlagBits::Hashed) &&
+                          image.guest_hash_tick == image.modification_tick;
+
+    hash_scratch.resize(image.guest_size_bytes);
+    gpu_memory.ReadBlockUnsafe(image.gpu_addr, hash_scratch.data(), hash_scratch.size());
+    const u64 hash =
+        Common::CityHash64(reinterpret_cast<const char*>(hash_scratch.data()), hash_scratch.size());
+
+    const bool is_unchanged = has_hash && image.guest_hash == hash;
+    image.flags |= ImageFlagBits::Hashed;
+    image.guest_hash = hash;
+    image.guest_hash_tick = image.modification_tick;
+    if (has_hash) {
+        ++(is_unchanged ? content_hash_stats.hits : content_hash_stats.misses);
+    }
+    return is_unchanged;
+}
+
 template <class P>
 template <typename MapBuffer>
 void TextureCache<P>::UploadImageContents(Image& image, MapBuffer& map, size_t buffer_offset) {
@@ -822,9 +981,8 @@ void TextureCache<P>::UploadImageContents(Image& image, MapBuffer& map, size_t b
         const auto uploads = FullUploadSwizzles(image.info);
         runtime.AccelerateImageUpload(image, map, buffer_offset, uploads);
     } else if (True(image.flags & ImageFlagBits::Converted)) {
-        std::vector<u8> unswizzled_data(image.unswizzled_size_bytes);
-        auto copies = UnswizzleImage(gpu_memory, gpu_addr, image.info, unswizzled_data);
-        ConvertImage(unswizzled_data, image.info, mapped_span, copies);
+        const auto copies =
+            DecodeImageContents(gpu_memory, disk_cache, gpu_addr, image.info, true, mapped_span);
         image.UploadMemory(map, buffer_offset, copies);
     } else if (image.info.type == ImageType::Buffer) {
         const std::array copies{UploadBufferCopy(gpu_memory, gpu_addr, image, mapped_span)};
@@ -835,6 +993,118 @@ void TextureCache<P>::UploadImageContents(Image& image, MapBuffer& map, size_t b
     }
 }
 
+template <class P>
+void TextureCache<P>::DownloadImages(std::span<const ImageId> image_ids) {
+    if (image_ids.empty()) {
+        return;
+    }
+    size_t total_size_bytes = 0;
+    for (const ImageId image_id : image_ids) {
+        total_size_bytes += slot_images[image_id].unswizzled_size_bytes;
+    }
+    auto download_map = runtime.MapDownloadBuffer(total_size_bytes);
+    size_t buffer_offset = 0;
+    for (const ImageId image_id : image_ids) {
+        Image& image = slot_images[image_id];
+        const auto copies = FullDownloadCopies(image.info);
+        image.DownloadMemory(download_map, buffer_offset, copies);
+        buffer_offset += image.unswizzled_size_bytes;
+    }
+    // Wait for downloads to finish
+    runtime.Finish();
+
+    buffer_offset = 0;
+    const std::span<u8> download_span = download_map.Span();
+    for (const ImageId image_id : image_ids) {
+        const ImageBase& image = slot_images[image_id];
+        const auto copies = FullDownloadCopies(image.info);
+        const std::span<u8> image_download_span = download_span.subspan(buffer_offset);
+        SwizzleImage(gpu_memory, image.gpu_addr, image.info, copies, image_download_span);
+        buffer_offset += image.unswizzled_size_bytes;
+    }
+}
+
+template <class P>
+void TextureCache<P>::RunGarbageCollector() {
+    const u64 budget = u64{Settings::values.texture_cache_budget.GetValue()} << 20;
+    if (budget == 0 || total_used_memory <= budget) {
+        return;
+    }
+    // Evict below the budget to avoid running the collector again on the next frame
+    const u64 target = budget - budget / 8;
+
+    std::vector<ImageId> candidates;
+    for (const auto& [gpu_addr, alloc_id] : image_allocs_table) {
+        for (const ImageId image_id : slot_image_allocs[alloc_id].images) {
+            const ImageBase& image = slot_images[image_id];
+            if (image.frame_tick + FRAMES_TO_KEEP > frame_tick) {
+                continue;
+            }
+            if (False(image.flags & ImageFlagBits::Registered)) {
+                continue;
+            }
+            if (True(image.flags & ImageFlagBits::GpuModified) &&
+                (image.info.num_samples > 1 || True(image.flags & ImageFlagBits::Converted))) {
+                // MSAA and converted (decoded ASTC or BCn) images can't be written back, dropping
+                // them would lose their contents
+                continue;
+            }
+            candidates.push_back(image_id);
+        }
+    }
+    std::ranges::sort(candidates, [this](ImageId lhs, ImageId rhs) {
+        return slot_images[lhs].frame_tick < slot_images[rhs].frame_tick;
+    });
+
+    // Pick the images to evict first, so their contents are downloaded with a single wait
+    std::vector<ImageId> evicted_ids;
+    std::vector<ImageId> download_ids;
+    u64 used_memory = total_used_memory;
+    for (const ImageId image_id : candidates) {
+        if (used_memory <= target) {
+            break;
+        }
+        const ImageBase& image = slot_images[image_id];
+        if (True(image.flags & ImageFlagBits::GpuModified) &&
+            False(image.flags & ImageFlagBits::CpuModified)) {
+            download_ids.push_back(image_id);
+        }
+        used_memory -= HostMemoryUsage(image);
+        evicted_ids.push_back(image_id);
+    }
+    DownloadImages(download_ids);
+
+    const u64 used_memory_before = total_used_memory;
+    for (const ImageId image_id : evicted_ids) {
+        Image& image = slot_images[image_id];
+        // Older aliases would have copied their contents from this image on their next use
+        boost::container::small_vector<ImageId, 4> stale_aliases;
+        for (const AliasedImage& alias : image.aliased_images) {
+            if (slot_images[alias.id].modification_tick < image.modification_tick) {
+                stale_aliases.push_back(alias.id);
+            }
+        }
+        for (const ImageId alias_id : stale_aliases) {
+            SynchronizeAliases(alias_id);
+        }
+        if (True(image.flags & ImageFlagBits::Tracked)) {
+            UntrackImage(image);
+        }
+        UnregisterImage(image_id);
+        DeleteImage(image_id);
+    }
+    LOG_DEBUG(HW_GPU, "Evicted {} images, texture cache memory went from {} to {} MiB",
+              evicted_ids.size(), used_memory_before >> 20, total_used_memory >> 20);
+}
+
+template <class P>
+u64 TextureCache<P>::HostMemoryUsage(const ImageBase& image) noexcept {
+    if (True(image.flags & ImageFlagBits::Converted)) {
+        return image.converted_size_bytes;
+    }
+    return image.unswizzled_size_bytes;
+}
+
 template <class P>
 ImageViewId TextureCache<P>::FindImageView(const TICEntry& config) {
     if (!IsValidAddress(gpu_memory, config)) {
@@ -965,9 +1235,10 @@ ImageId TextureCache<P>::JoinImages(const ImageInfo& info, GPUVAddr gpu_addr, VA
     Image& new_image = slot_images[new_image_id];
 
     // TODO: Only upload what we need
-    RefreshContents(new_image);
+    RefreshContents(new_image, new_image_id);
 
     for (const ImageId overlap_id : overlap_ids) {
+        WaitAsyncDecode(overlap_id);
         Image& overlap = slot_images[overlap_id];
         if (overlap.info.num_samples != new_image.info.num_samples) {
             LOG_WARNING(HW_GPU, "Copying between images with different samples is not implemented");
@@ -982,6 +1253,12 @@ ImageId TextureCache<P>::JoinImages(const ImageInfo& info, GPUVAddr gpu_addr, VA
         UnregisterImage(overlap_id);
         DeleteImage(overlap_id);
     }
+    if (!overlap_ids.empty()) {
+        // The host contents of the overlaps may have been rendered by the GPU, so they don't
+        // match the guest data hashed by RefreshContents. Forget the hash, otherwise a later CPU
+        // write restoring the same guest bytes would skip the upload and keep the copied contents.
+        new_image.flags &= ~ImageFlagBits::Hashed;
+    }
     ImageBase& new_image_base = new_image;
     for (const ImageId aliased_id : right_aliased_ids) {
         ImageBase& aliased = slot_images[aliased_id];
@@ -1157,6 +1434,7 @@ void TextureCache<P>::RegisterImage(ImageId image_id) {
     ASSERT_MSG(False(image.flags & ImageFlagBits::Registered),
                "Trying to register an already registered image");
     image.flags |= ImageFlagBits::Registered;
+    total_used_memory += HostMemoryUsage(image);
     ForEachPage(image.cpu_addr, image.guest_size_bytes,
                 [this, image_id](u64 page) { page_table[page].push_back(image_id); });
 }
@@ -1167,6 +1445,7 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
     ASSERT_MSG(True(image.flags & ImageFlagBits::Registered),
                "Trying to unregister an already registered image");
     image.flags &= ~ImageFlagBits::Registered;
+    total_used_memory -= HostMemoryUsage(image);
     ForEachPage(image.cpu_addr, image.guest_size_bytes, [this, image_id](u64 page) {
         const auto page_it = page_table.find(page);
         if (page_it == page_table.end()) {
@@ -1216,6 +1495,7 @@ void TextureCache<P>::DeleteImage(ImageId image_id) {
     }
     ASSERT_MSG(False(image.flags & ImageFlagBits::Tracked), "Image was not untracked");
     ASSERT_MSG(False(image.flags & ImageFlagBits::Registered), "Image was not unregistered");
+    CancelAsyncDecode(slot_images[image_id], image_id);
 
     // Mark render targets as dirty
     auto& dirty = maxwell3d.dirty.flags;
@@ -1324,12 +1604,14 @@ template <class P>
 void TextureCache<P>::PrepareImage(ImageId image_id, bool is_modification, bool invalidate) {
     Image& image = slot_images[image_id];
     if (invalidate) {
+        CancelAsyncDecode(image, image_id);
         image.flags &= ~(ImageFlagBits::CpuModified | ImageFlagBits::GpuModified);
         if (False(image.flags & ImageFlagBits::Tracked)) {
             TrackImage(image);
         }
     } else {
-        RefreshContents(image);
+        WaitAsyncDecode(image_id);
+        RefreshContents(image, image_id);
         SynchronizeAliases(image_id);
     }
     if (is_modification) {
@@ -1338,6 +1620,14 @@ void TextureCache<P>::PrepareImage(ImageId image_id, bool is_modification, bool
     image.frame_tick = frame_tick;
 }
 
+template <class P>
+void TextureCache<P>::PrepareSampledImage(ImageId image_id) {
+    Image& image = slot_images[image_id];
+    RefreshContents(image, image_id, true);
+    SynchronizeAliases(image_id);
+    image.frame_tick = frame_tick;
+}
+
 template <class P>
 void TextureCache<P>::PrepareImageView(ImageViewId image_view_id, bool is_modification,
                                        bool invalidate) {
@@ -1350,6 +1640,9 @@ void TextureCache<P>::PrepareImageView(ImageViewId image_view_id, bool is_modifi
 
 template <class P>
 void TextureCache<P>::CopyImage(ImageId dst_id, ImageId src_id, std::span<const ImageCopy> copies) {
+    // Copies have to be ordered after the pending uploads of both images
+    WaitAsyncDecode(dst_id);
+    WaitAsyncDecode(src_id);
     Image& dst = slot_images[dst_id];
     Image& src = slot_images[src_id];
     const auto dst_format_type = GetFormatType(dst.info.format);
@@ -42,7 +42,7 @@
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/memory_manager.h"
 #include "video_core/surface.h"
-#include "video_core/texture_cache/decode_bc4.h"
+#include "video_core/texture_cache/decode_bc.h"
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/texture_cache/formatter.h"
 #include "video_core/texture_cache/samples_helper.h"
@@ -623,6 +623,16 @@ void SwizzleBlockLinearImage(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr
     ASSERT(host_offset - copy.buffer_offset == copy.buffer_size);
 }
 
+/// Updates an unswizzled copy to describe its converted contents, returns the next output offset
+[[nodiscard]] u32 ConvertCopy(BufferImageCopy& copy, Extent3D mip_size, u32 output_offset) {
+    copy.buffer_offset = output_offset;
+    copy.buffer_row_length = mip_size.width;
+    copy.buffer_image_height = mip_size.height;
+
+    return output_offset + copy.image_extent.width * copy.image_extent.height *
+                               copy.image_subresource.num_layers * CONVERTED_BYTES_PER_BLOCK;
+}
+
 } // Anonymous namespace
 
 u32 CalculateGuestSizeInBytes(const ImageInfo& info) noexcept {
@@ -921,15 +931,23 @@ void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8
                                              copy.image_subresource.num_layers, tile_size.width,
                                              tile_size.height, output.subspan(output_offset));
         } else {
-            DecompressBC4(input.subspan(copy.buffer_offset), copy.image_extent,
+            const Extent3D extent{
+                .width = copy.image_extent.width,
+                .height = copy.image_extent.height,
+                .depth = copy.image_extent.depth * copy.image_subresource.num_layers,
+            };
+            DecompressBCn(input.subspan(copy.buffer_offset), extent, info.format,
                           output.subspan(output_offset));
         }
-        copy.buffer_offset = output_offset;
-        copy.buffer_row_length = mip_size.width;
-        copy.buffer_image_height = mip_size.height;
+        output_offset = ConvertCopy(copy, mip_size, output_offset);
+    }
+}
 
-        output_offset += copy.image_extent.width * copy.image_extent.height *
-                         copy.image_subresource.num_layers * CONVERTED_BYTES_PER_BLOCK;
+void ConvertImageCopies(const ImageInfo& info, std::span<BufferImageCopy> copies) {
+    u32 output_offset = 0;
+    for (BufferImageCopy& copy : copies) {
+        const Extent3D mip_size = AdjustMipSize(info.size, copy.image_subresource.base_level);
+        output_offset = ConvertCopy(copy, mip_size, output_offset);
     }
 }
 
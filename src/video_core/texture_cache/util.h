@@ -66,6 +66,9 @@ struct OverlapResult {
 void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8> output,
                   std::span<BufferImageCopy> copies);
 
+/// Updates the unswizzled copies of an image to describe its converted contents
+void ConvertImageCopies(const ImageInfo& info, std::span<BufferImageCopy> copies);
+
 [[nodiscard]] std::vector<BufferImageCopy> FullDownloadCopies(const ImageInfo& info);
 
 [[nodiscard]] Extent3D MipSize(Extent3D size, u32 level);
@@ -26,6 +26,7 @@
 #include "common/common_types.h"
 
 #include "video_core/textures/astc.h"
+#include "video_core/textures/workers.h"
 
 namespace {
 
@@ -1679,12 +1680,28 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
 
 namespace Tegra::Texture::ASTC {
 
+/// Minimum number of blocks decoded by a single task, small images are decoded by the caller
+constexpr u32 MIN_BLOCKS_PER_TASK = 256;
+
 void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
                 uint32_t block_width, uint32_t block_height, std::span<uint8_t> output) {
-    u32 block_index = 0;
-    std::size_t depth_offset = 0;
-    for (u32 z = 0; z < depth; z++) {
-        for (u32 y = 0; y < height; y += block_height) {
+    // Rows of blocks are decoded in parallel, every block writes to its own region of the output
+    // and keeps its bit streams and integer sequences on the stack of the decoding thread
+    const u32 blocks_x = (width + block_width - 1) / block_width;
+    const u32 blocks_y = (height + block_height - 1) / block_height;
+    const u32 rows_per_task = std::max(MIN_BLOCKS_PER_TASK / blocks_x, 1U);
+    const u32 num_rows = blocks_y * depth;
+    const u32 num_tasks = (num_rows + rows_per_task - 1) / rows_per_task;
+
+    ParallelFor(num_tasks, [&](u32 task) {
+        const u32 first_row = task * rows_per_task;
+        const u32 last_row = std::min(first_row + rows_per_task, num_rows);
+        for (u32 row = first_row; row < last_row; ++row) {
+            const u32 z = row / blocks_y;
+            const u32 y = (row % blocks_y) * block_height;
+            const std::size_t depth_offset = static_cast<std::size_t>(z) * height * width * 4;
+
+            u32 block_index = row * blocks_x;
             for (u32 x = 0; x < width; x += block_width) {
                 const std::span<const u8, 16> blockPtr{data.subspan(block_index * 16, 16)};
 
@@ -1703,8 +1720,7 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
                 ++block_index;
             }
         }
-        depth_offset += height * width * 4;
-    }
+    });
 }
 
 } // namespace Tegra::Texture::ASTC
@@ -2,10 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstring>
 #include <span>
+#include <type_traits>
 #include <utility>
 
 #include "common/alignment.h"
@@ -37,6 +39,97 @@ constexpr SwizzleTable MakeSwizzleTableConst() {
 
 constexpr SwizzleTable SWIZZLE_TABLE = MakeSwizzleTableConst();
 
+/// Number of contiguous bytes in a GOB line. Bytes inside a sector keep their linear order.
+constexpr u32 SECTOR_SIZE_X = 16;
+constexpr u32 SECTOR_SIZE_X_MASK = SECTOR_SIZE_X - 1;
+
+/// Offsets of the four sectors of a GOB line relative to the first one
+constexpr std::array<u32, GOB_SIZE_X / SECTOR_SIZE_X> SECTOR_OFFSETS{
+    SWIZZLE_TABLE[0][SECTOR_SIZE_X * 0],
+    SWIZZLE_TABLE[0][SECTOR_SIZE_X * 1],
+    SWIZZLE_TABLE[0][SECTOR_SIZE_X * 2],
+    SWIZZLE_TABLE[0][SECTOR_SIZE_X * 3],
+};
+
+/// Pointer to the block linear side of a copy, only written when swizzling
+template <bool TO_LINEAR>
+using SwizzledPointer = std::conditional_t<TO_LINEAR, u8*, const u8*>;
+
+/// Pointer to the linear side of a copy, only written when unswizzling
+template <bool TO_LINEAR>
+using UnswizzledPointer = std::conditional_t<TO_LINEAR, const u8*, u8*>;
+
+template <bool TO_LINEAR>
+void CopyBytes(SwizzledPointer<TO_LINEAR> swizzled, UnswizzledPointer<TO_LINEAR> unswizzled,
+               std::size_t size) {
+    if constexpr (TO_LINEAR) {
+        std::memcpy(swizzled, unswizzled, size);
+    } else {
+        std::memcpy(unswizzled, swizzled, size);
+    }
+}
+
+template <bool TO_LINEAR>
+void CopySector(SwizzledPointer<TO_LINEAR> swizzled, UnswizzledPointer<TO_LINEAR> unswizzled) {
+    // Constant sized copies are lowered to a single vector move by the compiler
+    if constexpr (TO_LINEAR) {
+        std::memcpy(swizzled, unswizzled, SECTOR_SIZE_X);
+    } else {
+        std::memcpy(unswizzled, swizzled, SECTOR_SIZE_X);
+    }
+}
+
+/**
+ * Copies a line of bytes between a block linear surface and linear memory.
+ * Swizzling is byte addressed, so a line is copied in 16 bytes sectors regardless of the pixel
+ * format. Whole GOB lines are copied with four sector moves each.
+ * @param swizzled   Pointer to the first GOB of the line, with the line offset already applied
+ * @param unswizzled Pointer to the linear line
+ * @param table      Swizzle table row of the line
+ * @param x          Byte column of the first byte to copy
+ * @param size       Number of bytes to copy
+ * @param gob_stride Number of bytes between two horizontally adjacent GOBs
+ */
+template <bool TO_LINEAR>
+void SwizzleLine(SwizzledPointer<TO_LINEAR> swizzled, UnswizzledPointer<TO_LINEAR> unswizzled,
+                 const std::array<u32, GOB_SIZE_X>& table, u32 x, u32 size, u32 gob_stride) {
+    const u32 end = x + size;
+    const auto swizzled_ptr = [&](u32 column) {
+        return swizzled + (column >> GOB_SIZE_X_SHIFT) * gob_stride + table[column % GOB_SIZE_X];
+    };
+    // Copy the unaligned head up to the next sector boundary
+    if ((x & SECTOR_SIZE_X_MASK) != 0) {
+        const u32 length = std::min(SECTOR_SIZE_X - (x & SECTOR_SIZE_X_MASK), end - x);
+        CopyBytes<TO_LINEAR>(swizzled_ptr(x), unswizzled, length);
+        unswizzled += length;
+        x += length;
+    }
+    // Copy sectors until the next GOB boundary
+    while ((x % GOB_SIZE_X) != 0 && x + SECTOR_SIZE_X <= end) {
+        CopySector<TO_LINEAR>(swizzled_ptr(x), unswizzled);
+        unswizzled += SECTOR_SIZE_X;
+        x += SECTOR_SIZE_X;
+    }
+    // Copy whole GOB lines
+    if (x + GOB_SIZE_X <= end) {
+        SwizzledPointer<TO_LINEAR> gob = swizzled_ptr(x);
+        for (; x + GOB_SIZE_X <= end; x += GOB_SIZE_X, gob += gob_stride) {
+            for (const u32 sector_offset : SECTOR_OFFSETS) {
+                CopySector<TO_LINEAR>(gob + sector_offset, unswizzled);
+                unswizzled += SECTOR_SIZE_X;
+            }
+        }
+    }
+    // Copy the remaining sectors and the tail
+    for (; x + SECTOR_SIZE_X <= end; x += SECTOR_SIZE_X) {
+        CopySector<TO_LINEAR>(swizzled_ptr(x), unswizzled);
+        unswizzled += SECTOR_SIZE_X;
+    }
+    if (x < end) {
+        CopyBytes<TO_LINEAR>(swizzled_ptr(x), unswizzled, end - x);
+    }
+}
+
 template <bool TO_LINEAR>
 void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel, u32 width,
              u32 height, u32 depth, u32 block_height, u32 block_depth, u32 stride_alignment) {
@@ -60,6 +153,16 @@ void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixe
     const u32 block_depth_mask = (1U << block_depth) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
 
+    SwizzledPointer<TO_LINEAR> swizzled_data;
+    UnswizzledPointer<TO_LINEAR> unswizzled_data;
+    if constexpr (TO_LINEAR) {
+        swizzled_data = output.data();
+        unswizzled_data = input.data();
+    } else {
+        swizzled_data = input.data();
+        unswizzled_data = output.data();
+    }
+
     for (u32 slice = 0; slice < depth; ++slice) {
         const u32 z = slice + origin_z;
         const u32 offset_z = (z >> block_depth) * slice_size +
@@ -72,20 +175,10 @@ void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixe
             const u32 offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
 
-            for (u32 column = 0; column < width; ++column) {
-                const u32 x = (column + origin_x) * bytes_per_pixel;
-                const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-                const u32 base_swizzled_offset = offset_z + offset_y + offset_x;
-                const u32 swizzled_offset = base_swizzled_offset + table[x % GOB_SIZE_X];
-
-                const u32 unswizzled_offset =
-                    slice * pitch * height + line * pitch + column * bytes_per_pixel;
-
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
-                std::memcpy(dst, src, bytes_per_pixel);
-            }
+            const u32 unswizzled_offset = slice * pitch * height + line * pitch;
+            SwizzleLine<TO_LINEAR>(swizzled_data + offset_z + offset_y,
+                                   unswizzled_data + unswizzled_offset, table,
+                                   origin_x * bytes_per_pixel, pitch, 1U << x_shift);
         }
     }
 }
@@ -121,17 +214,9 @@ void SwizzleSubrect(u32 subrect_width, u32 subrect_height, u32 source_pitch, u32
             (dst_y / (GOB_SIZE_Y * block_height)) * GOB_SIZE * block_height * image_width_in_gobs +
             ((dst_y % (GOB_SIZE_Y * block_height)) / GOB_SIZE_Y) * GOB_SIZE;
         const auto& table = SWIZZLE_TABLE[dst_y % GOB_SIZE_Y];
-        for (u32 x = 0; x < subrect_width; ++x) {
-            const u32 dst_x = x + offset_x;
-            const u32 gob_address =
-                gob_address_y + (dst_x * bytes_per_pixel / GOB_SIZE_X) * GOB_SIZE * block_height;
-            const u32 swizzled_offset = gob_address + table[(dst_x * bytes_per_pixel) % GOB_SIZE_X];
-            const u32 unswizzled_offset = line * source_pitch + x * bytes_per_pixel;
-
-            const u8* const source_line = unswizzled_data + unswizzled_offset;
-            u8* const dest_addr = swizzled_data + swizzled_offset;
-            std::memcpy(dest_addr, source_line, bytes_per_pixel);
-        }
+        SwizzleLine<true>(swizzled_data + gob_address_y, unswizzled_data + line * source_pitch,
+                          table, offset_x * bytes_per_pixel, subrect_width * bytes_per_pixel,
+                          GOB_SIZE * block_height);
     }
 }
 
@@ -151,15 +236,9 @@ void UnswizzleSubrect(u32 line_length_in, u32 line_count, u32 pitch, u32 width,
         const u32 block_y = src_y >> GOB_SIZE_Y_SHIFT;
         const u32 src_offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
-        for (u32 column = 0; column < line_length_in; ++column) {
-            const u32 src_x = (column + origin_x) * bytes_per_pixel;
-            const u32 src_offset_x = (src_x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-            const u32 swizzled_offset = src_offset_y + src_offset_x + table[src_x % GOB_SIZE_X];
-            const u32 unswizzled_offset = line * pitch + column * bytes_per_pixel;
-
-            std::memcpy(output + unswizzled_offset, input + swizzled_offset, bytes_per_pixel);
-        }
+        SwizzleLine<false>(input + src_offset_y, output + line * pitch, table,
+                           origin_x * bytes_per_pixel, line_length_in * bytes_per_pixel,
+                           1U << x_shift);
     }
 }
 
@@ -195,22 +274,20 @@ void SwizzleKepler(const u32 width, const u32 height, const u32 dst_x, const u32
                    u8* swizzle_data) {
     const u32 block_height = 1U << block_height_bit;
     const u32 image_width_in_gobs{(width + GOB_SIZE_X - 1) / GOB_SIZE_X};
+    if (dst_x >= width) {
+        return;
+    }
     std::size_t count = 0;
-    for (std::size_t y = dst_y; y < height && count < copy_size; ++y) {
+    for (u32 y = dst_y; y < height && count < copy_size; ++y) {
         const std::size_t gob_address_y =
             (y / (GOB_SIZE_Y * block_height)) * GOB_SIZE * block_height * image_width_in_gobs +
             ((y % (GOB_SIZE_Y * block_height)) / GOB_SIZE_Y) * GOB_SIZE;
         const auto& table = SWIZZLE_TABLE[y % GOB_SIZE_Y];
-        for (std::size_t x = dst_x; x < width && count < copy_size; ++x) {
-            const std::size_t gob_address =
-                gob_address_y + (x / GOB_SIZE_X) * GOB_SIZE * block_height;
-            const std::size_t swizzled_offset = gob_address + table[x % GOB_SIZE_X];
-            const u8* source_line = source_data + count;
-            u8* dest_addr = swizzle_data + swizzled_offset;
-            count++;
-
-            std::memcpy(dest_addr, source_line, 1);
-        }
+        const u32 line_size =
+            static_cast<u32>(std::min<std::size_t>(width - dst_x, copy_size - count));
+        SwizzleLine<true>(swizzle_data + gob_address_y, source_data + count, table, dst_x,
+                          line_size, GOB_SIZE * block_height);
+        count += line_size;
     }
 }
 
@@ -0,0 +1,83 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "common/thread_worker.h"
+#include "video_core/textures/workers.h"
+
+namespace Tegra::Texture {
+
+namespace {
+u32 NumThreadWorkers() {
+    // Leave one core for the GPU thread, which takes part in the work itself
+    static const u32 num_workers = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+    return num_workers;
+}
+
+struct ParallelForState {
+    explicit ParallelForState(u32 count_, const std::function<void(u32)>& func_)
+        : count{count_}, func{func_} {}
+
+    /// Processes indices until none are left, notifies the caller if the last one was done here
+    void Run() {
+        u32 num_processed = 0;
+        for (u32 index; (index = next_index.fetch_add(1, std::memory_order_relaxed)) < count;) {
+            func(index);
+            ++num_processed;
+        }
+        if (num_processed == 0) {
+            return;
+        }
+        if (num_done.fetch_add(num_processed, std::memory_order_acq_rel) + num_processed == count) {
+            std::scoped_lock lock{mutex};
+            done_condition.notify_all();
+        }
+    }
+
+    void Wait() {
+        std::unique_lock lock{mutex};
+        done_condition.wait(
+            lock, [this] { return num_done.load(std::memory_order_acquire) == count; });
+    }
+
+    const u32 count;
+    const std::function<void(u32)>& func;
+    std::atomic<u32> next_index{};
+    std::atomic<u32> num_done{};
+    std::mutex mutex;
+    std::condition_variable done_condition;
+};
+} // Anonymous namespace
+
+Common::ThreadWorker& GetThreadWorkers() {
+    static Common::ThreadWorker workers{NumThreadWorkers(), "yuzu:ImageTranscode"};
+    return workers;
+}
+
+void ParallelFor(u32 count, const std::function<void(u32)>& func) {
+    if (count <= 1) {
+        for (u32 index = 0; index < count; ++index) {
+            func(index);
+        }
+        return;
+    }
+    // Workers that start late find no indices left and only touch the shared state, so it is
+    // reference counted while 'func' is guaranteed to outlive every call made to it
+    const auto state = std::make_shared<ParallelForState>(count, func);
+    const u32 num_helpers = std::min(NumThreadWorkers(), count - 1);
+    Common::ThreadWorker& workers = GetThreadWorkers();
+    for (u32 helper = 0; helper < num_helpers; ++helper) {
+        workers.QueueWork([state] { state->Run(); });
+    }
+    state->Run();
+    state->Wait();
+}
+
+} // namespace Tegra::Texture
@@ -0,0 +1,28 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+
+#include "common/common_types.h"
+
+namespace Common {
+class ThreadWorker;
+}
+
+namespace Tegra::Texture {
+
+/// Returns the thread pool shared by the image transcoders
+Common::ThreadWorker& GetThreadWorkers();
+
+/**
+ * Calls func for every index in [0, count), splitting the indices across the transcoding workers.
+ * The calling thread takes part in the work, so it always makes progress even when the workers
+ * are busy. Returns once every index has been processed.
+ * Invocations for different indices may run concurrently and must write to disjoint memory.
+ */
+void ParallelFor(u32 count, const std::function<void(u32)>& func);
+
+} // namespace Tegra::Texture
@@ -233,7 +233,7 @@ Device::Device(VkInstance instance_, vk::PhysicalDevice physical_, VkSurfaceKHR
         .samplerAnisotropy = true,
         .textureCompressionETC2 = false,
         .textureCompressionASTC_LDR = is_optimal_astc_supported,
-        .textureCompressionBC = false,
+        .textureCompressionBC = is_optimal_bcn_supported,
         .occlusionQueryPrecise = true,
         .pipelineStatisticsQuery = false,
         .vertexPipelineStoresAndAtomics = true,
@@ -509,6 +509,31 @@ bool Device::IsOptimalAstcSupported(const VkPhysicalDeviceFeatures& features) co
     return true;
 }
 
+bool Device::IsOptimalBcnSupported(const VkPhysicalDeviceFeatures& features) const {
+    static constexpr std::array bcn_formats = {
+        VK_FORMAT_BC1_RGBA_UNORM_BLOCK, VK_FORMAT_BC1_RGBA_SRGB_BLOCK, VK_FORMAT_BC2_UNORM_BLOCK,
+        VK_FORMAT_BC2_SRGB_BLOCK,       VK_FORMAT_BC3_UNORM_BLOCK,     VK_FORMAT_BC3_SRGB_BLOCK,
+        VK_FORMAT_BC4_UNORM_BLOCK,      VK_FORMAT_BC4_SNORM_BLOCK,     VK_FORMAT_BC5_UNORM_BLOCK,
+        VK_FORMAT_BC5_SNORM_BLOCK,      VK_FORMAT_BC6H_UFLOAT_BLOCK,   VK_FORMAT_BC6H_SFLOAT_BLOCK,
+        VK_FORMAT_BC7_UNORM_BLOCK,      VK_FORMAT_BC7_SRGB_BLOCK,
+    };
+    if (!features.textureCompressionBC) {
+        return false;
+    }
+    // Compressed formats can't be blitted into, only sampling and transfers are required
+    static constexpr VkFormatFeatureFlags format_feature_usage =
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT |
+        VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    for (const auto format : bcn_formats) {
+        const auto physical_format_properties{physical.GetFormatProperties(format)};
+        if ((physical_format_properties.optimalTilingFeatures & format_feature_usage) !=
+            format_feature_usage) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool Device::TestDepthStencilBlits() const {
     static constexpr VkFormatFeatureFlags required_features =
         VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
@@ -784,6 +809,7 @@ void Device::SetupFeatures() {
     is_shader_storage_image_multisample = supported_features.shaderStorageImageMultisample;
     is_blit_depth_stencil_supported = TestDepthStencilBlits();
     is_optimal_astc_supported = IsOptimalAstcSupported(supported_features);
+    is_optimal_bcn_supported = IsOptimalBcnSupported(supported_features);
 }
 
 void Device::CollectTelemetryParameters() {
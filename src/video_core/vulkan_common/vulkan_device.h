@@ -130,6 +130,11 @@ public:
         return is_optimal_astc_supported;
     }
 
+    /// Returns true if BC1 to BC7 are natively supported.
+    bool IsOptimalBcnSupported() const {
+        return is_optimal_bcn_supported;
+    }
+
     /// Returns true if the device supports float16 natively
     bool IsFloat16Supported() const {
         return is_float16_supported;
@@ -250,6 +255,9 @@ private:
     /// Returns true if ASTC textures are natively supported.
     bool IsOptimalAstcSupported(const VkPhysicalDeviceFeatures& features) const;
 
+    /// Returns true if BCn textures are natively supported.
+    bool IsOptimalBcnSupported(const VkPhysicalDeviceFeatures& features) const;
+
     /// Returns true if the device natively supports blitting depth stencil images.
     bool TestDepthStencilBlits() const;
 
@@ -270,6 +278,7 @@ private:
     VkDriverIdKHR driver_id{};              ///< Driver ID.
     VkShaderStageFlags guest_warp_stages{}; ///< Stages where the guest warp size can be forced.ed
     bool is_optimal_astc_supported{};       ///< Support for native ASTC.
+    bool is_optimal_bcn_supported{};        ///< Support for native BCn.
     bool is_float16_supported{};            ///< Support for float16 arithmetics.
     bool is_warp_potentially_bigger{};      ///< Host warp size can be bigger than guest.
     bool is_formatless_image_load_supported{};  ///< Support for shader image read without format.
@@ -545,6 +545,9 @@ bool GRenderWindow::InitRenderTarget() {
             return false;
         }
         break;
+    case Settings::RendererBackend::Null:
+        InitializeNull();
+        break;
     }
 
     // Update the Window System information with the new render target
@@ -638,6 +641,12 @@ bool GRenderWindow::InitializeVulkan() {
     return true;
 }
 
+void GRenderWindow::InitializeNull() {
+    child_widget = new RenderWidget(this);
+    child_widget->windowHandle()->create();
+    main_context = std::make_unique<DummyContext>();
+}
+
 bool GRenderWindow::LoadOpenGL() {
     auto context = CreateSharedContext();
     auto scope = context->Acquire();
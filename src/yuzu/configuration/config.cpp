@@ -641,6 +641,10 @@ void Config::ReadDebuggingValues() {
     Settings::values.quest_flag = ReadSetting(QStringLiteral("quest_flag"), false).toBool();
     Settings::values.disable_macro_jit =
         ReadSetting(QStringLiteral("disable_macro_jit"), false).toBool();
+    Settings::values.profile_macros =
+        ReadSetting(QStringLiteral("profile_macros"), false).toBool();
+    Settings::values.record_gpu_commands =
+        ReadSetting(QStringLiteral("record_gpu_commands"), false).toBool();
     Settings::values.extended_logging =
         ReadSetting(QStringLiteral("extended_logging"), false).toBool();
 
@@ -778,6 +782,16 @@ void Config::ReadRendererValues() {
     ReadSettingGlobal(Settings::values.frame_limit, QStringLiteral("frame_limit"), 100);
     ReadSettingGlobal(Settings::values.use_disk_shader_cache,
                       QStringLiteral("use_disk_shader_cache"), true);
+    ReadSettingGlobal(Settings::values.use_disk_texture_cache,
+                      QStringLiteral("use_disk_texture_cache"), false);
+    ReadSettingGlobal(Settings::values.use_texture_content_hash,
+                      QStringLiteral("use_texture_content_hash"), false);
+    ReadSettingGlobal(Settings::values.texture_cache_budget,
+                      QStringLiteral("texture_cache_budget"), 0);
+    ReadSettingGlobal(Settings::values.use_asynchronous_texture_decode,
+                      QStringLiteral("use_asynchronous_texture_decode"), false);
+    ReadSettingGlobal(Settings::values.use_texture_placeholders,
+                      QStringLiteral("use_texture_placeholders"), false);
     ReadSettingGlobal(Settings::values.gpu_accuracy, QStringLiteral("gpu_accuracy"), 0);
     ReadSettingGlobal(Settings::values.use_asynchronous_gpu_emulation,
                       QStringLiteral("use_asynchronous_gpu_emulation"), true);
@@ -1235,6 +1249,9 @@ void Config::SaveDebuggingValues() {
     WriteSetting(QStringLiteral("dump_nso"), Settings::values.dump_nso, false);
     WriteSetting(QStringLiteral("quest_flag"), Settings::values.quest_flag, false);
     WriteSetting(QStringLiteral("disable_macro_jit"), Settings::values.disable_macro_jit, false);
+    WriteSetting(QStringLiteral("profile_macros"), Settings::values.profile_macros, false);
+    WriteSetting(QStringLiteral("record_gpu_commands"), Settings::values.record_gpu_commands,
+                 false);
 
     qt_config->endGroup();
 }
@@ -1343,6 +1360,16 @@ void Config::SaveRendererValues() {
     WriteSettingGlobal(QStringLiteral("frame_limit"), Settings::values.frame_limit, 100);
     WriteSettingGlobal(QStringLiteral("use_disk_shader_cache"),
                        Settings::values.use_disk_shader_cache, true);
+    WriteSettingGlobal(QStringLiteral("use_disk_texture_cache"),
+                       Settings::values.use_disk_texture_cache, false);
+    WriteSettingGlobal(QStringLiteral("use_texture_content_hash"),
+                       Settings::values.use_texture_content_hash, false);
+    WriteSettingGlobal(QStringLiteral("texture_cache_budget"),
+                       Settings::values.texture_cache_budget, 0);
+    WriteSettingGlobal(QStringLiteral("use_asynchronous_texture_decode"),
+                       Settings::values.use_asynchronous_texture_decode, false);
+    WriteSettingGlobal(QStringLiteral("use_texture_placeholders"),
+                       Settings::values.use_texture_placeholders, false);
     WriteSettingGlobal(QStringLiteral("gpu_accuracy"),
                        static_cast<int>(Settings::values.gpu_accuracy.GetValue(global)),
                        Settings::values.gpu_accuracy.UsingGlobal(), 0);
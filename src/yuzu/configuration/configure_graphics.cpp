@@ -205,6 +205,10 @@ void ConfigureGraphics::UpdateDeviceComboBox() {
         ui->device->setCurrentIndex(vulkan_device);
         enabled = !vulkan_devices.empty();
         break;
+    case Settings::RendererBackend::Null:
+        ui->device->addItem(tr("No Graphics Device"));
+        enabled = false;
+        break;
     }
     // If in per-game config and use global is selected, don't enable.
     enabled &= !(!Settings::IsConfiguringGlobal() &&
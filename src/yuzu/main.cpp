@@ -649,22 +649,19 @@ void GMainWindow::InitializeWidgets() {
     renderer_status_button->setObjectName(QStringLiteral("RendererStatusBarButton"));
     renderer_status_button->setCheckable(true);
     renderer_status_button->setFocusPolicy(Qt::NoFocus);
-    connect(renderer_status_button, &QPushButton::toggled, [this](bool checked) {
-        renderer_status_button->setText(checked ? tr("VULKAN") : tr("OPENGL"));
-    });
-    renderer_status_button->toggle();
-
-    renderer_status_button->setChecked(Settings::values.renderer_backend.GetValue() ==
-                                       Settings::RendererBackend::Vulkan);
+    UpdateRendererStatusButton();
     connect(renderer_status_button, &QPushButton::clicked, [this] {
         if (emulation_running) {
+            UpdateRendererStatusButton();
             return;
         }
+        // The button only toggles between OpenGL and Vulkan, Null is set in the configuration
         if (renderer_status_button->isChecked()) {
             Settings::values.renderer_backend.SetValue(Settings::RendererBackend::Vulkan);
         } else {
             Settings::values.renderer_backend.SetValue(Settings::RendererBackend::OpenGL);
         }
+        UpdateRendererStatusButton();
 
         Settings::Apply(Core::System::GetInstance());
     });
@@ -2571,8 +2568,24 @@ void GMainWindow::UpdateStatusButtons() {
     dock_status_button->setChecked(Settings::values.use_docked_mode.GetValue());
     multicore_status_button->setChecked(Settings::values.use_multi_core.GetValue());
     async_status_button->setChecked(Settings::values.use_asynchronous_gpu_emulation.GetValue());
-    renderer_status_button->setChecked(Settings::values.renderer_backend.GetValue() ==
-                                       Settings::RendererBackend::Vulkan);
+    UpdateRendererStatusButton();
+}
+
+void GMainWindow::UpdateRendererStatusButton() {
+    const Settings::RendererBackend backend = Settings::values.renderer_backend.GetValue();
+    switch (backend) {
+    case Settings::RendererBackend::OpenGL:
+        renderer_status_button->setText(tr("OPENGL"));
+        break;
+    case Settings::RendererBackend::Vulkan:
+        renderer_status_button->setText(tr("VULKAN"));
+        break;
+    case Settings::RendererBackend::Null:
+        renderer_status_button->setText(tr("NULL"));
+        break;
+    }
+    // The checked state only selects the color of the button in the themes
+    renderer_status_button->setChecked(backend == Settings::RendererBackend::Vulkan);
 }
 
 void GMainWindow::UpdateUISettings() {
@@ -264,6 +264,7 @@ private:
                            const std::string& title_version = {});
     void UpdateStatusBar();
     void UpdateStatusButtons();
+    void UpdateRendererStatusButton();
     void UpdateUISettings();
     void HideMouseCursor();
     void ShowMouseCursor();
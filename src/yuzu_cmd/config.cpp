@@ -388,6 +388,16 @@ void Config::ReadValues() {
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "frame_limit", 100)));
     Settings::values.use_disk_shader_cache.SetValue(
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", false));
+    Settings::values.use_disk_texture_cache.SetValue(
+        sdl2_config->GetBoolean("Renderer", "use_disk_texture_cache", false));
+    Settings::values.use_texture_content_hash.SetValue(
+        sdl2_config->GetBoolean("Renderer", "use_texture_content_hash", false));
+    Settings::values.texture_cache_budget.SetValue(
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "texture_cache_budget", 0)));
+    Settings::values.use_asynchronous_texture_decode.SetValue(
+        sdl2_config->GetBoolean("Renderer", "use_asynchronous_texture_decode", false));
+    Settings::values.use_texture_placeholders.SetValue(
+        sdl2_config->GetBoolean("Renderer", "use_texture_placeholders", false));
     const int gpu_accuracy_level = sdl2_config->GetInteger("Renderer", "gpu_accuracy", 0);
     Settings::values.gpu_accuracy.SetValue(static_cast<Settings::GPUAccuracy>(gpu_accuracy_level));
     Settings::values.use_asynchronous_gpu_emulation.SetValue(
@@ -433,6 +443,10 @@ void Config::ReadValues() {
     Settings::values.quest_flag = sdl2_config->GetBoolean("Debugging", "quest_flag", false);
     Settings::values.disable_macro_jit =
         sdl2_config->GetBoolean("Debugging", "disable_macro_jit", false);
+    Settings::values.profile_macros =
+        sdl2_config->GetBoolean("Debugging", "profile_macros", false);
+    Settings::values.record_gpu_commands =
+        sdl2_config->GetBoolean("Debugging", "record_gpu_commands", false);
 
     const auto title_list = sdl2_config->Get("AddOns", "title_ids", "");
     std::stringstream ss(title_list);
@@ -140,7 +140,7 @@ cpuopt_reduce_misalign_checks =
 
 [Renderer]
 # Which backend API to use.
-# 0 (default): OpenGL, 1: Vulkan
+# 0 (default): OpenGL, 1: Vulkan, 2: Null (no rendering, for benchmarking)
 backend =
 
 # Enable graphics API debugging mode.
@@ -190,6 +190,26 @@ frame_limit =
 # 0 (default): Off, 1 : On
 use_disk_shader_cache =
 
+# Whether to store software decoded textures (e.g. ASTC) on disk to skip decoding them again
+# 0 (default): Off, 1 : On
+use_disk_texture_cache =
+
+# Whether to hash the guest data of textures written by the CPU to skip uploading unchanged data
+# 0 (default): Off, 1 : On
+use_texture_content_hash =
+
+# Memory budget of the texture cache in MiB, least recently used textures are evicted above it
+# 0 (default): Unlimited
+texture_cache_budget =
+
+# Whether to unswizzle and convert large textures on worker threads instead of the GPU thread
+# 0 (default): Off, 1 : On
+use_asynchronous_texture_decode =
+
+# Whether to draw with a blank texture while a texture is decoded asynchronously instead of waiting
+# 0 (default): Off, 1 : On
+use_texture_placeholders =
+
 # Which gpu accuracy level to use
 # 0 (Normal), 1 (High), 2 (Extreme)
 gpu_accuracy =
@@ -327,6 +347,10 @@ dump_nso=false
 quest_flag =
 # Enables/Disables the macro JIT compiler
 disable_macro_jit=false
+# Logs the macros the emulation spent the most time on when it stops
+profile_macros=false
+# Records the GPU command lists to the dump directory, they can be replayed with --replay-gpu
+record_gpu_commands=false
 
 [WebService]
 # Whether or not to enable telemetry
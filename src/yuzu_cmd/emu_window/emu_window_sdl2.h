@@ -78,3 +78,6 @@ protected:
     /// Input subsystem to use with this window.
     InputCommon::InputSubsystem* input_subsystem;
 };
+
+/// Graphics context for renderers that don't need the window to share a context with them
+class DummyContext : public Core::Frontend::GraphicsContext {};
@@ -5,6 +5,7 @@
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 
@@ -31,10 +32,13 @@
 #include "core/settings.h"
 #include "core/telemetry_session.h"
 #include "input_common/main.h"
+#include "video_core/command_capture.h"
+#include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
 #include "yuzu_cmd/config.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2_gl.h"
+#include "yuzu_cmd/emu_window/emu_window_sdl2_null.h"
 #include "yuzu_cmd/emu_window/emu_window_sdl2_vk.h"
 
 #ifdef _WIN32
@@ -65,7 +69,8 @@ static void PrintHelp(const char* argv0) {
                  "-f, --fullscreen      Start in fullscreen mode\n"
                  "-h, --help            Display this help and exit\n"
                  "-v, --version         Output version information and exit\n"
-                 "-p, --program         Pass following string as arguments to executable\n";
+                 "-p, --program         Pass following string as arguments to executable\n"
+                 "-r, --replay-gpu      Replay a GPU command capture instead of running a title\n";
 }
 
 static void PrintVersion() {
@@ -107,17 +112,19 @@ int main(int argc, char** argv) {
     std::string filepath;
 
     bool fullscreen = false;
+    std::string replay_path;
 
     static struct option long_options[] = {
         {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {"program", optional_argument, 0, 'p'},
+        {"replay-gpu", required_argument, 0, 'r'},
         {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:fhvp::", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:fhvp::r:", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'f':
@@ -134,6 +141,9 @@ int main(int argc, char** argv) {
                 Settings::values.program_args = argv[optind];
                 ++optind;
                 break;
+            case 'r':
+                replay_path = optarg;
+                break;
             }
         } else {
 #ifdef _WIN32
@@ -152,7 +162,7 @@ int main(int argc, char** argv) {
     MicroProfileOnThreadCreate("EmuThread");
     SCOPE_EXIT({ MicroProfileShutdown(); });
 
-    if (filepath.empty()) {
+    if (filepath.empty() && replay_path.empty()) {
         LOG_CRITICAL(Frontend, "Failed to load ROM: No ROM specified");
         return -1;
     }
@@ -171,13 +181,19 @@ int main(int argc, char** argv) {
     case Settings::RendererBackend::Vulkan:
         emu_window = std::make_unique<EmuWindow_SDL2_VK>(&input_subsystem);
         break;
+    case Settings::RendererBackend::Null:
+        emu_window = std::make_unique<EmuWindow_SDL2_Null>(&input_subsystem);
+        break;
     }
 
     system.SetContentProvider(std::make_unique<FileSys::ContentProviderUnion>());
     system.SetFilesystem(std::make_shared<FileSys::RealVfsFilesystem>());
     system.GetFileSystemController().CreateFactories(*system.GetFilesystem());
 
-    const Core::System::ResultStatus load_result{system.Load(*emu_window, filepath)};
+    // Captures are replayed in an empty process, they don't need the title that recorded them
+    const Core::System::ResultStatus load_result{replay_path.empty()
+                                                     ? system.Load(*emu_window, filepath)
+                                                     : system.LoadEmptyProcess(*emu_window)};
 
     switch (load_result) {
     case Core::System::ResultStatus::ErrorGetLoader:
@@ -192,6 +208,9 @@ int main(int argc, char** argv) {
     case Core::System::ResultStatus::ErrorVideoCore:
         LOG_CRITICAL(Frontend, "Failed to initialize VideoCore!");
         return -1;
+    case Core::System::ResultStatus::ErrorUnknown:
+        LOG_CRITICAL(Frontend, "Failed to initialize the system!");
+        return -1;
     case Core::System::ResultStatus::Success:
         break; // Expected case
     default:
@@ -212,6 +231,22 @@ int main(int argc, char** argv) {
     // Core is loaded, start the GPU (makes the GPU contexts current to this thread)
     system.GPU().Start();
 
+    if (!replay_path.empty()) {
+        Tegra::CommandReplayer replayer(system);
+        const std::optional<Tegra::ReplayStats> stats = replayer.Replay(replay_path);
+        if (stats) {
+            LOG_INFO(Frontend,
+                     "Replayed {} command lists with {} words, {} mappings and {} KiB of memory "
+                     "in {} ms",
+                     stats->num_submissions, stats->num_words, stats->num_mappings,
+                     stats->memory_bytes / 1024,
+                     std::chrono::duration_cast<std::chrono::milliseconds>(stats->time).count());
+        }
+        system.Shutdown();
+        detached_tasks.WaitForAllTasks();
+        return stats ? 0 : -1;
+    }
+
     system.Renderer().Rasterizer().LoadDiskResources(
         system.CurrentProcess()->GetTitleID(), false,
         [](VideoCore::LoadCallbackStage, size_t value, size_t total) {});